@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+
+"""
+Decompress a compressed ULog file (ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK set, see
+src/modules/logger/messages.h) into a regular ULog file.
+
+Uses the lz4 module if installed (pip install lz4), otherwise a (slower) pure python LZ4 block decoder.
+"""
+
+import argparse
+import struct
+import sys
+
+try:
+    import lz4.block
+    HAVE_LZ4 = True
+except ImportError:
+    HAVE_LZ4 = False
+
+ULOG_HEADER_LEN = 16
+ULOG_MSG_HEADER_LEN = 3
+ULOG_MSG_TYPE_FLAG_BITS = ord('B')
+ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK = 1 << 0
+ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK = 1 << 1
+FRAME_MAGIC = b'ULz4'
+FRAME_HEADER_LEN = 12
+
+
+def lz4_block_decompress(src, uncompressed_size):
+    """ decode an LZ4 block """
+    if HAVE_LZ4:
+        return lz4.block.decompress(src, uncompressed_size=uncompressed_size)
+
+    dst = bytearray()
+    i = 0
+    n = len(src)
+
+    while i < n:
+        token = src[i]
+        i += 1
+
+        # literals
+        length = token >> 4
+        if length == 15:
+            while True:
+                b = src[i]
+                i += 1
+                length += b
+                if b != 255:
+                    break
+        dst += src[i:i + length]
+        i += length
+
+        if i >= n:
+            break # last sequence
+
+        # match
+        offset = src[i] | (src[i + 1] << 8)
+        i += 2
+        length = token & 0xf
+        if length == 15:
+            while True:
+                b = src[i]
+                i += 1
+                length += b
+                if b != 255:
+                    break
+        length += 4
+
+        start = len(dst) - offset
+        if offset >= length:
+            dst += dst[start:start + length]
+        else:
+            # overlapping match
+            for k in range(length):
+                dst.append(dst[start + k])
+
+    if len(dst) != uncompressed_size:
+        raise ValueError('decompressed size mismatch')
+    return bytes(dst)
+
+
+def decompress(data):
+    """ decompress a compressed ULog file, returns the uncompressed ULog file """
+    if len(data) < ULOG_HEADER_LEN + ULOG_MSG_HEADER_LEN or not data.startswith(b'ULog'):
+        raise ValueError('not a ULog file')
+
+    pos = ULOG_HEADER_LEN
+    msg_size, msg_type = struct.unpack_from('<HB', data, pos)
+    if msg_type != ULOG_MSG_TYPE_FLAG_BITS:
+        raise ValueError('no Flags message')
+
+    flags_end = pos + ULOG_MSG_HEADER_LEN + msg_size
+    flags = bytearray(data[pos:flags_end])
+    incompat_flags = ULOG_MSG_HEADER_LEN + 8
+    appended_offsets = incompat_flags + 8
+
+    if not flags[incompat_flags] & ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK:
+        raise ValueError('file is not compressed')
+
+    flags[incompat_flags] &= ~ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK & 0xff
+
+    frames = []
+    uncompressed_len = flags_end
+    pos = flags_end
+
+    while pos + FRAME_HEADER_LEN <= len(data) and data[pos:pos + 4] == FRAME_MAGIC:
+        compressed_size, uncompressed_size = struct.unpack_from('<II', data, pos + 4)
+        payload = data[pos + FRAME_HEADER_LEN:pos + FRAME_HEADER_LEN + compressed_size]
+
+        if len(payload) != compressed_size:
+            print('Warning: truncated frame at offset {:}'.format(pos), file=sys.stderr)
+            break
+
+        if compressed_size == uncompressed_size:
+            frames.append(payload)
+        else:
+            frames.append(lz4_block_decompress(payload, uncompressed_size))
+
+        uncompressed_len += uncompressed_size
+        pos += FRAME_HEADER_LEN + compressed_size
+
+    # appended data (e.g. hardfault logs) is not compressed: fix up the offsets
+    if flags[incompat_flags] & ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK:
+        for i in range(3):
+            offset_pos = appended_offsets + i * 8
+            if offset_pos + 8 > len(flags):
+                break
+            offset, = struct.unpack_from('<Q', flags, offset_pos)
+            if offset >= pos:
+                struct.pack_into('<Q', flags, offset_pos, offset - pos + uncompressed_len)
+
+    elif pos < len(data):
+        print('Warning: {:} bytes of trailing data at offset {:}'.format(len(data) - pos, pos), file=sys.stderr)
+
+    return data[:ULOG_HEADER_LEN] + bytes(flags) + b''.join(frames) + data[pos:]
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser(description="""Decompress a compressed ULog file""")
+    parser.add_argument("ulog_file", help="compressed .ulg file")
+    parser.add_argument("output_file", help="output .ulg file", nargs='?', default=None)
+
+    args = parser.parse_args()
+
+    output_file = args.output_file
+    if output_file is None:
+        output_file = args.ulog_file[:-4] + '_decompressed.ulg' if args.ulog_file.endswith('.ulg') \
+            else args.ulog_file + '.decompressed.ulg'
+
+    with open(args.ulog_file, 'rb') as f:
+        data = f.read()
+
+    try:
+        output = decompress(data)
+    except ValueError as e:
+        print('Error: {:}'.format(e))
+        sys.exit(1)
+
+    with open(output_file, 'wb') as f:
+        f.write(output)
+
+    print('Wrote {:} ({:} -> {:} bytes)'.format(output_file, len(data), len(output)))
@@ -80,6 +80,8 @@ protected:
 
 	virtual void print_run_status() override;
 
+	virtual uint32_t run_interval() const override { return _call.period; }
+
 private:
 
 	virtual void Run() override = 0;
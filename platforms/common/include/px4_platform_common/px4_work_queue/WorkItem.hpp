@@ -72,6 +72,12 @@ public:
 
 	virtual void print_run_status();
 
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+	void print_run_stats();
+
+	void run_stats(wq_run_stats_t &stats) const;
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
+
 	/**
 	 * Switch to a different WorkQueue.
 	 * NOTE: Caller is responsible for synchronization.
@@ -108,9 +114,18 @@ protected:
 		}
 	}
 
-	friend void WorkQueue::Run();
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+	void RunPostamble(hrt_abstime time_scheduled, hrt_abstime time_started);
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
+
+	friend class WorkQueue;
 	virtual void Run() = 0;
 
+	/**
+	 * The interval the item is expected to run at (us), 0 if it isn't periodic.
+	 */
+	virtual uint32_t run_interval() const { return 0; }
+
 	/**
 	 * Initialize WorkItem given a WorkQueue config. This call
 	 * can also be used to switch to a different WorkQueue.
@@ -134,6 +149,18 @@ private:
 
 	WorkQueue	*_wq{nullptr};
 
+#if defined(WQ_LOCKFREE_SUPPORTED)
+	WorkItem		*_next_pending{nullptr}; // WorkQueue pending stack
+	px4::atomic_bool	_scheduled{false}; // pending or queued, cleared once taken to run
+#endif // WQ_LOCKFREE_SUPPORTED
+
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+	hrt_abstime	_time_scheduled{0}; // protected by the work queue lock
+	uint32_t	_deadline_misses{0};
+	uint32_t	_latency_hist[WQ_RUN_STATS_BUCKETS] {};
+	uint32_t	_run_time_hist[WQ_RUN_STATS_BUCKETS] {};
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
+
 };
 
 } // namespace px4
@@ -43,6 +43,21 @@
 #include <px4_platform_common/sem.h>
 #include <px4_platform_common/tasks.h>
 
+#if !defined(__PX4_NUTTX)
+// multiple worker threads per work queue (see wq_config_t::threads)
+# define WQ_POOL_SUPPORTED
+#endif
+
+#if defined(CONFIG_WORK_QUEUE_LOCKFREE) && defined(__PX4_LINUX) && !defined(ENABLE_LOCKSTEP_SCHEDULER)
+// lock-free scheduling (multiple producers, consumers under work_lock()) with a futex based wakeup
+# define WQ_LOCKFREE_SUPPORTED
+#endif
+
+#if defined(__PX4_LINUX)
+// worker threads can be restricted to a set of CPUs
+# define WQ_CPU_AFFINITY_SUPPORTED
+#endif
+
 namespace px4
 {
 
@@ -71,7 +86,23 @@ public:
 
 	void request_stop() { _should_exit.store(true); }
 
-	void print_status(bool last = false);
+#if defined(WQ_CPU_AFFINITY_SUPPORTED)
+	/**
+	 * Restrict the worker thread(s) to a set of CPUs. Each worker thread applies it when it wakes up next.
+	 * @param cpu_mask bitmask of allowed CPUs, 0 for all
+	 */
+	void set_cpu_affinity(uint32_t cpu_mask) { _cpu_affinity.store(cpu_mask); }
+#endif // WQ_CPU_AFFINITY_SUPPORTED
+
+	void print_status(bool last = false, bool print_run_stats = false);
+
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+	/**
+	 * Get the run time statistics of the work item at index, or
+	 * decrement index by the number of work items in this queue.
+	 */
+	bool run_stats(unsigned &index, wq_run_stats_t &stats);
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
 
 	// WorkQueues sorted numerically by relative priority (-1 to -255)
 	bool operator<=(const WorkQueue &rhs) const { return _config.relative_priority >= rhs.get_config().relative_priority; }
@@ -82,6 +113,41 @@ private:
 
 	inline void SignalWorkerThread();
 
+	/**
+	 * Item removed from the run queue without running.
+	 * work_lock() must be held.
+	 */
+	void Unscheduled(WorkItem *item);
+
+#if defined(WQ_POOL_SUPPORTED)
+	/**
+	 * Remove the first queued item that is not currently running on another worker thread.
+	 * work_lock() must be held.
+	 */
+	WorkItem *PopRunnable();
+
+	bool IsRunning(const WorkItem *item) const;
+	bool IsAnyRunning() const;
+#endif // WQ_POOL_SUPPORTED
+
+#if defined(WQ_LOCKFREE_SUPPORTED)
+	/**
+	 * Move all items scheduled since the last call to the run queue (in order).
+	 * work_lock() must be held.
+	 */
+	void TakePending();
+
+	void WaitForSignal();
+#endif // WQ_LOCKFREE_SUPPORTED
+
+#if defined(WQ_CPU_AFFINITY_SUPPORTED)
+	/**
+	 * Apply the requested CPU affinity to the calling worker thread if it changed.
+	 * @param applied the affinity of the calling thread, updated
+	 */
+	void ApplyCpuAffinity(uint32_t &applied);
+#endif // WQ_CPU_AFFINITY_SUPPORTED
+
 #ifdef __PX4_NUTTX
 	// In NuttX work can be enqueued from an ISR
 	void work_lock() { _flags = enter_critical_section(); }
@@ -95,12 +161,32 @@ private:
 #endif
 
 	IntrusiveQueue<WorkItem *>	_q;
+
+#if defined(WQ_LOCKFREE_SUPPORTED)
+	px4::atomic<WorkItem *>		_pending{nullptr}; // items scheduled by Add(), most recent first
+	int				_signal{0}; // futex word, 1 if signalled
+	int				_waiters{0}; // worker threads waiting on _signal
+#else
 	px4_sem_t			_process_lock;
+#endif // WQ_LOCKFREE_SUPPORTED
+
 	px4_sem_t			_exit_lock;
 	const wq_config_t		&_config;
 	BlockingList<WorkItem *>	_work_items;
 	px4::atomic_bool		_should_exit{false};
 
+#if defined(WQ_CPU_AFFINITY_SUPPORTED)
+	px4::atomic<uint32_t>		_cpu_affinity{0}; // requested CPU mask, 0 for all CPUs
+#endif // WQ_CPU_AFFINITY_SUPPORTED
+
+	// items currently running, one entry per worker thread (protected by work_lock())
+#if defined(WQ_POOL_SUPPORTED)
+	WorkItem			*_running[WQ_POOL_THREADS_MAX] {};
+#else
+	WorkItem			*_running[1] {};
+#endif // WQ_POOL_SUPPORTED
+	uint8_t				_running_detached{0}; // bitmask of _running entries detached (or deleted) while running
+
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 	int _lockstep_component {-1};
 #endif // ENABLE_LOCKSTEP_SCHEDULER
@@ -35,15 +35,39 @@
 
 #include <stdint.h>
 
+#include <px4_platform_common/px4_config.h>
+
+#if defined(CONFIG_WORK_QUEUE_POOL_THREADS)
+# define WQ_POOL_THREADS CONFIG_WORK_QUEUE_POOL_THREADS
+#else
+# define WQ_POOL_THREADS 1
+#endif
+
 namespace px4
 {
 
 class WorkQueue; // forward declaration
 
+static constexpr uint8_t WQ_POOL_THREADS_MAX{8};
+
 struct wq_config_t {
 	const char *name;
 	uint16_t stacksize;
 	int8_t relative_priority; // relative to max
+	uint8_t threads{1}; // number of worker threads (POSIX only), work items of the queue may run in parallel if > 1
+};
+
+static constexpr uint8_t WQ_RUN_STATS_BUCKETS{16};
+
+// work item run time statistics (CONFIG_WORK_QUEUE_RUN_STATS), accumulated since the item was created
+// histogram bucket i counts durations of [2^i, 2^(i+1)) us, the last bucket also everything longer
+struct wq_run_stats_t {
+	const char *item_name;
+	const char *wq_name;
+	uint32_t interval; // scheduled interval (us), 0 if not running on an interval
+	uint32_t deadline_misses; // runs finishing later than one interval after being scheduled
+	uint32_t latency[WQ_RUN_STATS_BUCKETS]; // scheduled to started
+	uint32_t run_time[WQ_RUN_STATS_BUCKETS];
 };
 
 namespace wq_configurations
@@ -65,14 +89,25 @@ static constexpr wq_config_t I2C3{"wq:I2C3", 2336, -11};
 static constexpr wq_config_t I2C4{"wq:I2C4", 2336, -12};
 
 // PX4 att/pos controllers, highest priority after sensors.
-static constexpr wq_config_t nav_and_controllers{"wq:nav_and_controllers", 2240, -13};
+static constexpr wq_config_t nav_and_controllers{"wq:nav_and_controllers", 2240, -13, WQ_POOL_THREADS};
 
 static constexpr wq_config_t INS0{"wq:INS0", 6000, -14};
 static constexpr wq_config_t INS1{"wq:INS1", 6000, -15};
 static constexpr wq_config_t INS2{"wq:INS2", 6000, -16};
 static constexpr wq_config_t INS3{"wq:INS3", 6000, -17};
 
-static constexpr wq_config_t hp_default{"wq:hp_default", 1900, -18};
+// dedicated work queues of the estimator instances (EKF2_MULTI_WQ)
+static constexpr wq_config_t EKF_0{"wq:EKF_0", 6000, -14};
+static constexpr wq_config_t EKF_1{"wq:EKF_1", 6000, -14};
+static constexpr wq_config_t EKF_2{"wq:EKF_2", 6000, -14};
+static constexpr wq_config_t EKF_3{"wq:EKF_3", 6000, -14};
+static constexpr wq_config_t EKF_4{"wq:EKF_4", 6000, -14};
+static constexpr wq_config_t EKF_5{"wq:EKF_5", 6000, -14};
+static constexpr wq_config_t EKF_6{"wq:EKF_6", 6000, -14};
+static constexpr wq_config_t EKF_7{"wq:EKF_7", 6000, -14};
+static constexpr wq_config_t EKF_8{"wq:EKF_8", 6000, -14};
+
+static constexpr wq_config_t hp_default{"wq:hp_default", 1900, -18, WQ_POOL_THREADS};
 
 static constexpr wq_config_t uavcan{"wq:uavcan", 3624, -19};
 
@@ -89,10 +124,11 @@ static constexpr wq_config_t ttyS9{"wq:ttyS9", 1632, -30};
 static constexpr wq_config_t ttyACM0{"wq:ttyACM0", 1632, -31};
 static constexpr wq_config_t ttyUnknown{"wq:ttyUnknown", 1632, -32};
 
-static constexpr wq_config_t lp_default{"wq:lp_default", 1920, -50};
+static constexpr wq_config_t lp_default{"wq:lp_default", 1920, -50, WQ_POOL_THREADS};
 
 static constexpr wq_config_t test1{"wq:test1", 2000, 0};
 static constexpr wq_config_t test2{"wq:test2", 2000, 0};
+static constexpr wq_config_t test_pool{"wq:test_pool", 2000, 0, 4};
 
 } // namespace wq_configurations
 
@@ -108,8 +144,19 @@ int WorkQueueManagerStop();
 
 /**
  * Work queue manager status.
+ *
+ * @param run_stats		Also print schedule latency and run time percentiles of every work item.
  */
-int WorkQueueManagerStatus();
+int WorkQueueManagerStatus(bool run_stats = false);
+
+/**
+ * Get the run time statistics of a work item.
+ *
+ * @param index		Index of the work item, counted over all work queues.
+ * @param stats		Output statistics.
+ * @return		false if there is no work item with this index (or statistics are disabled).
+ */
+bool WorkQueueManagerRunStats(unsigned index, wq_run_stats_t &stats);
 
 /**
  * Create (or find) a work queue with a particular configuration.
@@ -137,5 +184,18 @@ const wq_config_t &serial_port_to_wq(const char *serial);
 
 const wq_config_t &ins_instance_to_wq(uint8_t instance);
 
+/**
+ * Map an estimator instance to its dedicated work queue (EKF_0 - EKF_8).
+ */
+const wq_config_t &ekf_instance_to_wq(uint8_t instance);
+
+/**
+ * Restrict the worker thread(s) of a running work queue to a set of CPUs (Linux only).
+ * @param config	The work queue configuration (see WorkQueueManager.hpp).
+ * @param cpu_mask	Bitmask of allowed CPUs, 0 for all.
+ * @return		PX4_OK on success, PX4_ERROR if the work queue does not exist or affinity is not supported.
+ */
+int WorkQueueSetCpuAffinity(const wq_config_t &config, uint32_t cpu_mask);
+
 
 } // namespace px4
@@ -42,6 +42,43 @@
 namespace px4
 {
 
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+static unsigned run_stats_bucket(hrt_abstime elapsed)
+{
+	unsigned bucket = 0;
+
+	while ((elapsed > 1) && (bucket < WQ_RUN_STATS_BUCKETS - 1)) {
+		elapsed >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+// upper bound (us) of the histogram bucket containing the given percentile
+static uint32_t run_stats_percentile(const uint32_t histogram[WQ_RUN_STATS_BUCKETS], unsigned percentile)
+{
+	uint64_t total = 0;
+
+	for (unsigned i = 0; i < WQ_RUN_STATS_BUCKETS; i++) {
+		total += histogram[i];
+	}
+
+	const uint64_t threshold = (total * percentile + 99) / 100;
+	uint64_t count = 0;
+
+	for (unsigned i = 0; i < WQ_RUN_STATS_BUCKETS; i++) {
+		count += histogram[i];
+
+		if ((count > 0) && (count >= threshold)) {
+			return 1u << (i + 1);
+		}
+	}
+
+	return 0;
+}
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
+
 WorkItem::WorkItem(const char *name, const wq_config_t &config) :
 	_item_name(name)
 {
@@ -140,4 +177,45 @@ void WorkItem::print_run_status()
 	_run_count = 0;
 }
 
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+void WorkItem::RunPostamble(hrt_abstime time_scheduled, hrt_abstime time_started)
+{
+	const hrt_abstime now = hrt_absolute_time();
+
+	_latency_hist[run_stats_bucket(time_started - time_scheduled)]++;
+	_run_time_hist[run_stats_bucket(now - time_started)]++;
+
+	const uint32_t interval = run_interval();
+
+	if ((interval > 0) && (now - time_scheduled > interval)) {
+		_deadline_misses++;
+	}
+}
+
+void WorkItem::run_stats(wq_run_stats_t &stats) const
+{
+	stats.item_name = _item_name;
+	stats.wq_name = (_wq != nullptr) ? _wq->get_name() : "";
+	stats.interval = run_interval();
+	stats.deadline_misses = _deadline_misses;
+	memcpy(stats.latency, _latency_hist, sizeof(stats.latency));
+	memcpy(stats.run_time, _run_time_hist, sizeof(stats.run_time));
+}
+
+void WorkItem::print_run_stats()
+{
+	// copy first, the histograms are updated concurrently by the work queue thread
+	wq_run_stats_t stats;
+	run_stats(stats);
+
+	PX4_INFO_RAW("latency p50/p90/p99 %5" PRIu32 " %5" PRIu32 " %5" PRIu32 " us, run %5" PRIu32 " %5" PRIu32 " %5" PRIu32
+		     " us, %" PRIu32 " deadline misses\n",
+		     run_stats_percentile(stats.latency, 50), run_stats_percentile(stats.latency, 90),
+		     run_stats_percentile(stats.latency, 99),
+		     run_stats_percentile(stats.run_time, 50), run_stats_percentile(stats.run_time, 90),
+		     run_stats_percentile(stats.run_time, 99),
+		     stats.deadline_misses);
+}
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
+
 } // namespace px4
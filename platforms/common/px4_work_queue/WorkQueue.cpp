@@ -41,6 +41,17 @@
 #include <px4_platform_common/time.h>
 #include <drivers/drv_hrt.h>
 
+#if defined(WQ_LOCKFREE_SUPPORTED)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // WQ_LOCKFREE_SUPPORTED
+
+#if defined(WQ_CPU_AFFINITY_SUPPORTED)
+#include <inttypes.h>
+#include <sched.h>
+#endif // WQ_CPU_AFFINITY_SUPPORTED
+
 namespace px4
 {
 
@@ -58,8 +69,10 @@ WorkQueue::WorkQueue(const wq_config_t &config) :
 	px4_sem_init(&_qlock, 0, 1);
 #endif /* __PX4_NUTTX */
 
+#if !defined(WQ_LOCKFREE_SUPPORTED)
 	px4_sem_init(&_process_lock, 0, 0);
 	px4_sem_setprotocol(&_process_lock, SEM_PRIO_NONE);
+#endif // !WQ_LOCKFREE_SUPPORTED
 
 	px4_sem_init(&_exit_lock, 0, 1);
 	px4_sem_setprotocol(&_exit_lock, SEM_PRIO_NONE);
@@ -74,7 +87,9 @@ WorkQueue::~WorkQueue()
 	px4_sem_wait(&_exit_lock);
 	px4_sem_destroy(&_exit_lock);
 
+#if !defined(WQ_LOCKFREE_SUPPORTED)
 	px4_sem_destroy(&_process_lock);
+#endif // !WQ_LOCKFREE_SUPPORTED
 	work_unlock();
 
 #ifndef __PX4_NUTTX
@@ -105,6 +120,13 @@ void WorkQueue::Detach(WorkItem *item)
 
 	_work_items.remove(item);
 
+	// a running item is detaching (or deleting) itself, it must not be accessed anymore after Run()
+	for (unsigned slot = 0; slot < (sizeof(_running) / sizeof(_running[0])); slot++) {
+		if (_running[slot] == item) {
+			_running_detached |= (1u << slot);
+		}
+	}
+
 	if (_work_items.size() == 0) {
 		// shutdown, no active WorkItems
 		PX4_DEBUG("stopping: %s, last active WorkItem closing", _config.name);
@@ -128,6 +150,26 @@ void WorkQueue::Detach(WorkItem *item)
 
 void WorkQueue::Add(WorkItem *item)
 {
+#if defined(WQ_LOCKFREE_SUPPORTED)
+	bool scheduled = false;
+
+	if (!item->_scheduled.compare_exchange(&scheduled, true)) {
+		// already pending or queued
+		return;
+	}
+
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+	item->_time_scheduled = hrt_absolute_time();
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
+
+	// push onto the pending stack, the worker thread moves it to the run queue
+	WorkItem *head = _pending.load();
+
+	do {
+		item->_next_pending = head;
+	} while (!_pending.compare_exchange(&head, item));
+
+#else
 	work_lock();
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
@@ -138,25 +180,52 @@ void WorkQueue::Add(WorkItem *item)
 
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+
+	if (item->_time_scheduled == 0) {
+		item->_time_scheduled = hrt_absolute_time();
+	}
+
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
+
 	_q.push(item);
 	work_unlock();
+#endif // WQ_LOCKFREE_SUPPORTED
 
 	SignalWorkerThread();
 }
 
 void WorkQueue::SignalWorkerThread()
 {
+#if defined(WQ_LOCKFREE_SUPPORTED)
+
+	// only wake a worker thread (syscall) if one is waiting and the signal isn't already set
+	if ((__atomic_exchange_n(&_signal, 1, __ATOMIC_SEQ_CST) == 0) && (__atomic_load_n(&_waiters, __ATOMIC_SEQ_CST) > 0)) {
+		syscall(SYS_futex, &_signal, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+	}
+
+#else
 	int sem_val;
 
 	if (px4_sem_getvalue(&_process_lock, &sem_val) == 0 && sem_val <= 0) {
 		px4_sem_post(&_process_lock);
 	}
+
+#endif // WQ_LOCKFREE_SUPPORTED
 }
 
 void WorkQueue::Remove(WorkItem *item)
 {
 	work_lock();
-	_q.remove(item);
+
+#if defined(WQ_LOCKFREE_SUPPORTED)
+	TakePending();
+#endif // WQ_LOCKFREE_SUPPORTED
+
+	if (_q.remove(item)) {
+		Unscheduled(item);
+	}
+
 	work_unlock();
 }
 
@@ -164,35 +233,224 @@ void WorkQueue::Clear()
 {
 	work_lock();
 
+#if defined(WQ_LOCKFREE_SUPPORTED)
+	TakePending();
+#endif // WQ_LOCKFREE_SUPPORTED
+
 	while (!_q.empty()) {
-		_q.pop();
+		Unscheduled(_q.pop());
 	}
 
 	work_unlock();
 }
 
+void WorkQueue::Unscheduled(WorkItem *item)
+{
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+	item->_time_scheduled = 0;
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
+
+#if defined(WQ_LOCKFREE_SUPPORTED)
+	// release after clearing the timestamp, see Run()
+	item->_scheduled.store(false);
+#endif // WQ_LOCKFREE_SUPPORTED
+
+	(void)item;
+}
+
+#if defined(WQ_LOCKFREE_SUPPORTED)
+void WorkQueue::TakePending()
+{
+	WorkItem *head = _pending.load();
+
+	while ((head != nullptr) && !_pending.compare_exchange(&head, nullptr)) {}
+
+	// the pending stack is most recent first, reverse it to keep the scheduling order
+	WorkItem *item = nullptr;
+
+	while (head != nullptr) {
+		WorkItem *next = head->_next_pending;
+		head->_next_pending = item;
+		item = head;
+		head = next;
+	}
+
+	while (item != nullptr) {
+		WorkItem *next = item->_next_pending;
+		item->_next_pending = nullptr;
+		_q.push(item);
+		item = next;
+	}
+}
+
+void WorkQueue::WaitForSignal()
+{
+	while (__atomic_exchange_n(&_signal, 0, __ATOMIC_SEQ_CST) == 0) {
+		__atomic_fetch_add(&_waiters, 1, __ATOMIC_SEQ_CST);
+		// returns immediately if _signal was set in the meantime (or spuriously)
+		syscall(SYS_futex, &_signal, FUTEX_WAIT_PRIVATE, 0, nullptr, nullptr, 0);
+		__atomic_fetch_sub(&_waiters, 1, __ATOMIC_SEQ_CST);
+	}
+}
+#endif // WQ_LOCKFREE_SUPPORTED
+
+#if defined(WQ_POOL_SUPPORTED)
+WorkItem *WorkQueue::PopRunnable()
+{
+	for (WorkItem *item : _q) {
+		if (!IsRunning(item)) {
+			_q.remove(item);
+			return item;
+		}
+	}
+
+	return nullptr;
+}
+
+bool WorkQueue::IsRunning(const WorkItem *item) const
+{
+	for (const WorkItem *running : _running) {
+		if (running == item) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool WorkQueue::IsAnyRunning() const
+{
+	for (const WorkItem *running : _running) {
+		if (running != nullptr) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif // WQ_POOL_SUPPORTED
+
+#if defined(WQ_CPU_AFFINITY_SUPPORTED)
+void WorkQueue::ApplyCpuAffinity(uint32_t &applied)
+{
+	const uint32_t cpu_mask = _cpu_affinity.load();
+
+	if (cpu_mask == applied) {
+		return;
+	}
+
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if ((cpu_mask == 0) || ((cpu < 32) && (cpu_mask & (1u << cpu)))) {
+			CPU_SET(cpu, &cpus);
+		}
+	}
+
+	int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+	if (ret != 0) {
+		PX4_ERR("%s: setting CPU affinity 0x%" PRIx32 " failed (%i)", get_name(), cpu_mask, ret);
+	}
+
+	// not retried on failure
+	applied = cpu_mask;
+}
+#endif // WQ_CPU_AFFINITY_SUPPORTED
+
 void WorkQueue::Run()
 {
+#if defined(WQ_CPU_AFFINITY_SUPPORTED)
+	uint32_t cpu_affinity = 0;
+#endif // WQ_CPU_AFFINITY_SUPPORTED
+
 	while (!should_exit()) {
+#if defined(WQ_LOCKFREE_SUPPORTED)
+		WaitForSignal();
+
+		work_lock();
+		TakePending();
+#else
 		// loop as the wait may be interrupted by a signal
 		do {} while (px4_sem_wait(&_process_lock) != 0);
 
 		work_lock();
+#endif // WQ_LOCKFREE_SUPPORTED
+
+#if defined(WQ_CPU_AFFINITY_SUPPORTED)
+		ApplyCpuAffinity(cpu_affinity);
+#endif // WQ_CPU_AFFINITY_SUPPORTED
 
 		// process queued work
 		while (!_q.empty()) {
+#if defined(WQ_POOL_SUPPORTED)
+			// an item that is already running on another worker thread stays queued,
+			// that thread picks it up again once finished
+			WorkItem *work = PopRunnable();
+
+			if (work == nullptr) {
+				break;
+			}
+
+			unsigned slot = 0;
+
+			while (_running[slot] != nullptr) {
+				slot++;
+			}
+
+			_running[slot] = work;
+
+			if (_config.threads > 1 && !_q.empty()) {
+				// let another worker thread process the remaining work
+				SignalWorkerThread();
+			}
+
+#else
 			WorkItem *work = _q.pop();
 
+			const unsigned slot = 0;
+			_running[slot] = work;
+#endif // WQ_POOL_SUPPORTED
+
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+			const hrt_abstime time_scheduled = work->_time_scheduled;
+			work->_time_scheduled = 0;
+			const hrt_abstime time_started = hrt_absolute_time();
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
+
+#if defined(WQ_LOCKFREE_SUPPORTED)
+			// can be scheduled again from now on. Must come after clearing _time_scheduled: the (seq_cst, i.e. release)
+			// store publishes it to the next Add(), which sets a new timestamp
+			work->_scheduled.store(false);
+#endif // WQ_LOCKFREE_SUPPORTED
+
 			work_unlock(); // unlock work queue to run (item may requeue itself)
 			work->RunPreamble();
 			work->Run();
 			// Note: after Run() we cannot access work anymore, as it might have been deleted
 			work_lock(); // re-lock
+
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+
+			// still attached (not deleted)
+			if ((_running_detached & (1u << slot)) == 0) {
+				work->RunPostamble(time_scheduled, time_started);
+			}
+
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
+
+			_running[slot] = nullptr;
+			_running_detached &= ~(1u << slot);
+
+#if defined(WQ_LOCKFREE_SUPPORTED)
+			TakePending();
+#endif // WQ_LOCKFREE_SUPPORTED
 		}
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 
-		if (_q.empty()) {
+		if (_q.empty() && !IsAnyRunning()) {
 			px4_lockstep_unregister_component(_lockstep_component);
 			_lockstep_component = -1;
 		}
@@ -202,13 +460,23 @@ void WorkQueue::Run()
 		work_unlock();
 	}
 
+	// pass the exit request on to the next worker thread
+	SignalWorkerThread();
+
 	PX4_DEBUG("%s: exiting", _config.name);
 }
 
-void WorkQueue::print_status(bool last)
+void WorkQueue::print_status(bool last, bool print_run_stats)
 {
 	const size_t num_items = _work_items.size();
-	PX4_INFO_RAW("%-16s\n", get_name());
+
+	if (_config.threads > 1) {
+		PX4_INFO_RAW("%-16s (%u threads)\n", get_name(), _config.threads);
+
+	} else {
+		PX4_INFO_RAW("%-16s\n", get_name());
+	}
+
 	unsigned i = 0;
 
 	for (WorkItem *item : _work_items) {
@@ -229,7 +497,36 @@ void WorkQueue::print_status(bool last)
 		}
 
 		item->print_run_status();
+
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+
+		if (print_run_stats) {
+			PX4_INFO_RAW("%s%s       ", last ? "    " : "|   ", (i < num_items) ? "|" : " ");
+			item->print_run_stats();
+		}
+
+#else
+		(void)print_run_stats;
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
+	}
+}
+
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+bool WorkQueue::run_stats(unsigned &index, wq_run_stats_t &stats)
+{
+	LockGuard lg{_work_items.mutex()};
+
+	for (WorkItem *item : _work_items) {
+		if (index == 0) {
+			item->run_stats(stats);
+			return true;
+		}
+
+		index--;
 	}
+
+	return false;
 }
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
 
 } // namespace px4
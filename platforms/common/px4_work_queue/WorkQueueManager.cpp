@@ -225,17 +225,139 @@ const wq_config_t &ins_instance_to_wq(uint8_t instance)
 	return wq_configurations::INS0;
 }
 
+const wq_config_t &ekf_instance_to_wq(uint8_t instance)
+{
+	switch (instance) {
+	case 0: return wq_configurations::EKF_0;
+
+	case 1: return wq_configurations::EKF_1;
+
+	case 2: return wq_configurations::EKF_2;
+
+	case 3: return wq_configurations::EKF_3;
+
+	case 4: return wq_configurations::EKF_4;
+
+	case 5: return wq_configurations::EKF_5;
+
+	case 6: return wq_configurations::EKF_6;
+
+	case 7: return wq_configurations::EKF_7;
+
+	case 8: return wq_configurations::EKF_8;
+	}
+
+	PX4_WARN("no EKF_%d wq configuration, using EKF_0", instance);
+
+	return wq_configurations::EKF_0;
+}
+
+int WorkQueueSetCpuAffinity(const wq_config_t &config, uint32_t cpu_mask)
+{
+#if defined(WQ_CPU_AFFINITY_SUPPORTED)
+	WorkQueue *wq = FindWorkQueueByName(config.name);
+
+	if (wq != nullptr) {
+		wq->set_cpu_affinity(cpu_mask);
+		return PX4_OK;
+	}
+
+#endif // WQ_CPU_AFFINITY_SUPPORTED
+
+	return PX4_ERROR;
+}
+
+static size_t
+WorkQueueStackSize(const wq_config_t &wq)
+{
+#if defined(__PX4_NUTTX) || defined(__PX4_QURT)
+	return math::max(PTHREAD_STACK_MIN, PX4_STACK_ADJUSTED(wq.stacksize));
+#elif defined(__PX4_POSIX)
+	// On posix system , the desired stacksize round to the nearest multiplier of the system pagesize
+	// It is a requirement of the  pthread_attr_setstacksize* function
+	const unsigned int page_size = sysconf(_SC_PAGESIZE);
+	const size_t stacksize_adj = math::max((int)PTHREAD_STACK_MIN, PX4_STACK_ADJUSTED(wq.stacksize));
+	return (stacksize_adj + page_size - (stacksize_adj % page_size));
+#endif
+}
+
+#if defined(WQ_POOL_SUPPORTED)
+static void *
+WorkQueuePoolRunner(void *context)
+{
+	WorkQueue *wq = static_cast<WorkQueue *>(context);
+
+#ifdef __PX4_DARWIN
+	pthread_setname_np(wq->get_name());
+#else
+	pthread_setname_np(pthread_self(), wq->get_name());
+#endif
+
+	wq->Run();
+
+	return nullptr;
+}
+
+// start the additional worker threads of a pooled work queue (inheriting the scheduling of the calling thread)
+static int
+WorkQueuePoolStart(WorkQueue &wq, pthread_t threads[])
+{
+	const wq_config_t &config = wq.get_config();
+	const int num_threads = math::min((int)config.threads, (int)WQ_POOL_THREADS_MAX) - 1;
+
+	if (num_threads <= 0) {
+		return 0;
+	}
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, WorkQueueStackSize(config));
+
+	int started = 0;
+
+	for (int i = 0; i < num_threads; i++) {
+		int ret_create = pthread_create(&threads[started], &attr, WorkQueuePoolRunner, (void *)&wq);
+
+		if (ret_create == 0) {
+			started++;
+
+		} else {
+			PX4_ERR("failed to create pool thread for %s (%i): %s", config.name, ret_create, strerror(ret_create));
+		}
+	}
+
+	pthread_attr_destroy(&attr);
+
+	PX4_DEBUG("%s: %d pool threads", config.name, started + 1);
+
+	return started;
+}
+#endif // WQ_POOL_SUPPORTED
+
 static void *
 WorkQueueRunner(void *context)
 {
 	wq_config_t *config = static_cast<wq_config_t *>(context);
 	WorkQueue wq(*config);
 
+#if defined(WQ_POOL_SUPPORTED)
+	pthread_t pool_threads[WQ_POOL_THREADS_MAX] {};
+	const int num_pool_threads = WorkQueuePoolStart(wq, pool_threads);
+#endif // WQ_POOL_SUPPORTED
+
 	// add to work queue list
 	_wq_manager_wqs_list->add(&wq);
 
 	wq.Run();
 
+#if defined(WQ_POOL_SUPPORTED)
+
+	for (int i = 0; i < num_pool_threads; i++) {
+		pthread_join(pool_threads[i], nullptr);
+	}
+
+#endif // WQ_POOL_SUPPORTED
+
 	// remove from work queue list
 	_wq_manager_wqs_list->remove(&wq);
 
@@ -267,15 +389,7 @@ WorkQueueManagerRun(int, char **)
 			// create new work queue
 
 			// stack size
-#if defined(__PX4_NUTTX) || defined(__PX4_QURT)
-			const size_t stacksize = math::max(PTHREAD_STACK_MIN, PX4_STACK_ADJUSTED(wq->stacksize));
-#elif defined(__PX4_POSIX)
-			// On posix system , the desired stacksize round to the nearest multiplier of the system pagesize
-			// It is a requirement of the  pthread_attr_setstacksize* function
-			const unsigned int page_size = sysconf(_SC_PAGESIZE);
-			const size_t stacksize_adj = math::max((int)PTHREAD_STACK_MIN, PX4_STACK_ADJUSTED(wq->stacksize));
-			const size_t stacksize = (stacksize_adj + page_size - (stacksize_adj % page_size));
-#endif
+			const size_t stacksize = WorkQueueStackSize(*wq);
 
 			// priority
 			int sched_priority = sched_get_priority_max(SCHED_FIFO) + wq->relative_priority;
@@ -444,7 +558,7 @@ WorkQueueManagerStop()
 }
 
 int
-WorkQueueManagerStatus()
+WorkQueueManagerStatus(bool run_stats)
 {
 	if (!_wq_manager_should_exit.load() && (_wq_manager_wqs_list != nullptr)) {
 
@@ -466,7 +580,7 @@ WorkQueueManagerStatus()
 				PX4_INFO_RAW("\\__ %zu) ", i);
 			}
 
-			wq->print_status(last_wq);
+			wq->print_status(last_wq, run_stats);
 		}
 
 	} else {
@@ -476,4 +590,25 @@ WorkQueueManagerStatus()
 	return PX4_OK;
 }
 
+bool
+WorkQueueManagerRunStats(unsigned index, wq_run_stats_t &stats)
+{
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+
+	if (!_wq_manager_should_exit.load() && (_wq_manager_wqs_list != nullptr)) {
+
+		LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+		for (WorkQueue *wq : *_wq_manager_wqs_list) {
+			if (wq->run_stats(index, stats)) {
+				return true;
+			}
+		}
+	}
+
+#endif // CONFIG_WORK_QUEUE_RUN_STATS
+
+	return false;
+}
+
 } // namespace px4
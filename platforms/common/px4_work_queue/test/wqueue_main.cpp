@@ -33,6 +33,8 @@
 
 #include "wqueue_test.h"
 #include "wqueue_scheduled_test.h"
+#include "wqueue_pool_test.h"
+#include "wqueue_schedule_benchmark.h"
 
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/app.h>
@@ -51,6 +53,12 @@ int PX4_MAIN(int argc, char **argv)
 	WQueueScheduledTest wq2;
 	wq2.main();
 
+	PX4_INFO("wqueue test 3 (pool)");
+	WQueuePoolTest::main();
+
+	PX4_INFO("wqueue test 4 (schedule benchmark)");
+	WQueueScheduleBenchmark::main();
+
 	PX4_INFO("wqueue test complete, exiting");
 
 	return 0;
@@ -0,0 +1,125 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "wqueue_pool_test.h"
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+
+using namespace px4;
+
+AppState WQueuePoolTest::appState;
+px4::atomic<int> WQueuePoolTest::_items_active{0};
+px4::atomic<int> WQueuePoolTest::_items_active_max{0};
+px4::atomic<int> WQueuePoolTest::_self_overlaps{0};
+
+void WQueuePoolTest::Run()
+{
+	if (_active.fetch_add(1) != 0) {
+		// the same item must never run on two worker threads at once
+		_self_overlaps.fetch_add(1);
+	}
+
+	const int items_active = _items_active.fetch_add(1) + 1;
+
+	if (items_active > _items_active_max.load()) {
+		_items_active_max.store(items_active);
+	}
+
+	// some work
+	const hrt_abstime start = hrt_absolute_time();
+
+	while (hrt_elapsed_time(&start) < 100) {}
+
+	_items_active.fetch_sub(1);
+	_active.fetch_sub(1);
+
+	if (_iter.fetch_add(1) + 1 < 1000) {
+		ScheduleNow();
+	}
+}
+
+int WQueuePoolTest::main()
+{
+	appState.setRunning(true);
+
+	WQueuePoolTest *items[NUM_ITEMS] {};
+
+	for (auto &item : items) {
+		item = new WQueuePoolTest();
+	}
+
+	// put work in the work queue, scheduling items again while they might be running
+	for (int i = 0; i < 1000; i++) {
+		for (auto &item : items) {
+			item->ScheduleNow();
+		}
+
+		px4_usleep(100);
+	}
+
+	// wait for work to finish
+	bool done = false;
+
+	while (!done) {
+		px4_usleep(10000);
+		done = true;
+
+		for (auto &item : items) {
+			if (item->_iter.load() < 1000) {
+				done = false;
+			}
+		}
+	}
+
+	for (auto &item : items) {
+		item->ScheduleClear();
+	}
+
+	px4_usleep(10000);
+
+	for (auto &item : items) {
+		delete item;
+	}
+
+	PX4_INFO("WQueuePoolTest finished, max items running in parallel: %d", _items_active_max.load());
+
+	if (_self_overlaps.load() != 0) {
+		PX4_ERR("WQueuePoolTest FAILED: %d concurrent runs of the same item", _self_overlaps.load());
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,145 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "wqueue_schedule_benchmark.h"
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+
+#include <pthread.h>
+
+using namespace px4;
+
+AppState WQueueScheduleBenchmark::appState;
+WQueueScheduleBenchmark *WQueueScheduleBenchmark::_items[NUM_ITEMS] {};
+
+void WQueueScheduleBenchmark::Run()
+{
+	_dirty.store(false);
+	_runs.fetch_add(1);
+}
+
+void *WQueueScheduleBenchmark::producer_entry(void *arg)
+{
+	const int offset = (int)(intptr_t)arg;
+
+	for (int i = 0; i < SCHEDULES_PER_PRODUCER; i++) {
+		WQueueScheduleBenchmark *item = _items[(i + offset) % NUM_ITEMS];
+		item->_dirty.store(true);
+		item->ScheduleNow();
+	}
+
+	return nullptr;
+}
+
+int WQueueScheduleBenchmark::run_benchmark(int producers)
+{
+	for (auto &item : _items) {
+		item->_runs.store(0);
+	}
+
+	pthread_t threads[NUM_PRODUCERS_MAX] {};
+
+	const hrt_abstime start = hrt_absolute_time();
+
+	for (int i = 0; i < producers; i++) {
+		pthread_create(&threads[i], nullptr, producer_entry, (void *)(intptr_t)i);
+	}
+
+	for (int i = 0; i < producers; i++) {
+		pthread_join(threads[i], nullptr);
+	}
+
+	const hrt_abstime elapsed = hrt_elapsed_time(&start);
+
+	// wait for the work queue to catch up
+	px4_usleep(100000);
+
+	int runs = 0;
+	int lost = 0;
+
+	for (auto &item : _items) {
+		runs += item->_runs.load();
+
+		// scheduled after its last run, but never ran again
+		if (item->_dirty.load()) {
+			lost++;
+		}
+	}
+
+	const int schedules = producers * SCHEDULES_PER_PRODUCER;
+
+	PX4_INFO("%d producers: %d schedules, %.1f ns per schedule, %d runs", producers, schedules,
+		 (double)(elapsed * 1000) / schedules, runs);
+
+	if (lost != 0) {
+		PX4_ERR("WQueueScheduleBenchmark FAILED: %d items not run after being scheduled", lost);
+		return -1;
+	}
+
+	return 0;
+}
+
+int WQueueScheduleBenchmark::main()
+{
+	appState.setRunning(true);
+
+	for (auto &item : _items) {
+		item = new WQueueScheduleBenchmark();
+	}
+
+	int ret = 0;
+
+	for (int producers = 1; producers <= NUM_PRODUCERS_MAX; producers *= 2) {
+		if (run_benchmark(producers) != 0) {
+			ret = -1;
+		}
+	}
+
+	for (auto &item : _items) {
+		item->ScheduleClear();
+	}
+
+	px4_usleep(10000);
+
+	for (auto &item : _items) {
+		delete item;
+		item = nullptr;
+	}
+
+	PX4_INFO("WQueueScheduleBenchmark finished");
+
+	return ret;
+}
@@ -0,0 +1,73 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <px4_platform_common/app.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+#include <string.h>
+
+using namespace px4;
+
+/**
+ * Measures the cost of scheduling (ScheduleNow) from several threads concurrently
+ * and checks that no wakeup is lost.
+ */
+class WQueueScheduleBenchmark : public px4::WorkItem
+{
+public:
+	WQueueScheduleBenchmark() : px4::WorkItem("WQueueScheduleBenchmark", px4::wq_configurations::test1) {}
+	~WQueueScheduleBenchmark() = default;
+
+	static int main();
+
+	static px4::AppState appState; /* track requests to terminate app */
+
+private:
+
+	static constexpr int NUM_ITEMS = 4;
+	static constexpr int NUM_PRODUCERS_MAX = 4;
+	static constexpr int SCHEDULES_PER_PRODUCER = 100000;
+
+	void Run() override;
+
+	static int run_benchmark(int producers);
+	static void *producer_entry(void *arg);
+
+	px4::atomic<int> _runs{0};
+	px4::atomic_bool _dirty{false}; // set before scheduling, cleared when running
+
+	static WQueueScheduleBenchmark *_items[NUM_ITEMS];
+};
@@ -92,6 +92,34 @@ public:
 		return (orb_publish(get_topic(), _handle, &data) == PX4_OK);
 	}
 
+	/**
+	 * Loan a message to fill in place and publish it with publish_loan() without a copy.
+	 * The content of the loaned message is undefined, so all fields need to be set.
+	 * @return the message or nullptr if no loan is available, in which case publish() has to be used.
+	 */
+	T *loan()
+	{
+		if (!advertised()) {
+			advertise();
+		}
+
+		return static_cast<T *>(Manager::orb_loan(_handle));
+	}
+
+	/**
+	 * Publish a message returned by loan().
+	 * @param msg The loaned message (not accessible anymore afterwards).
+	 */
+	bool publish_loan(T *msg)
+	{
+		return (Manager::orb_publish_loan(get_topic(), _handle, msg) == PX4_OK);
+	}
+
+	/**
+	 * Give back a message returned by loan() without publishing it.
+	 */
+	void return_loan(T *msg) { Manager::orb_return_loan(_handle, msg); }
+
 	int get_instance()
 	{
 		// advertise if not already advertised
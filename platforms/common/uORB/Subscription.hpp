@@ -171,6 +171,40 @@ public:
 		return valid() ? Manager::orb_data_copy(_node, dst, _last_generation, false) : false;
 	}
 
+	/**
+	 * Borrow the next update in place instead of copying it.
+	 * The publisher might overwrite the data at any time, so after reading it borrow_valid()
+	 * must be checked, and what was read has to be discarded if it fails.
+	 * @return read-only pointer to the data, nullptr if not updated or not available (use update() then)
+	 */
+	const void *borrow()
+	{
+		if (!valid()) {
+			subscribe();
+		}
+
+		return valid() ? Manager::orb_data_borrow(_node, _last_generation, true) : nullptr;
+	}
+
+	/**
+	 * Check if the data returned by the last borrow() is still intact.
+	 */
+	bool borrow_valid() const { return valid() && Manager::orb_data_borrow_valid(_node, _last_generation); }
+
+	/**
+	 * Number of updates since the last read, which can exceed the queue size if messages got lost.
+	 */
+	unsigned updates_available() const { return valid() ? Manager::updates_available(_node, _last_generation) : 0; }
+
+	uint8_t get_queue_size() const { return valid() ? Manager::orb_get_queue_size(_node) : 0; }
+
+	/**
+	 * Increase the queue size of the topic (the queued messages are kept), so that the
+	 * subscriber can catch up with bursts of updates without losing any of them.
+	 * @return true if the queue holds at least queue_size messages now
+	 */
+	bool grow_queue(uint8_t queue_size) { return valid() && Manager::orb_grow_queue(_node, queue_size); }
+
 	/**
 	 * Change subscription instance
 	 * @param instance The new multi-Subscription instance
@@ -150,6 +150,7 @@ int uORB::DeviceMaster::advertise(const struct orb_metadata *meta, bool is_adver
 
 			// add to the node map.
 			_node_list.add(node);
+			addToIndexLocked(node);
 			_node_exists[node->get_instance()].set((uint8_t)node->id(), true);
 		}
 
@@ -449,11 +450,38 @@ uORB::DeviceNode *uORB::DeviceMaster::getDeviceNode(const char *nodepath)
 
 uORB::DeviceNode *uORB::DeviceMaster::getDeviceNodeLocked(const struct orb_metadata *meta, const uint8_t instance)
 {
-	for (uORB::DeviceNode *node : _node_list) {
-		if ((strcmp(node->get_name(), meta->o_name) == 0) && (node->get_instance() == instance)) {
+	if (meta->o_id >= ORB_TOPICS_COUNT) {
+		return nullptr;
+	}
+
+	for (uORB::DeviceNode *node = _node_index[meta->o_id]; node != nullptr; node = node->_next_instance) {
+		if (node->get_instance() == instance) {
 			return node;
+
+		} else if (node->get_instance() > instance) {
+			// chain is sorted by instance
+			break;
 		}
 	}
 
 	return nullptr;
 }
+
+void uORB::DeviceMaster::addToIndexLocked(uORB::DeviceNode *node)
+{
+	const size_t index = static_cast<size_t>(node->id());
+
+	if (index >= ORB_TOPICS_COUNT) {
+		return;
+	}
+
+	// insert sorted by instance
+	uORB::DeviceNode **link = &_node_index[index];
+
+	while (*link != nullptr && (*link)->get_instance() < node->get_instance()) {
+		link = &(*link)->_next_instance;
+	}
+
+	node->_next_instance = *link;
+	*link = node;
+}
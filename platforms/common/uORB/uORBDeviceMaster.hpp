@@ -133,13 +133,27 @@ private:
 	friend class uORB::Manager;
 
 	/**
-	 * Find a node give its name.
+	 * Find a node given its metadata and instance.
 	 * _lock must already be held when calling this.
 	 * @return node if exists, nullptr otherwise
 	 */
 	uORB::DeviceNode *getDeviceNodeLocked(const struct orb_metadata *meta, const uint8_t instance);
 
-	IntrusiveSortedList<uORB::DeviceNode *> _node_list;
+	/**
+	 * Add a node to the ORB_ID index.
+	 * _lock must already be held when calling this.
+	 */
+	void addToIndexLocked(uORB::DeviceNode *node);
+
+	IntrusiveSortedList<uORB::DeviceNode *> _node_list; ///< all nodes, sorted by path (used for printing)
+
+	/**
+	 * Lookup index: first instance of each topic, indexed by ORB_ID. Further instances are chained
+	 * (sorted by instance) via DeviceNode::_next_instance, so a lookup visits at most
+	 * ORB_MULTI_MAX_INSTANCES nodes and needs no string comparisons.
+	 */
+	uORB::DeviceNode *_node_index[ORB_TOPICS_COUNT] {};
+
 	AtomicBitset<ORB_TOPICS_COUNT> _node_exists[ORB_MULTI_MAX_INSTANCES];
 
 	px4_sem_t	_lock; /**< lock to protect access to all class members (also for derived classes) */
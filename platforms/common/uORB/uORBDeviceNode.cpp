@@ -78,13 +78,23 @@ uORB::DeviceNode::DeviceNode(const struct orb_metadata *meta, const uint8_t inst
 	CDev(strdup(path)), // success is checked in CDev::init
 	_meta(meta),
 	_instance(instance),
-	_queue_size(round_pow_of_two_8(queue_size))
+	_queue_size(round_pow_of_two_8(queue_size)),
+	_queue_depth(_queue_size)
 {
 }
 
 uORB::DeviceNode::~DeviceNode()
 {
 	free(_data);
+	free(_spare_allocation);
+	delete[] _slots;
+
+	while (_retired_data) {
+		RetiredData *next = _retired_data->next;
+		free(_retired_data->data);
+		delete _retired_data;
+		_retired_data = next;
+	}
 
 	const char *devname = get_devname();
 
@@ -182,16 +192,7 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 		if (!up_interrupt_context()) {
 #endif /* __PX4_NUTTX */
 
-			lock();
-
-			/* re-check size */
-			if (nullptr == _data) {
-				const size_t data_size = _meta->o_size * _queue_size;
-				_data = (uint8_t *) px4_cache_aligned_alloc(data_size);
-				memset(_data, 0, data_size);
-			}
-
-			unlock();
+			allocate_data();
 
 #ifdef __PX4_NUTTX
 		}
@@ -211,10 +212,16 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 
 	/* Perform an atomic copy. */
 	ATOMIC_ENTER;
+	write_begin();
 	/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
 	unsigned generation = _generation.fetch_add(1);
 
-	memcpy(_data + (_meta->o_size * (generation % _queue_size)), buffer, _meta->o_size);
+	memcpy(slot(generation), buffer, _meta->o_size);
+	write_end();
+
+	if (_queue_depth != _queue_size) {
+		++_queue_depth;
+	}
 
 	// callbacks
 	for (auto item : _callbacks) {
@@ -232,6 +239,168 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 	return _meta->o_size;
 }
 
+bool
+uORB::DeviceNode::allocate_data()
+{
+	lock();
+
+	/* re-check size */
+	if (nullptr == _data) {
+		const size_t data_size = _meta->o_size * _queue_size;
+		_data = (uint8_t *) px4_cache_aligned_alloc(data_size);
+
+		if (_data != nullptr) {
+			memset(_data, 0, data_size);
+		}
+	}
+
+	unlock();
+
+	return _data != nullptr;
+}
+
+void *
+uORB::DeviceNode::loan()
+{
+	if (!allocate_data()) {
+		return nullptr;
+	}
+
+	uint8_t **slots = nullptr;
+	uint8_t *spare = nullptr;
+
+	if (_slots == nullptr) {
+		// first loan: switch to a slot table with one additional slot, so that queue slots can be exchanged on publication
+		slots = new uint8_t *[_queue_size];
+		spare = (uint8_t *) px4_cache_aligned_alloc(_meta->o_size);
+
+		if ((slots == nullptr) || (spare == nullptr)) {
+			delete[] slots;
+			free(spare);
+			return nullptr;
+		}
+
+		for (unsigned i = 0; i < _queue_size; i++) {
+			slots[i] = _data + (_meta->o_size * i);
+		}
+	}
+
+	void *buffer = nullptr;
+
+	ATOMIC_ENTER;
+
+	if ((_slots == nullptr) && (slots != nullptr)) {
+		write_begin();
+		_slots = slots;
+		write_end();
+		_spare = spare;
+		_spare_allocation = spare;
+		slots = nullptr;
+		spare = nullptr;
+	}
+
+	if (!_loaned && (_spare != nullptr)) {
+		_loaned = true;
+		buffer = _spare;
+	}
+
+	ATOMIC_LEAVE;
+
+	// in case another publisher set up the slot table concurrently
+	delete[] slots;
+	free(spare);
+
+	return buffer;
+}
+
+int
+uORB::DeviceNode::publish_loan(const orb_metadata *meta, orb_advert_t handle, void *buffer)
+{
+	uORB::DeviceNode *devnode = (uORB::DeviceNode *)handle;
+
+	/* check if the device handle is initialized and data is valid */
+	if ((devnode == nullptr) || (meta == nullptr) || (buffer == nullptr)) {
+		errno = EFAULT;
+		return PX4_ERROR;
+	}
+
+	/* check if the orb meta data matches the publication */
+	if (devnode->_meta->o_id != meta->o_id) {
+		errno = EINVAL;
+		return PX4_ERROR;
+	}
+
+	if (!devnode->commit_loan(buffer)) {
+		errno = EINVAL;
+		return PX4_ERROR;
+	}
+
+#ifdef CONFIG_ORB_COMMUNICATOR
+	uORBCommunicator::IChannel *ch = uORB::Manager::get_instance()->get_uorb_communicator();
+
+	if (ch != nullptr) {
+		if (ch->send_message(meta->o_name, meta->o_size, (uint8_t *)buffer) != 0) {
+			PX4_ERR("Error Sending [%s] topic data over comm_channel", meta->o_name);
+			return PX4_ERROR;
+		}
+	}
+
+#endif /* CONFIG_ORB_COMMUNICATOR */
+
+	return PX4_OK;
+}
+
+bool
+uORB::DeviceNode::commit_loan(void *buffer)
+{
+	ATOMIC_ENTER;
+
+	if (!_loaned || (buffer != _spare)) {
+		ATOMIC_LEAVE;
+		return false;
+	}
+
+	/* exchange the loaned buffer with the queue slot, which then becomes the spare */
+	write_begin();
+	const unsigned generation = _generation.fetch_add(1);
+	const unsigned index = generation % _queue_size;
+	_spare = _slots[index];
+	_slots[index] = (uint8_t *)buffer;
+	write_end();
+	_loaned = false;
+
+	if (_queue_depth != _queue_size) {
+		++_queue_depth;
+	}
+
+	// callbacks
+	for (auto item : _callbacks) {
+		item->call();
+	}
+
+	/* Mark at least one data has been published */
+	_data_valid = true;
+
+	ATOMIC_LEAVE;
+
+	/* notify any poll waiters */
+	poll_notify(POLLIN);
+
+	return true;
+}
+
+void
+uORB::DeviceNode::return_loan(void *buffer)
+{
+	ATOMIC_ENTER;
+
+	if (_loaned && (buffer == _spare)) {
+		_loaned = false;
+	}
+
+	ATOMIC_LEAVE;
+}
+
 int
 uORB::DeviceNode::ioctl(cdev::file_t *filp, int cmd, unsigned long arg)
 {
@@ -492,6 +661,76 @@ int uORB::DeviceNode::update_queue_size(unsigned int queue_size)
 	}
 
 	_queue_size = round_pow_of_two_8(queue_size);
+	_queue_depth = _queue_size;
+	return PX4_OK;
+}
+
+int uORB::DeviceNode::grow_queue(unsigned int queue_size)
+{
+	//queue size is limited to 255 (rounded to 128) for the single reason that we use uint8 to store it
+	const uint8_t new_queue_size = round_pow_of_two_8(queue_size < 255 ? queue_size : 255);
+
+	// nothing published yet: only the size changes (lock() serializes with allocate_data())
+	lock();
+
+	if (new_queue_size <= _queue_size) {
+		unlock();
+		return (queue_size <= _queue_size) ? PX4_OK : PX4_ERROR;
+	}
+
+	if (_data == nullptr) {
+		int ret = update_queue_size(new_queue_size);
+		unlock();
+		return ret;
+	}
+
+	unlock();
+
+	// _data is set now and only replaced below, allocate the new buffer outside of any lock section
+	const size_t data_size = _meta->o_size * new_queue_size;
+	uint8_t *data = (uint8_t *) px4_cache_aligned_alloc(data_size);
+	RetiredData *retired = new RetiredData{};
+
+	if ((data == nullptr) || (retired == nullptr)) {
+		free(data);
+		delete retired;
+		return PX4_ERROR;
+	}
+
+	memset(data, 0, data_size);
+
+	// a single lock section against publishers (lock() on POSIX, a critical section on NuttX)
+	ATOMIC_ENTER;
+
+	if ((new_queue_size <= _queue_size) || (_slots != nullptr)) {
+		// grown concurrently, or a publisher exchanges slots with loaned buffers (they cannot be moved)
+		const bool grown = (new_queue_size <= _queue_size);
+		ATOMIC_LEAVE;
+		free(data);
+		delete retired;
+		return grown ? PX4_OK : PX4_ERROR;
+	}
+
+	write_begin();
+
+	// move the queued messages to the index of their generation in the larger queue
+	const unsigned generation = _generation.load();
+	const unsigned queued = (generation < _queue_depth) ? generation : _queue_depth;
+
+	for (unsigned i = generation - queued; i != generation; i++) {
+		memcpy(data + (_meta->o_size * (i % new_queue_size)), slot(i), _meta->o_size);
+	}
+
+	retired->data = _data;
+	retired->next = _retired_data;
+	_retired_data = retired;
+	_data = data;
+	_queue_size = new_queue_size;
+	_queue_depth = queued;
+	write_end();
+
+	ATOMIC_LEAVE;
+
 	return PX4_OK;
 }
 
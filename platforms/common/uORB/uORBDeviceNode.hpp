@@ -188,6 +188,17 @@ public:
 	 */
 	int update_queue_size(unsigned int queue_size);
 
+	/**
+	 * Increase the size of the queue, also after data got published already. The messages in the
+	 * queue are kept and the previous buffer is only freed with the node (lock-free readers might
+	 * still access it). Not possible if a publisher uses loans.
+	 * The queued messages are copied under ATOMIC_ENTER (with interrupts disabled on NuttX).
+	 * Must not be called from interrupt context.
+	 * @param queue_size requested size of the queue (rounded up to the next power of 2, max 128)
+	 * @return PX4_OK if the queue size is at least queue_size now
+	 */
+	int grow_queue(unsigned int queue_size);
+
 	/**
 	 * Print statistics
 	 * @param max_topic_length max topic name length for printing
@@ -234,43 +245,93 @@ public:
 	bool copy(void *dst, unsigned &generation)
 	{
 		if ((dst != nullptr) && (_data != nullptr)) {
-			if (_queue_size == 1) {
-				ATOMIC_ENTER;
-				memcpy(dst, _data, _meta->o_size);
-				generation = _generation.load();
-				ATOMIC_LEAVE;
-				return true;
-
-			} else {
-				ATOMIC_ENTER;
-				const unsigned current_generation = _generation.load();
-
-				if (current_generation == generation) {
-					/* The subscriber already read the latest message, but nothing new was published yet.
-					* Return the previous message
-					*/
-					--generation;
-				}
+#if defined(CONFIG_ORB_LOCKFREE_READS)
 
-				// Compatible with normal and overflow conditions
-				if (!is_in_range(current_generation - _queue_size, generation, current_generation - 1)) {
-					// Reader is too far behind: some messages are lost
-					generation = current_generation - _queue_size;
-				}
+			// optimistic read, only valid if no publication happened in the meantime
+			for (int attempt = 0; attempt < LOCKFREE_READ_ATTEMPTS; attempt++) {
+				const unsigned sequence = _sequence.load();
 
-				memcpy(dst, _data + (_meta->o_size * (generation % _queue_size)), _meta->o_size);
-				ATOMIC_LEAVE;
+				if ((sequence & 1) == 0) {
+					unsigned read_generation = generation;
+					memcpy(dst, select_slot(read_generation), _meta->o_size);
+					__atomic_thread_fence(__ATOMIC_ACQUIRE);
 
-				++generation;
-
-				return true;
+					if (_sequence.load() == sequence) {
+						generation = read_generation;
+						return true;
+					}
+				}
 			}
+
+			// publisher keeps interfering (or got preempted during a write): wait for it
+#endif // CONFIG_ORB_LOCKFREE_READS
+
+			ATOMIC_ENTER;
+			memcpy(dst, select_slot(generation), _meta->o_size);
+			ATOMIC_LEAVE;
+			return true;
 		}
 
 		return false;
+	}
+
+	/**
+	 * Borrows the data following 'generation' in place, without copying it.
+	 *
+	 * The data may get overwritten by the publisher at any time, so the reader has to check
+	 * borrow_valid() after it finished reading and discard what it read if that fails.
+	 *
+	 * @param generation
+	 *   The generation of the subscriber, updated like for copy().
+	 * @return
+	 *   Read-only pointer to the data, nullptr if nothing was published yet.
+	 */
+	const void *borrow(unsigned &generation)
+	{
+		if (_data == nullptr) {
+			return nullptr;
+		}
+
+		ATOMIC_ENTER;
+		const void *data = select_slot(generation);
+		ATOMIC_LEAVE;
 
+		return data;
 	}
 
+	/**
+	 * Check if data returned by borrow() has not been overwritten (yet).
+	 * @param generation
+	 *   The generation returned by borrow().
+	 */
+	bool borrow_valid(unsigned generation) const
+	{
+		// the slot of message (generation - 1) is only reused once (generation - 1 + _queue_size) got published
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		return (_generation.load() - (generation - 1)) <= _queue_size;
+	}
+
+	/**
+	 * Loan a message buffer to the publisher to fill in place, which is then published
+	 * without any further copy by publish_loan(). The buffer is a spare slot outside of the
+	 * queue, so subscribers never see partially written data. Only one loan can be
+	 * outstanding per node. Must not be called from interrupt context.
+	 *
+	 * @return
+	 *   The buffer (with undefined content), nullptr if no loan is available.
+	 */
+	void *loan();
+
+	/**
+	 * Publish a buffer previously returned by loan().
+	 */
+	static int publish_loan(const orb_metadata *meta, orb_advert_t handle, void *buffer);
+
+	/**
+	 * Give back a buffer returned by loan() without publishing it.
+	 */
+	void return_loan(void *buffer);
+
 	// add item to list of work items to schedule on node update
 	bool register_callback(SubscriptionCallback *callback_sub);
 
@@ -285,19 +346,108 @@ protected:
 
 private:
 	friend uORBTest::UnitTest;
+	friend class uORB::DeviceMaster;
 
 	const orb_metadata *_meta; /**< object metadata information */
 
 	uint8_t *_data{nullptr};   /**< allocated object buffer */
+	uint8_t **_slots{nullptr}; /**< queue slot table, only set up once a publisher loans (otherwise slots are contiguous in _data) */
+	uint8_t *_spare{nullptr};  /**< spare slot outside of the queue, handed out by loan() */
+	uint8_t *_spare_allocation{nullptr}; /**< additional slot allocated for loans */
+	bool _loaned{false};       /**< _spare is currently loaned to a publisher */
 	bool _data_valid{false}; /**< At least one valid data */
 	px4::atomic<unsigned>  _generation{0};  /**< object generation count */
+#if defined(CONFIG_ORB_LOCKFREE_READS)
+	px4::atomic<unsigned>  _sequence{0};  /**< seqlock sequence, odd while the queue is modified */
+	static constexpr int LOCKFREE_READ_ATTEMPTS = 3;
+#endif // CONFIG_ORB_LOCKFREE_READS
 	List<uORB::SubscriptionCallback *>	_callbacks;
 
 	const uint8_t _instance; /**< orb multi instance identifier */
 	bool _advertised{false};  /**< has ever been advertised (not necessarily published data yet) */
 	uint8_t _queue_size; /**< maximum number of elements in the queue */
+	uint8_t _queue_depth; /**< number of elements readable from the queue (less than _queue_size after grow_queue()) */
 	int8_t _subscriber_count{0};
 
+	DeviceNode *_next_instance{nullptr}; /**< next instance of the same topic (DeviceMaster lookup index) */
+
+	struct RetiredData {
+		uint8_t *data;
+		RetiredData *next;
+	};
+
+	RetiredData *_retired_data{nullptr}; /**< buffers replaced by grow_queue() */
+
+
+	/**
+	 * Publish the loaned buffer by exchanging it with the next queue slot.
+	 * @return false if 'buffer' is not the outstanding loan
+	 */
+	bool commit_loan(void *buffer);
+
+	/**
+	 * Allocate the data buffer (if not done yet).
+	 * @return true if the data buffer is allocated
+	 */
+	bool allocate_data();
+
+	/**
+	 * Data of the queue slot for a given generation.
+	 */
+	uint8_t *slot(unsigned generation) const
+	{
+		const unsigned index = generation % _queue_size;
+		return (_slots != nullptr) ? _slots[index] : (_data + (_meta->o_size * index));
+	}
+
+	/**
+	 * Mark the start/end of a modification of the queue (for lock-free readers).
+	 * ATOMIC_ENTER must already be held when calling this.
+	 */
+	void write_begin()
+	{
+#if defined(CONFIG_ORB_LOCKFREE_READS)
+		_sequence.fetch_add(1);
+		// order the sequence (and generation) update before the data stores
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+#endif // CONFIG_ORB_LOCKFREE_READS
+	}
+
+	void write_end()
+	{
+#if defined(CONFIG_ORB_LOCKFREE_READS)
+		_sequence.fetch_add(1);
+#endif // CONFIG_ORB_LOCKFREE_READS
+	}
+
+	/**
+	 * Select the slot a subscriber reads next and update its generation.
+	 * ATOMIC_ENTER must be held when calling this, or the read validated with _sequence.
+	 */
+	uint8_t *select_slot(unsigned &generation)
+	{
+		if (_queue_size == 1) {
+			generation = _generation.load();
+			return slot(0);
+		}
+
+		const unsigned current_generation = _generation.load();
+
+		if (current_generation == generation) {
+			/* The subscriber already read the latest message, but nothing new was published yet.
+			* Return the previous message
+			*/
+			--generation;
+		}
+
+		// Compatible with normal and overflow conditions
+		if (!is_in_range(current_generation - _queue_depth, generation, current_generation - 1)) {
+			// Reader is too far behind: some messages are lost
+			generation = current_generation - _queue_depth;
+		}
+
+		return slot(generation++);
+	}
 
 // Determine the data range
 	static inline bool is_in_range(unsigned left, unsigned value, unsigned right)
@@ -179,6 +179,12 @@ int	uORB::Manager::orb_ioctl(unsigned int cmd, unsigned long arg)
 		}
 		break;
 
+	case ORBIOCDEVGROWQUEUE: {
+			orbiocdevgrowqueue_t *data = (orbiocdevgrowqueue_t *)arg;
+			data->ret = uORB::Manager::orb_grow_queue(data->handle, data->size);
+		}
+		break;
+
 	case ORBIOCDEVDATACOPY: {
 			orbiocdevdatacopy_t *data = (orbiocdevdatacopy_t *)arg;
 			data->ret = uORB::Manager::orb_data_copy(data->handle, data->dst, data->generation, data->only_if_updated);
@@ -455,6 +461,11 @@ void uORB::Manager::orb_remove_internal_subscriber(void *node_handle)
 
 uint8_t uORB::Manager::orb_get_queue_size(const void *node_handle) { return static_cast<const DeviceNode *>(node_handle)->get_queue_size(); }
 
+bool uORB::Manager::orb_grow_queue(void *node_handle, uint8_t queue_size)
+{
+	return static_cast<DeviceNode *>(node_handle)->grow_queue(queue_size) == PX4_OK;
+}
+
 bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &generation, bool only_if_updated)
 {
 	if (!is_advertised(node_handle)) {
@@ -468,6 +479,53 @@ bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &genera
 	return static_cast<DeviceNode *>(node_handle)->copy(dst, generation);
 }
 
+const void *uORB::Manager::orb_data_borrow(void *node_handle, unsigned &generation, bool only_if_updated)
+{
+	if (!is_advertised(node_handle)) {
+		return nullptr;
+	}
+
+	if (only_if_updated && !static_cast<const uORB::DeviceNode *>(node_handle)->updates_available(generation)) {
+		return nullptr;
+	}
+
+	return static_cast<DeviceNode *>(node_handle)->borrow(generation);
+}
+
+bool uORB::Manager::orb_data_borrow_valid(const void *node_handle, unsigned generation)
+{
+	return static_cast<const DeviceNode *>(node_handle)->borrow_valid(generation);
+}
+
+void *uORB::Manager::orb_loan(orb_advert_t handle)
+{
+	if (handle == nullptr) {
+		return nullptr;
+	}
+
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		return nullptr; // publish() pretends success
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+	return static_cast<DeviceNode *>(handle)->loan();
+}
+
+int uORB::Manager::orb_publish_loan(const struct orb_metadata *meta, orb_advert_t handle, void *buffer)
+{
+	return uORB::DeviceNode::publish_loan(meta, handle, buffer);
+}
+
+void uORB::Manager::orb_return_loan(orb_advert_t handle, void *buffer)
+{
+	if (handle != nullptr) {
+		static_cast<DeviceNode *>(handle)->return_loan(buffer);
+	}
+}
+
 // add item to list of work items to schedule on node update
 bool uORB::Manager::register_callback(void *node_handle, SubscriptionCallback *callback_sub)
 {
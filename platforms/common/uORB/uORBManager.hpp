@@ -147,6 +147,13 @@ typedef struct {
 	bool ret;
 } orbiocdevisadvertised_t;
 
+#define ORBIOCDEVGROWQUEUE	_ORBIOCDEV(43)
+typedef struct {
+	void *handle;
+	uint8_t size;
+	bool ret;
+} orbiocdevgrowqueue_t;
+
 typedef enum {
 	ORB_DEVMASTER_STATUS = 0,
 	ORB_DEVMASTER_TOP = 1
@@ -445,8 +452,32 @@ public:
 
 	static uint8_t orb_get_queue_size(const void *node_handle);
 
+	/**
+	 * Increase the queue size of a topic, keeping the queued messages, see DeviceNode::grow_queue().
+	 * @return true if the queue holds at least queue_size messages now
+	 */
+	static bool orb_grow_queue(void *node_handle, uint8_t queue_size);
+
 	static bool orb_data_copy(void *node_handle, void *dst, unsigned &generation, bool only_if_updated);
 
+	/**
+	 * Zero-copy read access to the topic data, see DeviceNode::borrow().
+	 * Not available across the kernel/user boundary (returns nullptr there).
+	 */
+	static const void *orb_data_borrow(void *node_handle, unsigned &generation, bool only_if_updated);
+
+	static bool orb_data_borrow_valid(const void *node_handle, unsigned generation);
+
+	/**
+	 * Zero-copy publication, see DeviceNode::loan().
+	 * Not available across the kernel/user boundary (returns nullptr there).
+	 */
+	static void *orb_loan(orb_advert_t handle);
+
+	static int orb_publish_loan(const struct orb_metadata *meta, orb_advert_t handle, void *buffer);
+
+	static void orb_return_loan(orb_advert_t handle, void *buffer);
+
 	static bool register_callback(void *node_handle, SubscriptionCallback *callback_sub);
 
 	static void unregister_callback(void *node_handle, SubscriptionCallback *callback_sub);
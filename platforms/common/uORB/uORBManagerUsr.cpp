@@ -303,6 +303,14 @@ uint8_t uORB::Manager::orb_get_queue_size(const void *node_handle)
 	return data.size;
 }
 
+bool uORB::Manager::orb_grow_queue(void *node_handle, uint8_t queue_size)
+{
+	orbiocdevgrowqueue_t data = {node_handle, queue_size, false};
+	boardctl(ORBIOCDEVGROWQUEUE, reinterpret_cast<unsigned long>(&data));
+
+	return data.ret;
+}
+
 bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &generation, bool only_if_updated)
 {
 	orbiocdevdatacopy_t data = {node_handle, dst, generation, only_if_updated, false};
@@ -312,6 +320,31 @@ bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &genera
 	return data.ret;
 }
 
+// the topic data lives in kernel memory, so there's no zero-copy access from user space
+const void *uORB::Manager::orb_data_borrow(void *node_handle, unsigned &generation, bool only_if_updated)
+{
+	return nullptr;
+}
+
+bool uORB::Manager::orb_data_borrow_valid(const void *node_handle, unsigned generation)
+{
+	return false;
+}
+
+void *uORB::Manager::orb_loan(orb_advert_t handle)
+{
+	return nullptr;
+}
+
+int uORB::Manager::orb_publish_loan(const struct orb_metadata *meta, orb_advert_t handle, void *buffer)
+{
+	return PX4_ERROR;
+}
+
+void uORB::Manager::orb_return_loan(orb_advert_t handle, void *buffer)
+{
+}
+
 bool uORB::Manager::register_callback(void *node_handle, SubscriptionCallback *callback_sub)
 {
 	orbiocdevregcallback_t data = {node_handle, callback_sub, false};
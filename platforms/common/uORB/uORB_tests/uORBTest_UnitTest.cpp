@@ -39,6 +39,7 @@
 #include <errno.h>
 #include <math.h>
 #include <lib/cdev/CDev.hpp>
+#include <uORB/Publication.hpp>
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/SubscriptionMultiArray.hpp>
 
@@ -206,7 +207,25 @@ int uORBTest::UnitTest::test()
 		return ret;
 	}
 
-	return test_queue_poll_notify();
+	ret = test_queue_poll_notify();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	ret = test_loan_borrow();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	ret = test_queue_grow();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	return test_queue_grow_concurrent();
 }
 
 int uORBTest::UnitTest::test_unadvertise()
@@ -1033,6 +1052,258 @@ int uORBTest::UnitTest::test_queue_poll_notify()
 	return test_note("PASS orb queuing (poll & notify), got %i messages", next_expected_val);
 }
 
+int uORBTest::UnitTest::test_loan_borrow()
+{
+	test_note("Testing loan & borrow");
+
+	static constexpr uint8_t queue_size = 4;
+	uORB::Publication<orb_test_medium_s, queue_size> pub{ORB_ID(orb_test_medium_loan)};
+	uORB::Subscription sub{ORB_ID(orb_test_medium_loan)};
+
+	orb_test_medium_s *msg = pub.loan();
+
+	if (msg == nullptr) {
+		return test_fail("loan failed");
+	}
+
+	if (pub.loan() != nullptr) {
+		return test_fail("second loan succeeded");
+	}
+
+	msg->timestamp = hrt_absolute_time();
+	msg->val = 1;
+
+	if (!pub.publish_loan(msg)) {
+		return test_fail("publish_loan failed");
+	}
+
+	const orb_test_medium_s *borrowed = static_cast<const orb_test_medium_s *>(sub.borrow());
+
+	if (borrowed == nullptr) {
+		return test_fail("borrow failed");
+	}
+
+	if ((borrowed->val != 1) || !sub.borrow_valid()) {
+		return test_fail("borrow mismatch: %d expected 1", borrowed->val);
+	}
+
+	if (sub.borrow() != nullptr) {
+		return test_fail("borrow without update");
+	}
+
+	// a returned loan can be loaned again
+	msg = pub.loan();
+	pub.return_loan(msg);
+	msg = pub.loan();
+
+	if (msg == nullptr) {
+		return test_fail("loan after return failed");
+	}
+
+	pub.return_loan(msg);
+
+	// the borrowed data stays valid until the queue wrapped around, mixing loans and copies
+	for (int i = 0; i < queue_size - 1; ++i) {
+		if (i % 2 == 0) {
+			orb_test_medium_s t{};
+			t.val = 10 + i;
+			pub.publish(t);
+
+		} else {
+			msg = pub.loan();
+
+			if (msg == nullptr) {
+				return test_fail("loan %d failed", i);
+			}
+
+			msg->val = 10 + i;
+			pub.publish_loan(msg);
+		}
+	}
+
+	if (!sub.borrow_valid() || (borrowed->val != 1)) {
+		return test_fail("borrowed data overwritten too early");
+	}
+
+	msg = pub.loan();
+
+	if (msg == nullptr) {
+		return test_fail("loan failed");
+	}
+
+	msg->val = 10 + queue_size - 1;
+	pub.publish_loan(msg);
+
+	if (sub.borrow_valid()) {
+		return test_fail("borrowed data not invalidated");
+	}
+
+	// the queue is read back in order with copies
+	orb_test_medium_s u{};
+
+	for (int i = 0; i < queue_size; ++i) {
+		if (!sub.update(&u)) {
+			return test_fail("update %d failed", i);
+		}
+
+		if (u.val != 10 + i) {
+			return test_fail("got wrong element from the queue (got %i, should be %i)", u.val, 10 + i);
+		}
+	}
+
+	pub.unadvertise();
+
+	return test_note("PASS loan & borrow");
+}
+
+int uORBTest::UnitTest::test_queue_grow()
+{
+	test_note("Testing queue growing");
+
+	static constexpr uint8_t queue_size = 4;
+	uORB::Publication<orb_test_medium_s, queue_size> pub{ORB_ID(orb_test_medium_queue_grow)};
+	uORB::Subscription sub{ORB_ID(orb_test_medium_queue_grow)};
+
+	if (!pub.advertise() || !sub.subscribe()) {
+		return test_fail("advertise/subscribe failed");
+	}
+
+	orb_test_medium_s t{};
+
+	for (int i = 0; i < queue_size + 2; ++i) {
+		t.val = i;
+		pub.publish(t);
+	}
+
+	if (!sub.grow_queue(16) || (sub.get_queue_size() != 16)) {
+		return test_fail("grow failed (queue size %d)", sub.get_queue_size());
+	}
+
+	if (sub.updates_available() != queue_size + 2) {
+		return test_fail("wrong number of updates: %d", sub.updates_available());
+	}
+
+	// messages lost before growing stay lost, the queued ones are kept
+	orb_test_medium_s u{};
+
+	for (int i = 2; i < queue_size + 2; ++i) {
+		if (!sub.update(&u) || (u.val != i)) {
+			return test_fail("got wrong element from the queue (got %i, should be %i)", u.val, i);
+		}
+	}
+
+	if (sub.update(&u)) {
+		return test_fail("spurious update");
+	}
+
+	for (int i = 0; i < 15; ++i) {
+		t.val = 100 + i;
+		pub.publish(t);
+	}
+
+	for (int i = 0; i < 15; ++i) {
+		if (!sub.update(&u) || (u.val != 100 + i)) {
+			return test_fail("got wrong element from the grown queue (got %i, should be %i)", u.val, 100 + i);
+		}
+	}
+
+	// the queue is never shrunk
+	if (!sub.grow_queue(8) || (sub.get_queue_size() != 16)) {
+		return test_fail("queue shrunk to %d", sub.get_queue_size());
+	}
+
+	pub.unadvertise();
+
+	return test_note("PASS queue growing");
+}
+
+int uORBTest::UnitTest::pub_test_queue_grow_entry(int argc, char *argv[])
+{
+	uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+	uORB::Publication<orb_test_medium_s> pub{ORB_ID(orb_test_medium_queue_grow_pub)};
+	orb_test_medium_s msg{};
+
+	for (int i = 1; i <= 20000; ++i) {
+		msg.val = i;
+		memset(msg.junk, i & 0xff, sizeof(msg.junk));
+		pub.publish(msg);
+
+		if (i % 100 == 0) {
+			px4_usleep(100);
+		}
+	}
+
+	t._num_messages_sent = msg.val;
+	t._thread_should_exit = true;
+	return 0;
+}
+
+int uORBTest::UnitTest::test_queue_grow_concurrent()
+{
+	test_note("Testing queue growing while publishing");
+
+	uORB::Publication<orb_test_medium_s, 2> pub{ORB_ID(orb_test_medium_queue_grow_pub)};
+	uORB::Subscription sub{ORB_ID(orb_test_medium_queue_grow_pub)};
+
+	// publish first, so that the data is allocated before growing
+	orb_test_medium_s t{};
+
+	if (!pub.publish(t) || !sub.subscribe()) {
+		return test_fail("publish/subscribe failed");
+	}
+
+	_num_messages_sent = 0;
+	_thread_should_exit = false;
+
+	char *const args[1] = { nullptr };
+
+	if (px4_task_spawn_cmd("uorb_test_grow", SCHED_DEFAULT, SCHED_PRIORITY_DEFAULT, 2000,
+			       (px4_main_t)&uORBTest::UnitTest::pub_test_queue_grow_entry, args) < 0) {
+		return test_fail("failed launching task");
+	}
+
+	uint8_t queue_size = 2;
+	int last_val = 0;
+	orb_test_medium_s u{};
+
+	while (!_thread_should_exit || sub.updated() || (queue_size < 128)) {
+		if (queue_size < 128) {
+			queue_size *= 2;
+
+			if (!sub.grow_queue(queue_size) || (sub.get_queue_size() != queue_size)) {
+				_thread_should_exit = true;
+				return test_fail("grow to %d failed (queue size %d)", queue_size, sub.get_queue_size());
+			}
+		}
+
+		while (sub.update(&u)) {
+			if (u.val <= last_val) {
+				return test_fail("got old element (got %i, previous %i)", u.val, last_val);
+			}
+
+			for (size_t i = 0; i < sizeof(u.junk); ++i) {
+				if (u.junk[i] != (u.val & 0xff)) {
+					return test_fail("inconsistent element %i", u.val);
+				}
+			}
+
+			last_val = u.val;
+		}
+
+		px4_usleep(1000);
+	}
+
+	if (last_val != _num_messages_sent) {
+		return test_fail("last element %i, should be %i", last_val, _num_messages_sent);
+	}
+
+	if (sub.get_queue_size() != 128) {
+		return test_fail("queue size %d, should be 128", sub.get_queue_size());
+	}
+
+	return test_note("PASS queue growing while publishing");
+}
+
 int uORBTest::UnitTest::latency_test(bool print)
 {
 	test_note("---------------- LATENCY TEST ------------------");
@@ -1085,6 +1356,161 @@ int uORBTest::UnitTest::latency_test(bool print)
 	return pubsubtest_res;
 }
 
+int uORBTest::UnitTest::lookup_benchmark()
+{
+	test_note("---------------- LOOKUP BENCHMARK ------------------");
+
+	// make sure all test topic instances exist, so that lookups cover multi-instance chains
+	orb_test_s t{};
+	orb_advert_t pfd[ORB_MULTI_MAX_INSTANCES] {};
+
+	for (int i = 0; i < ORB_MULTI_MAX_INSTANCES; ++i) {
+		int instance = 0;
+		pfd[i] = orb_advertise_multi(ORB_ID(orb_multitest), &t, &instance);
+	}
+
+	const orb_metadata *const *topics = orb_get_topics();
+	static constexpr unsigned NUM_RUNS = 100;
+
+	// orb_exists() for every topic and instance (as done by modules on start-up)
+	unsigned num_lookups = 0;
+	unsigned num_found = 0;
+	hrt_abstime start = hrt_absolute_time();
+
+	for (unsigned run = 0; run < NUM_RUNS; ++run) {
+		for (size_t i = 0; i < orb_topics_count(); ++i) {
+			for (int instance = 0; instance < ORB_MULTI_MAX_INSTANCES; ++instance) {
+				if (orb_exists(topics[i], instance) == PX4_OK) {
+					++num_found;
+				}
+
+				++num_lookups;
+			}
+		}
+	}
+
+	const hrt_abstime exists_elapsed = hrt_elapsed_time(&start);
+
+	// subscribe & unsubscribe every existing topic instance (lazy subscription in uORB::Subscription)
+	unsigned num_subscriptions = 0;
+	start = hrt_absolute_time();
+
+	for (unsigned run = 0; run < NUM_RUNS; ++run) {
+		for (size_t i = 0; i < orb_topics_count(); ++i) {
+			for (uint8_t instance = 0; instance < ORB_MULTI_MAX_INSTANCES; ++instance) {
+				uORB::Subscription sub{topics[i], instance};
+
+				if (sub.subscribe()) {
+					++num_subscriptions;
+				}
+			}
+		}
+	}
+
+	const hrt_abstime subscribe_elapsed = hrt_elapsed_time(&start);
+
+	for (int i = 0; i < ORB_MULTI_MAX_INSTANCES; ++i) {
+		orb_unadvertise(pfd[i]);
+	}
+
+	PX4_INFO("topics: %u, existing instances: %u", (unsigned)orb_topics_count(), num_found / NUM_RUNS);
+	PX4_INFO("orb_exists:            %8.4f us/call (%u calls)",
+		 (double)exists_elapsed / (double)num_lookups, num_lookups);
+
+	if (num_subscriptions > 0) {
+		PX4_INFO("subscribe/unsubscribe: %8.4f us/call (%u calls)",
+			 (double)subscribe_elapsed / (double)num_subscriptions, num_subscriptions);
+	}
+
+	return test_note("PASS lookup benchmark");
+}
+
+int uORBTest::UnitTest::contention_writer_entry(int argc, char *argv[])
+{
+	uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+	uORB::Publication<orb_test_large_s> pub{ORB_ID(orb_test_large)};
+	orb_test_large_s msg{};
+
+	while (t._contention_run.load()) {
+		msg.timestamp = hrt_absolute_time();
+		msg.val++;
+		pub.publish(msg);
+		t._contention_writes.fetch_add(1);
+	}
+
+	t._contention_threads.fetch_sub(1);
+	return 0;
+}
+
+int uORBTest::UnitTest::contention_reader_entry(int argc, char *argv[])
+{
+	uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+	uORB::Subscription sub{ORB_ID(orb_test_large)};
+	orb_test_large_s msg{};
+	unsigned reads = 0;
+
+	while (t._contention_run.load()) {
+		if (sub.copy(&msg)) {
+			reads++;
+		}
+	}
+
+	t._contention_reads.fetch_add(reads);
+	t._contention_threads.fetch_sub(1);
+	return 0;
+}
+
+int uORBTest::UnitTest::contention_benchmark()
+{
+	test_note("---------------- CONTENTION BENCHMARK ------------------");
+
+	orb_test_large_s msg{};
+	orb_advert_t pfd = orb_advertise(ORB_ID(orb_test_large), &msg);
+
+	if (pfd == nullptr) {
+		return test_fail("orb_advertise failed (%i)", errno);
+	}
+
+	static constexpr unsigned DURATION_US = 1000000;
+	char *const args[1] = { nullptr };
+
+	for (int num_readers = 1; num_readers <= 8; num_readers *= 2) {
+		_contention_run.store(true);
+		_contention_writes.store(0);
+		_contention_reads.store(0);
+		_contention_threads.store(num_readers + 1);
+
+		// low priority, so that this thread can stop the busy looping workers
+		if (px4_task_spawn_cmd("uorb_cont_w", SCHED_DEFAULT, SCHED_PRIORITY_MIN + 1, 2000,
+				       (px4_main_t)&uORBTest::UnitTest::contention_writer_entry, args) < 0) {
+			_contention_run.store(false);
+			return test_fail("failed launching writer task");
+		}
+
+		for (int i = 0; i < num_readers; ++i) {
+			if (px4_task_spawn_cmd("uorb_cont_r", SCHED_DEFAULT, SCHED_PRIORITY_MIN + 1, 2000,
+					       (px4_main_t)&uORBTest::UnitTest::contention_reader_entry, args) < 0) {
+				_contention_threads.fetch_sub(1);
+			}
+		}
+
+		px4_usleep(DURATION_US);
+		_contention_run.store(false);
+
+		while (_contention_threads.load() > 0) {
+			px4_usleep(1000);
+		}
+
+		const unsigned reads = _contention_reads.load();
+		PX4_INFO("readers: %i, writes: %8u/s, reads: %9u/s (%8u/s per reader)", num_readers,
+			 _contention_writes.load(), reads, reads / num_readers);
+	}
+
+	orb_unadvertise(pfd);
+
+	return test_note("PASS contention benchmark");
+}
+
 int uORBTest::UnitTest::test_fail(const char *fmt, ...)
 {
 	va_list ap;
@@ -42,6 +42,7 @@
 #include <uORB/topics/orb_test_medium.h>
 #include <uORB/topics/orb_test_large.h>
 
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/posix.h>
 #include <px4_platform_common/time.h>
@@ -67,6 +68,8 @@ public:
 
 	int test();
 	int latency_test(bool print);
+	int lookup_benchmark();
+	int contention_benchmark();
 	int info();
 
 	// Disallow copy
@@ -87,6 +90,14 @@ private:
 	static int pub_test_multi2_entry(int argc, char *argv[]);
 	int pub_test_multi2_main();
 
+	/* contention benchmark */
+	static int contention_writer_entry(int argc, char *argv[]);
+	static int contention_reader_entry(int argc, char *argv[]);
+	px4::atomic_bool _contention_run{false};
+	px4::atomic<unsigned> _contention_writes{0};
+	px4::atomic<unsigned> _contention_reads{0};
+	px4::atomic<int> _contention_threads{0};
+
 	volatile bool _thread_should_exit;
 
 	bool pubsubtest_passed{false};
@@ -113,6 +124,11 @@ private:
 	static int pub_test_queue_entry(int argc, char *argv[]);
 	int pub_test_queue_main();
 	int test_queue_poll_notify();
+
+	int test_loan_borrow();
+	int test_queue_grow();
+	static int pub_test_queue_grow_entry(int argc, char *argv[]);
+	int test_queue_grow_concurrent();
 	volatile int _num_messages_sent = 0;
 
 	int test_fail(const char *fmt, ...);
@@ -39,7 +39,7 @@ extern "C" { __EXPORT int uorb_tests_main(int argc, char *argv[]); }
 
 static void usage()
 {
-	PX4_INFO("Usage: uorb_tests [latency_test]");
+	PX4_INFO("Usage: uorb_tests [latency_test|lookup_benchmark|contention_benchmark]");
 }
 
 int
@@ -70,6 +70,22 @@ uorb_tests_main(int argc, char *argv[])
 		return t.latency_test(true);
 	}
 
+	/*
+	 * Benchmark the topic lookup.
+	 */
+	if (argc > 1 && !strcmp(argv[1], "lookup_benchmark")) {
+		uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+		return t.lookup_benchmark();
+	}
+
+	/*
+	 * Benchmark concurrent readers.
+	 */
+	if (argc > 1 && !strcmp(argv[1], "contention_benchmark")) {
+		uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+		return t.contention_benchmark();
+	}
+
 	usage();
 	return -EINVAL;
 }
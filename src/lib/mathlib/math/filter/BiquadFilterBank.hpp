@@ -0,0 +1,354 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file BiquadFilterBank.hpp
+ *
+ * @brief Bank of second order filter sections applied to the 3 axes of a signal.
+ */
+
+#pragma once
+
+#include <mathlib/math/Functions.hpp>
+#include <stdint.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace math
+{
+
+/**
+ * Cascade of biquad sections applied in place to the 3 axes of a signal.
+ *
+ * Coefficients and state are stored as structure of arrays, with one lane per axis (padded to 4),
+ * so that a section filters all axes at once with NEON or SSE. Without SIMD, each axis is filtered
+ * in a plain loop directly on the input arrays. Samples are processed in blocks: a section
+ * filters the whole block before the next section runs, so its state stays in registers.
+ *
+ * The sections use the same Direct Form I and reset behavior as NotchFilter<float>, so a cascade of
+ * notch filters can be moved into a bank by copying their coefficients.
+ */
+class BiquadFilterBank
+{
+public:
+	static constexpr int AXES = 3;
+
+	BiquadFilterBank() = default;
+	~BiquadFilterBank() { delete[] _sections; }
+
+	BiquadFilterBank(const BiquadFilterBank &) = delete;
+	BiquadFilterBank &operator=(const BiquadFilterBank &) = delete;
+
+	/**
+	 * Allocate the sections. All of them are disabled (pass through) afterwards.
+	 * @return true on success
+	 */
+	bool allocate(int num_sections)
+	{
+		delete[] _sections;
+		_sections = (num_sections > 0) ? new Section[num_sections] : nullptr;
+		_num_sections = _sections ? num_sections : 0;
+		return _sections != nullptr;
+	}
+
+	int numSections() const { return _num_sections; }
+
+	/**
+	 * Set the coefficients of one axis of a section and enable it. The state is kept.
+	 * @param a denominator coefficients, normalized (a[0] is assumed to be 1)
+	 * @param b numerator coefficients
+	 */
+	void setCoefficients(int section, int axis, const float a[3], const float b[3])
+	{
+		Section &s = _sections[section];
+		s.b0[axis] = b[0];
+		s.b1[axis] = b[1];
+		s.b2[axis] = b[2];
+		s.a1[axis] = a[1];
+		s.a2[axis] = a[2];
+		s.lane_mask[axis] = UINT32_MAX;
+		s.enabled |= (1 << axis);
+	}
+
+	/**
+	 * Reset the state of one axis of a section to steady state with its next input sample
+	 */
+	void reset(int section, int axis) { _sections[section].reset_pending |= (1 << axis); }
+
+	/**
+	 * Disable one axis of a section (no filtering)
+	 */
+	void disable(int section, int axis)
+	{
+		Section &s = _sections[section];
+		s.b0[axis] = 1.f;
+		s.b1[axis] = s.b2[axis] = s.a1[axis] = s.a2[axis] = 0.f;
+		s.x1[axis] = s.x2[axis] = s.y1[axis] = s.y2[axis] = 0.f;
+		s.lane_mask[axis] = 0;
+		s.enabled &= ~(1 << axis);
+		s.reset_pending &= ~(1 << axis);
+	}
+
+	bool enabled(int section, int axis) const { return _sections[section].enabled & (1 << axis); }
+
+	/**
+	 * Filter arrays of samples in place, applying all enabled sections in order
+	 */
+	inline void applyArray(float x[], float y[], float z[], int num_samples)
+	{
+		float *data[AXES] {x, y, z};
+
+#if defined(__ARM_NEON) || defined(__SSE2__)
+
+		for (int offset = 0; offset < num_samples; offset += BLOCK_SIZE) {
+			const int N = math::min(num_samples - offset, BLOCK_SIZE);
+
+			// interleave the axes into 4 lanes
+			alignas(16) float block[BLOCK_SIZE][4];
+
+			for (int n = 0; n < N; n++) {
+				block[n][0] = data[0][offset + n];
+				block[n][1] = data[1][offset + n];
+				block[n][2] = data[2][offset + n];
+				block[n][3] = 0.f;
+			}
+
+			for (int i = 0; i < _num_sections; i++) {
+				Section &s = _sections[i];
+
+				if (s.enabled) {
+					if (s.reset_pending) {
+						resetPending(s, block[0]);
+					}
+
+					applySection(s, block, N);
+				}
+			}
+
+			for (int n = 0; n < N; n++) {
+				data[0][offset + n] = block[n][0];
+				data[1][offset + n] = block[n][1];
+				data[2][offset + n] = block[n][2];
+			}
+		}
+
+#else
+
+		if (num_samples <= 0) {
+			return;
+		}
+
+		for (int i = 0; i < _num_sections; i++) {
+			Section &s = _sections[i];
+
+			if (s.enabled) {
+				if (s.reset_pending) {
+					const float first_sample[AXES] {data[0][0], data[1][0], data[2][0]};
+					resetPending(s, first_sample);
+				}
+
+				for (int axis = 0; axis < AXES; axis++) {
+					if (s.enabled & (1 << axis)) {
+						applySection(s, axis, data[axis], num_samples);
+					}
+				}
+			}
+		}
+
+#endif
+	}
+
+private:
+	static constexpr int BLOCK_SIZE = 16;
+
+	struct Section {
+		// coefficients normalized by a0, one lane per axis (disabled: pass through)
+		float b0[4] {1.f, 1.f, 1.f, 1.f};
+		float b1[4] {};
+		float b2[4] {};
+		float a1[4] {};
+		float a2[4] {};
+
+		// Direct Form I state
+		float x1[4] {};
+		float x2[4] {};
+		float y1[4] {};
+		float y2[4] {};
+
+		uint32_t lane_mask[4] {}; ///< all bits set for enabled lanes
+
+		uint8_t enabled{0};       ///< bit per enabled axis
+		uint8_t reset_pending{0}; ///< bit per axis to reset with the next sample
+	};
+
+	/**
+	 * Reset the axes of a section marked with reset_pending, like NotchFilter::reset(sample)
+	 */
+	static void resetPending(Section &s, const float sample[])
+	{
+		for (int axis = 0; axis < AXES; axis++) {
+			if (s.reset_pending & (1 << axis)) {
+				const float input = isFinite(sample[axis]) ? sample[axis] : 0.f;
+
+				s.x1[axis] = s.x2[axis] = input;
+				s.y1[axis] = s.y2[axis] = input * (s.b0[axis] + s.b1[axis] + s.b2[axis]) / (1 + s.a1[axis] + s.a2[axis]);
+			}
+		}
+
+		s.reset_pending = 0;
+	}
+
+#if defined(__ARM_NEON)
+
+	static void applySection(Section &s, float block[][4], int N)
+	{
+		const float32x4_t b0 = vld1q_f32(s.b0);
+		const float32x4_t b1 = vld1q_f32(s.b1);
+		const float32x4_t b2 = vld1q_f32(s.b2);
+		const float32x4_t a1 = vld1q_f32(s.a1);
+		const float32x4_t a2 = vld1q_f32(s.a2);
+		const uint32x4_t lane_mask = vld1q_u32(s.lane_mask);
+
+		float32x4_t x1 = vld1q_f32(s.x1);
+		float32x4_t x2 = vld1q_f32(s.x2);
+		float32x4_t y1 = vld1q_f32(s.y1);
+		float32x4_t y2 = vld1q_f32(s.y2);
+
+		for (int n = 0; n < N; n++) {
+			const float32x4_t x = vld1q_f32(block[n]);
+
+			// same operation order as NotchFilter::applyInternal()
+			float32x4_t y = vaddq_f32(vmulq_f32(b0, x), vmulq_f32(b1, x1));
+			y = vaddq_f32(y, vmulq_f32(b2, x2));
+			y = vsubq_f32(y, vmulq_f32(a1, y1));
+			y = vsubq_f32(y, vmulq_f32(a2, y2));
+
+			x2 = x1;
+			x1 = x;
+			y2 = y1;
+			y1 = y;
+
+			// disabled lanes pass the input through unchanged
+			vst1q_f32(block[n], vbslq_f32(lane_mask, y, x));
+		}
+
+		vst1q_f32(s.x1, x1);
+		vst1q_f32(s.x2, x2);
+		vst1q_f32(s.y1, y1);
+		vst1q_f32(s.y2, y2);
+	}
+
+#elif defined(__SSE2__)
+
+	static void applySection(Section &s, float block[][4], int N)
+	{
+		const __m128 b0 = _mm_loadu_ps(s.b0);
+		const __m128 b1 = _mm_loadu_ps(s.b1);
+		const __m128 b2 = _mm_loadu_ps(s.b2);
+		const __m128 a1 = _mm_loadu_ps(s.a1);
+		const __m128 a2 = _mm_loadu_ps(s.a2);
+		const __m128 lane_mask = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)s.lane_mask));
+
+		__m128 x1 = _mm_loadu_ps(s.x1);
+		__m128 x2 = _mm_loadu_ps(s.x2);
+		__m128 y1 = _mm_loadu_ps(s.y1);
+		__m128 y2 = _mm_loadu_ps(s.y2);
+
+		for (int n = 0; n < N; n++) {
+			const __m128 x = _mm_load_ps(block[n]);
+
+			// same operation order as NotchFilter::applyInternal()
+			__m128 y = _mm_add_ps(_mm_mul_ps(b0, x), _mm_mul_ps(b1, x1));
+			y = _mm_add_ps(y, _mm_mul_ps(b2, x2));
+			y = _mm_sub_ps(y, _mm_mul_ps(a1, y1));
+			y = _mm_sub_ps(y, _mm_mul_ps(a2, y2));
+
+			x2 = x1;
+			x1 = x;
+			y2 = y1;
+			y1 = y;
+
+			// disabled lanes pass the input through unchanged
+			_mm_store_ps(block[n], _mm_or_ps(_mm_and_ps(lane_mask, y), _mm_andnot_ps(lane_mask, x)));
+		}
+
+		_mm_storeu_ps(s.x1, x1);
+		_mm_storeu_ps(s.x2, x2);
+		_mm_storeu_ps(s.y1, y1);
+		_mm_storeu_ps(s.y2, y2);
+	}
+
+#else
+
+	static void applySection(Section &s, int axis, float samples[], int N)
+	{
+		const float b0 = s.b0[axis];
+		const float b1 = s.b1[axis];
+		const float b2 = s.b2[axis];
+		const float a1 = s.a1[axis];
+		const float a2 = s.a2[axis];
+
+		float x1 = s.x1[axis];
+		float x2 = s.x2[axis];
+		float y1 = s.y1[axis];
+		float y2 = s.y2[axis];
+
+		for (int n = 0; n < N; n++) {
+			const float x = samples[n];
+			const float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+
+			x2 = x1;
+			x1 = x;
+			y2 = y1;
+			y1 = y;
+
+			samples[n] = y;
+		}
+
+		s.x1[axis] = x1;
+		s.x2[axis] = x2;
+		s.y1[axis] = y1;
+		s.y2[axis] = y2;
+	}
+
+#endif
+
+	Section *_sections{nullptr};
+	int _num_sections{0};
+};
+
+} // namespace math
@@ -0,0 +1,204 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Test code for the biquad filter bank
+ * Run this test only using make tests TESTFILTER=BiquadFilterBank
+ */
+
+#include <gtest/gtest.h>
+
+#include <lib/mathlib/math/filter/BiquadFilterBank.hpp>
+#include <lib/mathlib/math/filter/NotchFilter.hpp>
+
+using namespace math;
+
+class BiquadFilterBankTest : public ::testing::Test
+{
+public:
+	static constexpr int NUM_SECTIONS = 4;
+	static constexpr int AXES = BiquadFilterBank::AXES;
+
+	void SetUp() override
+	{
+		ASSERT_TRUE(_bank.allocate(NUM_SECTIONS));
+
+		// different notch frequency for each section and axis, axis 1 of section 2 disabled
+		for (int section = 0; section < NUM_SECTIONS; section++) {
+			for (int axis = 0; axis < AXES; axis++) {
+				if (section == 2 && axis == 1) {
+					_notch[section][axis].disable();
+
+				} else {
+					_notch[section][axis].setParameters(_sample_freq, 60.f + 70.f * section + 10.f * axis, 20.f);
+				}
+
+				copyToBank(section, axis);
+			}
+		}
+	}
+
+	// move a notch filter into the bank (the way VehicleAngularVelocity does)
+	void copyToBank(int section, int axis)
+	{
+		NotchFilter<float> &nf = _notch[section][axis];
+
+		if (nf.getNotchFreq() > 0.f) {
+			float a[3];
+			float b[3];
+			nf.getCoefficients(a, b);
+			_bank.setCoefficients(section, axis, a, b);
+
+			if (!nf.initialized()) {
+				_bank.reset(section, axis);
+			}
+
+		} else {
+			_bank.disable(section, axis);
+		}
+	}
+
+	// filter with the bank and the reference notch filter cascade and compare
+	void applyAndCompare(int num_samples, float offset)
+	{
+		float data[AXES][64];
+		float expected[AXES][64];
+
+		for (int axis = 0; axis < AXES; axis++) {
+			for (int n = 0; n < num_samples; n++) {
+				const float t = (_sample_index + n) / _sample_freq;
+				data[axis][n] = offset + sinf(2.f * M_PI_F * (80.f + 50.f * axis) * t) + 0.5f * sinf(2.f * M_PI_F * 210.f * t);
+				expected[axis][n] = data[axis][n];
+			}
+
+			for (int section = 0; section < NUM_SECTIONS; section++) {
+				if (_notch[section][axis].getNotchFreq() > 0.f) {
+					_notch[section][axis].applyArray(expected[axis], num_samples);
+				}
+			}
+		}
+
+		_sample_index += num_samples;
+
+		_bank.applyArray(data[0], data[1], data[2], num_samples);
+
+		for (int axis = 0; axis < AXES; axis++) {
+			for (int n = 0; n < num_samples; n++) {
+				EXPECT_NEAR(data[axis][n], expected[axis][n], 1e-5f) << "axis " << axis << " sample " << n;
+			}
+		}
+	}
+
+	BiquadFilterBank _bank;
+	NotchFilter<float> _notch[NUM_SECTIONS][AXES];
+
+	const float _sample_freq = 2000.f;
+	int _sample_index{0};
+};
+
+TEST_F(BiquadFilterBankTest, matchesNotchFilterCascade)
+{
+	// single samples, FIFO sized blocks and blocks larger than the internal block size
+	for (int num_samples : {1, 1, 8, 32, 5, 64, 17}) {
+		applyAndCompare(num_samples, 0.3f);
+	}
+}
+
+TEST_F(BiquadFilterBankTest, reset)
+{
+	applyAndCompare(32, 0.f);
+
+	// reset a section like VehicleAngularVelocity::ResetFilters() does
+	for (int axis = 0; axis < AXES; axis++) {
+		_notch[1][axis].reset();
+		copyToBank(1, axis);
+	}
+
+	applyAndCompare(32, 2.f);
+
+	// large notch frequency change forces a reset
+	_notch[0][2].setParameters(_sample_freq, 400.f, 20.f);
+	EXPECT_FALSE(_notch[0][2].initialized());
+	copyToBank(0, 2);
+
+	applyAndCompare(32, -1.f);
+}
+
+TEST_F(BiquadFilterBankTest, updateCoefficients)
+{
+	applyAndCompare(16, 0.f);
+
+	// small frequency changes keep the state
+	for (int i = 0; i < 10; i++) {
+		_notch[3][0].setParameters(_sample_freq, _notch[3][0].getNotchFreq() + 2.f, 20.f);
+		EXPECT_TRUE(_notch[3][0].initialized());
+		copyToBank(3, 0);
+
+		applyAndCompare(8, 0.f);
+	}
+
+	// enable the disabled axis and disable another one
+	_notch[2][1].setParameters(_sample_freq, 120.f, 20.f);
+	copyToBank(2, 1);
+	_notch[0][0].disable();
+	copyToBank(0, 0);
+
+	applyAndCompare(24, 0.f);
+}
+
+TEST_F(BiquadFilterBankTest, disabledPassThrough)
+{
+	BiquadFilterBank bank;
+	ASSERT_TRUE(bank.allocate(2));
+
+	const float a[3] {1.f, -1.8f, 0.9f};
+	const float b[3] {0.95f, -1.8f, 0.95f};
+	bank.setCoefficients(1, 0, a, b);
+
+	float x[4] {1.f, 2.f, 3.f, 4.f};
+	float y[4] {1.f, NAN, 3.f, 4.f};
+	float z[4] {-1.f, -2.f, -3.f, -4.f};
+
+	bank.applyArray(x, y, z, 4);
+
+	// filtered axis changed, non-finite samples in disabled axes don't affect later samples
+	EXPECT_NE(x[1], 2.f);
+	EXPECT_EQ(y[0], 1.f);
+	EXPECT_TRUE(std::isnan(y[1]));
+	EXPECT_EQ(y[2], 3.f);
+	EXPECT_EQ(y[3], 4.f);
+
+	for (int n = 0; n < 4; n++) {
+		EXPECT_EQ(z[n], -(n + 1.f));
+	}
+}
@@ -187,6 +187,27 @@ public:
 		}
 	}
 
+	// subtract the outer product u * v^T in place, without building the full product matrix
+	// (e.g. the covariance correction K * (H * P) of a scalar measurement update)
+	// rows for which u is zero are unchanged and skipped
+	void subtractOuterProduct(const Vector<Type, M> &u, const Vector<Type, M> &v)
+	{
+		SquareMatrix<Type, M> &self = *this;
+
+		// local copy, so that the compiler knows v is not modified by the update (allows vectorization)
+		const Vector<Type, M> v_copy{v};
+
+		for (size_t row = 0; row < M; row++) {
+			const Type u_row = u(row);
+
+			if (u_row != Type(0)) {
+				for (size_t col = 0; col < M; col++) {
+					self(row, col) -= u_row * v_copy(col);
+				}
+			}
+		}
+	}
+
 	// make block diagonal symmetric by taking the average of the two corresponding off diagonal values
 	template <size_t Width>
 	void makeBlockSymmetric(size_t first)
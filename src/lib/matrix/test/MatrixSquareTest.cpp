@@ -175,3 +175,25 @@ TEST(MatrixSquareTest, Square)
 	SquareMatrix<float, 4> K(data_K);
 	EXPECT_FALSE(K.isRowColSymmetric<1>(2));
 }
+
+TEST(MatrixSquareTest, SubtractOuterProduct)
+{
+	float data[9] = {4, 1, 2,
+			 1, 5, 3,
+			 2, 3, 6
+			};
+	SquareMatrix3f P(data);
+
+	const Vector3f u{1, 0, 2};
+	const Vector3f v{0.5, 1, 1.5};
+
+	// the row with u = 0 is unchanged
+	float data_check[9] = {3.5, 0, 0.5,
+			       1, 5, 3,
+			       1, 1, 3
+			      };
+	SquareMatrix3f P_check(data_check);
+
+	P.subtractOuterProduct(u, v);
+	EXPECT_EQ(P, P_check);
+}
@@ -91,6 +91,17 @@ struct perf_ctr_interval : public perf_ctr_header {
 	float			M2{0.0f};
 };
 
+/**
+ * PC_HISTOGRAM counter.
+ */
+struct perf_ctr_histogram : public perf_ctr_header {
+	uint64_t		event_count{0};
+	uint64_t		time_start{0};
+	uint64_t		time_total{0};
+	uint32_t		time_most{0};
+	uint32_t		buckets[PERF_HISTOGRAM_BUCKETS] {};
+};
+
 /**
  * List of all known counters.
  */
@@ -107,6 +118,13 @@ pthread_mutex_t perf_counters_mutex = PTHREAD_MUTEX_INITIALIZER;
 // The same holds for shared perf counters (perf_alloc_once), that can be updated
 // concurrently (this affects the 'ctrl_latency' counter).
 
+static inline unsigned
+perf_histogram_bucket(uint32_t elapsed)
+{
+	// floor(log2(elapsed)), 0 us also goes to the first bucket
+	const unsigned bucket = (elapsed > 0) ? (31 - __builtin_clz(elapsed)) : 0;
+	return (bucket < PERF_HISTOGRAM_BUCKETS) ? bucket : (PERF_HISTOGRAM_BUCKETS - 1);
+}
 
 perf_counter_t
 perf_alloc(enum perf_counter_type type, const char *name)
@@ -126,6 +144,10 @@ perf_alloc(enum perf_counter_type type, const char *name)
 		ctr = new perf_ctr_interval();
 		break;
 
+	case PC_HISTOGRAM:
+		ctr = new perf_ctr_histogram();
+		break;
+
 	default:
 		break;
 	}
@@ -217,6 +239,10 @@ perf_begin(perf_counter_t handle)
 		((struct perf_ctr_elapsed *)handle)->time_start = hrt_absolute_time();
 		break;
 
+	case PC_HISTOGRAM:
+		((struct perf_ctr_histogram *)handle)->time_start = hrt_absolute_time();
+		break;
+
 	default:
 		break;
 	}
@@ -239,6 +265,15 @@ perf_end(perf_counter_t handle)
 		}
 		break;
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			if (pch->time_start != 0) {
+				perf_set_elapsed(handle, hrt_elapsed_time(&pch->time_start));
+			}
+		}
+		break;
+
 	default:
 		break;
 	}
@@ -279,6 +314,26 @@ perf_set_elapsed(perf_counter_t handle, int64_t elapsed)
 		}
 		break;
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			if (elapsed >= 0) {
+				const uint32_t elapsed_us = (elapsed < UINT32_MAX) ? (uint32_t)elapsed : UINT32_MAX;
+
+				pch->event_count++;
+				pch->time_total += elapsed;
+
+				if (pch->time_most < elapsed_us) {
+					pch->time_most = elapsed_us;
+				}
+
+				pch->buckets[perf_histogram_bucket(elapsed_us)]++;
+
+				pch->time_start = 0;
+			}
+		}
+		break;
+
 	default:
 		break;
 	}
@@ -372,6 +427,13 @@ perf_cancel(perf_counter_t handle)
 		}
 		break;
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			pch->time_start = 0;
+		}
+		break;
+
 	default:
 		break;
 	}
@@ -409,6 +471,16 @@ perf_reset(perf_counter_t handle)
 			pci->time_most = 0;
 			break;
 		}
+
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+			pch->event_count = 0;
+			pch->time_start = 0;
+			pch->time_total = 0;
+			pch->time_most = 0;
+			memset(pch->buckets, 0, sizeof(pch->buckets));
+			break;
+		}
 	}
 }
 
@@ -455,6 +527,23 @@ perf_print_counter(perf_counter_t handle)
 			break;
 		}
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			PX4_INFO_RAW("%s: %" PRIu64 " events, %" PRIu64 "us elapsed, %.2fus avg, max %" PRIu32 "us, p50 %" PRIu32
+				     "us p90 %" PRIu32 "us p99 %" PRIu32 "us p99.9 %" PRIu32 "us\n",
+				     handle->name,
+				     pch->event_count,
+				     pch->time_total,
+				     (pch->event_count == 0) ? 0 : (double)pch->time_total / (double)pch->event_count,
+				     pch->time_most,
+				     perf_histogram_percentile(handle, 50.f),
+				     perf_histogram_percentile(handle, 90.f),
+				     perf_histogram_percentile(handle, 99.f),
+				     perf_histogram_percentile(handle, 99.9f));
+			break;
+		}
+
 	default:
 		break;
 	}
@@ -507,6 +596,24 @@ perf_print_counter_buffer(char *buffer, int length, perf_counter_t handle)
 			break;
 		}
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			num_written = snprintf(buffer, length,
+					       "%s: %" PRIu64 " events, %" PRIu64 "us elapsed, %.2fus avg, max %" PRIu32 "us, p50 %" PRIu32
+					       "us p90 %" PRIu32 "us p99 %" PRIu32 "us p99.9 %" PRIu32 "us",
+					       handle->name,
+					       pch->event_count,
+					       pch->time_total,
+					       (pch->event_count == 0) ? 0 : (double)pch->time_total / (double)pch->event_count,
+					       pch->time_most,
+					       perf_histogram_percentile(handle, 50.f),
+					       perf_histogram_percentile(handle, 90.f),
+					       perf_histogram_percentile(handle, 99.f),
+					       perf_histogram_percentile(handle, 99.9f));
+			break;
+		}
+
 	default:
 		break;
 	}
@@ -515,6 +622,25 @@ perf_print_counter_buffer(char *buffer, int length, perf_counter_t handle)
 	return num_written;
 }
 
+int
+perf_print_histogram_buffer(char *buffer, int length, perf_counter_t handle)
+{
+	if ((handle == nullptr) || (handle->type != PC_HISTOGRAM) || (length <= 0)) {
+		return 0;
+	}
+
+	struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+	int num_written = snprintf(buffer, length, "%s:", handle->name);
+
+	for (unsigned i = 0; (i < PERF_HISTOGRAM_BUCKETS) && (num_written < length); i++) {
+		num_written += snprintf(buffer + num_written, length - num_written, " %" PRIu32, pch->buckets[i]);
+	}
+
+	buffer[length - 1] = 0; // ensure 0-termination
+	return num_written;
+}
+
 uint64_t
 perf_event_count(perf_counter_t handle)
 {
@@ -536,6 +662,11 @@ perf_event_count(perf_counter_t handle)
 			return pci->event_count;
 		}
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+			return pch->event_count;
+		}
+
 	default:
 		break;
 	}
@@ -543,6 +674,51 @@ perf_event_count(perf_counter_t handle)
 	return 0;
 }
 
+void
+perf_get_values(perf_counter_t handle, struct perf_counter_values *values)
+{
+	*values = {};
+
+	if (handle == nullptr) {
+		return;
+	}
+
+	values->type = handle->type;
+	values->name = handle->name;
+
+	switch (handle->type) {
+	case PC_COUNT:
+		values->event_count = ((struct perf_ctr_count *)handle)->event_count;
+		break;
+
+	case PC_ELAPSED: {
+			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
+			values->event_count = pce->event_count;
+			values->time_total = pce->time_total;
+			values->time_most = pce->time_most;
+			break;
+		}
+
+	case PC_INTERVAL: {
+			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
+			values->event_count = pci->event_count;
+			values->time_most = pci->time_most;
+			break;
+		}
+
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+			values->event_count = pch->event_count;
+			values->time_total = pch->time_total;
+			values->time_most = pch->time_most;
+			break;
+		}
+
+	default:
+		break;
+	}
+}
+
 float
 perf_mean(perf_counter_t handle)
 {
@@ -561,6 +737,11 @@ perf_mean(perf_counter_t handle)
 			return pci->mean;
 		}
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+			return (pch->event_count == 0) ? 0.f : (pch->time_total / 1e6f) / pch->event_count;
+		}
+
 	default:
 		break;
 	}
@@ -568,6 +749,41 @@ perf_mean(perf_counter_t handle)
 	return 0.0f;
 }
 
+uint32_t
+perf_histogram_percentile(perf_counter_t handle, float percentile)
+{
+	if ((handle == nullptr) || (handle->type != PC_HISTOGRAM)) {
+		return 0;
+	}
+
+	struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+	uint64_t total = 0;
+
+	for (unsigned i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+		total += pch->buckets[i];
+	}
+
+	const uint64_t threshold = (uint64_t)ceilf(total * (percentile / 100.f));
+	uint64_t count = 0;
+
+	for (unsigned i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+		count += pch->buckets[i];
+
+		if ((count > 0) && (count >= threshold)) {
+			if (i == PERF_HISTOGRAM_BUCKETS - 1) {
+				return pch->time_most;
+			}
+
+			// the maximum is a tighter bound within the highest bucket
+			const uint32_t bucket_max = (1u << (i + 1)) - 1;
+			return (bucket_max < pch->time_most) ? bucket_max : pch->time_most;
+		}
+	}
+
+	return 0;
+}
+
 void
 perf_iterate_all(perf_callback cb, void *user)
 {
@@ -48,12 +48,30 @@
 enum perf_counter_type {
 	PC_COUNT,		/**< count the number of times an event occurs */
 	PC_ELAPSED,		/**< measure the time elapsed performing an event */
-	PC_INTERVAL		/**< measure the interval between instances of an event */
+	PC_INTERVAL,		/**< measure the interval between instances of an event */
+	PC_HISTOGRAM		/**< measure the time elapsed performing an event, with a histogram of the elapsed times */
 };
 
+/**
+ * Number of PC_HISTOGRAM buckets. Bucket i counts elapsed times of [2^i, 2^(i+1)) us,
+ * the last bucket also everything longer.
+ */
+#define PERF_HISTOGRAM_BUCKETS 20
+
 struct perf_ctr_header;
 typedef struct perf_ctr_header	*perf_counter_t;
 
+/**
+ * Counter values, see perf_get_values().
+ */
+struct perf_counter_values {
+	enum perf_counter_type	type;		/**< counter type */
+	const char		*name;		/**< counter name */
+	uint64_t		event_count;	/**< number of events */
+	uint64_t		time_total;	/**< total elapsed time in us (PC_ELAPSED, PC_HISTOGRAM) */
+	uint32_t		time_most;	/**< maximum elapsed time or interval in us (PC_ELAPSED, PC_INTERVAL, PC_HISTOGRAM) */
+};
+
 __BEGIN_DECLS
 
 /**
@@ -97,7 +115,7 @@ __EXPORT extern void		perf_count(perf_counter_t handle);
 /**
  * Begin a performance event.
  *
- * This call applies to counters that operate over ranges of time; PC_ELAPSED etc.
+ * This call applies to counters that operate over ranges of time; PC_ELAPSED, PC_HISTOGRAM etc.
  *
  * @param handle		The handle returned from perf_alloc.
  */
@@ -106,7 +124,7 @@ __EXPORT extern void		perf_begin(perf_counter_t handle);
 /**
  * End a performance event.
  *
- * This call applies to counters that operate over ranges of time; PC_ELAPSED etc.
+ * This call applies to counters that operate over ranges of time; PC_ELAPSED, PC_HISTOGRAM etc.
  * If a call is made without a corresponding perf_begin call, or if perf_cancel
  * has been called subsequently, no change is made to the counter.
  *
@@ -184,6 +202,16 @@ __EXPORT extern void		perf_print_counter(perf_counter_t handle);
  */
 __EXPORT extern int		perf_print_counter_buffer(char *buffer, int length, perf_counter_t handle);
 
+/**
+ * Print the raw histogram buckets of a PC_HISTOGRAM counter to a buffer.
+ *
+ * @param buffer			buffer to write to
+ * @param length			buffer length
+ * @param handle			The counter to print.
+ * @param return			number of bytes written, 0 if the counter is not a PC_HISTOGRAM
+ */
+__EXPORT extern int		perf_print_histogram_buffer(char *buffer, int length, perf_counter_t handle);
+
 /**
  * Print all of the performance counters.
  */
@@ -222,6 +250,14 @@ __EXPORT extern void		perf_reset_all(void);
  */
 __EXPORT extern uint64_t	perf_event_count(perf_counter_t handle);
 
+/**
+ * Get the current values of a counter
+ *
+ * @param handle		The counter returned from perf_alloc.
+ * @param values		Output values, zero if the handle is NULL.
+ */
+__EXPORT extern void		perf_get_values(perf_counter_t handle, struct perf_counter_values *values);
+
 /**
  * Return current mean
  *
@@ -230,6 +266,15 @@ __EXPORT extern uint64_t	perf_event_count(perf_counter_t handle);
  */
 __EXPORT extern float		perf_mean(perf_counter_t handle);
 
+/**
+ * Return a percentile of a PC_HISTOGRAM counter
+ *
+ * @param handle		The handle returned from perf_alloc.
+ * @param percentile		The percentile (0-100).
+ * @param return		upper bound of the histogram bucket containing the percentile in us, 0 if there are no events
+ */
+__EXPORT extern uint32_t	perf_histogram_percentile(perf_counter_t handle, float percentile);
+
 __END_DECLS
 
 #endif
@@ -0,0 +1,308 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "ULogFile.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace px4
+{
+
+static const char INDEX_FILE_MAGIC[8] = {'U', 'L', 'o', 'g', 'I', 'd', 'x', 0x01};
+
+ULogFile::~ULogFile()
+{
+	close();
+}
+
+bool
+ULogFile::open(const char *file_name)
+{
+	close();
+
+	int fd = ::open(file_name, O_RDONLY);
+
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat st;
+
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+
+	if (data == MAP_FAILED) {
+		return false;
+	}
+
+	_data = (uint8_t *)data;
+	_size = st.st_size;
+	_mtime = st.st_mtime;
+	_index_file_name = std::string(file_name) + ".index";
+
+	return true;
+}
+
+void
+ULogFile::close()
+{
+	if (_data) {
+		munmap(_data, _size);
+		_data = nullptr;
+	}
+
+	_size = 0;
+	_index_loaded_from_file = false;
+	_data_messages.clear();
+	_other_messages.clear();
+}
+
+const uint8_t *
+ULogFile::message(size_t offset, ulog_message_header_s &header) const
+{
+	const uint8_t *header_data = data(offset, ULOG_MSG_HEADER_LEN);
+
+	if (!header_data) {
+		return nullptr;
+	}
+
+	memcpy(&header, header_data, ULOG_MSG_HEADER_LEN);
+	return data(offset + ULOG_MSG_HEADER_LEN, header.msg_size);
+}
+
+bool
+ULogFile::loadOrBuildIndex(size_t data_section_start, uint64_t data_section_end, bool use_index_file)
+{
+	if (!_data || data_section_start > _size) {
+		return false;
+	}
+
+	if (data_section_end > _size) {
+		data_section_end = _size;
+	}
+
+	IndexFileHeader header{};
+	memcpy(header.magic, INDEX_FILE_MAGIC, sizeof(header.magic));
+	header.log_size = _size;
+	header.log_mtime = _mtime;
+	header.data_section_start = data_section_start;
+	header.data_section_end = data_section_end;
+
+	_index_loaded_from_file = use_index_file && loadIndex(header);
+
+	if (_index_loaded_from_file) {
+		return true;
+	}
+
+	buildIndex(data_section_start, data_section_end);
+
+	if (use_index_file) {
+		header.num_other_messages = _other_messages.size();
+		header.num_msg_ids = _data_messages.size();
+
+		// not fatal if it fails, e.g. the log directory is read-only
+		saveIndex(header);
+	}
+
+	return true;
+}
+
+void
+ULogFile::buildIndex(size_t data_section_start, size_t data_section_end)
+{
+	_data_messages.clear();
+	_other_messages.clear();
+
+	madvise(_data, _size, MADV_SEQUENTIAL);
+
+	size_t offset = data_section_start;
+
+	while (offset + ULOG_MSG_HEADER_LEN <= data_section_end) {
+		ulog_message_header_s header;
+		memcpy(&header, _data + offset, ULOG_MSG_HEADER_LEN);
+
+		if (offset + ULOG_MSG_HEADER_LEN + header.msg_size > data_section_end) {
+			break;
+		}
+
+		switch (header.msg_type) {
+		case (int)ULogMessageType::DATA:
+			if (header.msg_size >= sizeof(uint16_t)) {
+				uint16_t msg_id;
+				memcpy(&msg_id, _data + offset + ULOG_MSG_HEADER_LEN, sizeof(msg_id));
+
+				if (msg_id >= _data_messages.size()) {
+					_data_messages.resize(msg_id + 1);
+				}
+
+				_data_messages[msg_id].push_back(offset);
+			}
+
+			break;
+
+		case (int)ULogMessageType::ADD_LOGGED_MSG:
+		case (int)ULogMessageType::PARAMETER:
+		case (int)ULogMessageType::DROPOUT:
+			_other_messages.push_back(offset);
+			break;
+
+		default: // not indexed
+			break;
+		}
+
+		offset += ULOG_MSG_HEADER_LEN + header.msg_size;
+	}
+
+	// the topics are usually read in parallel streams
+	madvise(_data, _size, MADV_NORMAL);
+}
+
+bool
+ULogFile::loadIndex(const IndexFileHeader &expected_header)
+{
+	FILE *file = fopen(_index_file_name.c_str(), "rb");
+
+	if (!file) {
+		return false;
+	}
+
+	struct stat st;
+	const uint64_t index_file_size = (fstat(fileno(file), &st) == 0) ? st.st_size : 0;
+
+	IndexFileHeader header;
+	bool ret = fread(&header, sizeof(header), 1, file) == 1
+		   && memcmp(header.magic, expected_header.magic, sizeof(header.magic)) == 0
+		   && header.log_size == expected_header.log_size
+		   && header.log_mtime == expected_header.log_mtime
+		   && header.data_section_start == expected_header.data_section_start
+		   && header.data_section_end == expected_header.data_section_end
+		   && header.num_msg_ids <= UINT16_MAX + 1;
+
+	// every offset must point into the data section (protects against a corrupt or truncated index)
+	auto read_offsets = [&](std::vector<uint64_t> &offsets, uint64_t count) {
+		// a corrupt count must not allocate more than the rest of the index file can hold
+		const long position = ftell(file);
+
+		if (position < 0 || (uint64_t)position > index_file_size
+		    || count > (index_file_size - position) / sizeof(uint64_t)) {
+			return false;
+		}
+
+		offsets.resize(count);
+
+		if (count > 0 && fread(offsets.data(), sizeof(uint64_t), count, file) != count) {
+			return false;
+		}
+
+		for (uint64_t offset : offsets) {
+			if (offset < header.data_section_start || offset >= header.data_section_end) {
+				return false;
+			}
+		}
+
+		return true;
+	};
+
+	if (ret) {
+		ret = read_offsets(_other_messages, header.num_other_messages);
+	}
+
+	if (ret) {
+		_data_messages.resize(header.num_msg_ids);
+
+		for (auto &data_messages : _data_messages) {
+			uint64_t count;
+
+			if (fread(&count, sizeof(count), 1, file) != 1 || !read_offsets(data_messages, count)) {
+				ret = false;
+				break;
+			}
+		}
+	}
+
+	fclose(file);
+
+	if (!ret) {
+		_data_messages.clear();
+		_other_messages.clear();
+	}
+
+	return ret;
+}
+
+bool
+ULogFile::saveIndex(const IndexFileHeader &header) const
+{
+	// write to a temporary file first, so that a concurrent reader never sees a partial index.
+	// The name is unique per process, as several replays of the same log can build the index at the same time.
+	const std::string tmp_file_name = _index_file_name + "." + std::to_string(getpid()) + ".tmp";
+	FILE *file = fopen(tmp_file_name.c_str(), "wb");
+
+	if (!file) {
+		return false;
+	}
+
+	bool ret = fwrite(&header, sizeof(header), 1, file) == 1;
+
+	auto write_offsets = [file](const std::vector<uint64_t> &offsets) {
+		return offsets.empty() || fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size();
+	};
+
+	ret = ret && write_offsets(_other_messages);
+
+	for (const auto &data_messages : _data_messages) {
+		const uint64_t count = data_messages.size();
+		ret = ret && fwrite(&count, sizeof(count), 1, file) == 1 && write_offsets(data_messages);
+	}
+
+	ret = (fclose(file) == 0) && ret;
+
+	if (!ret || rename(tmp_file_name.c_str(), _index_file_name.c_str()) != 0) {
+		unlink(tmp_file_name.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+} //namespace px4
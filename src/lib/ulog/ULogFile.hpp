@@ -0,0 +1,158 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <logger/messages.h>
+
+namespace px4
+{
+
+/**
+ * @class ULogFile
+ * Read-only, memory-mapped ULog file with an index of its data section.
+ *
+ * The index stores the file offsets of all data messages per msg_id, and of the other messages a
+ * reader has to handle in file order (subscriptions, parameter updates and dropouts). It is built
+ * with a single pass over the data section and can be cached in a sidecar file next to the log
+ * (<log file>.index), so that reading the same log again does not need to scan it.
+ *
+ * An indexed file is not modified anymore and can be shared between threads.
+ */
+class ULogFile
+{
+public:
+	ULogFile() = default;
+	~ULogFile();
+
+	ULogFile(const ULogFile &) = delete;
+	ULogFile &operator=(const ULogFile &) = delete;
+
+	/**
+	 * Map a file into memory
+	 * @return true on success
+	 */
+	bool open(const char *file_name);
+
+	void close();
+
+	bool isOpen() const { return _data != nullptr; }
+
+	size_t size() const { return _size; }
+
+	/**
+	 * Get a pointer to a range of the file
+	 * @return nullptr if the range exceeds the file
+	 */
+	const uint8_t *data(size_t offset, size_t length) const
+	{
+		if (offset > _size || length > _size - offset) {
+			return nullptr;
+		}
+
+		return _data + offset;
+	}
+
+	/**
+	 * Get a message at a file offset
+	 * @param offset file offset of the message header
+	 * @param header returned message header
+	 * @return pointer to the message payload, nullptr if the message exceeds the file
+	 */
+	const uint8_t *message(size_t offset, ulog_message_header_s &header) const;
+
+	/**
+	 * Load the index of the data section from the sidecar file, or build it and try to store the sidecar file.
+	 * @param data_section_start file offset of the first message after the definitions section
+	 * @param data_section_end messages ending after this offset are not indexed (e.g. appended data)
+	 * @param use_index_file false to always build the index and not write the sidecar file
+	 * @return true on success
+	 */
+	bool loadOrBuildIndex(size_t data_section_start, uint64_t data_section_end, bool use_index_file = true);
+
+	/**
+	 * @return true if the index was loaded from the sidecar file
+	 */
+	bool indexLoadedFromFile() const { return _index_loaded_from_file; }
+
+	const std::string &indexFileName() const { return _index_file_name; }
+
+	/**
+	 * File offsets of the data messages with a given msg_id, in file order
+	 */
+	const std::vector<uint64_t> &dataMessages(uint16_t msg_id) const
+	{
+		return msg_id < _data_messages.size() ? _data_messages[msg_id] : _empty;
+	}
+
+	/**
+	 * File offsets of the ADD_LOGGED_MSG, PARAMETER and DROPOUT messages in the data section, in file order
+	 */
+	const std::vector<uint64_t> &otherMessages() const { return _other_messages; }
+
+private:
+	/**
+	 * Header of the index sidecar file. It is followed by the offsets of the other messages, then for each
+	 * msg_id the number of data messages and their offsets (all uint64_t).
+	 */
+	struct IndexFileHeader {
+		char magic[8];
+		uint64_t log_size;
+		uint64_t log_mtime;
+		uint64_t data_section_start;
+		uint64_t data_section_end;
+		uint64_t num_other_messages;
+		uint64_t num_msg_ids;
+	};
+
+	void buildIndex(size_t data_section_start, size_t data_section_end);
+	bool loadIndex(const IndexFileHeader &expected_header);
+	bool saveIndex(const IndexFileHeader &header) const;
+
+	uint8_t *_data{nullptr};
+	size_t _size{0};
+	uint64_t _mtime{0};
+	std::string _index_file_name;
+	bool _index_loaded_from_file{false};
+
+	std::vector<std::vector<uint64_t>> _data_messages; ///< data message offsets, indexed by msg_id
+	std::vector<uint64_t> _other_messages;
+	const std::vector<uint64_t> _empty;
+};
+
+} //namespace px4
@@ -486,14 +486,14 @@ void Ekf::fixCovarianceErrors(bool force_symmetry)
 	}
 }
 
-// if the covariance correction will result in a negative variance, then
+// if the covariance correction KHP = K * HP will result in a negative variance, then
 // the covariance matrix is unhealthy and must be corrected
-bool Ekf::checkAndFixCovarianceUpdate(const SquareMatrix24f &KHP)
+bool Ekf::checkAndFixCovarianceUpdate(const Vector24f &K, const Vector24f &HP)
 {
 	bool healthy = true;
 
 	for (int i = 0; i < _k_num_states; i++) {
-		if (P(i, i) < KHP(i, i)) {
+		if (P(i, i) < K(i) * HP(i)) {
 			P.uncorrelateCovarianceSetVariance<1>(i, 0.0f);
 			healthy = false;
 		}
@@ -784,22 +784,15 @@ private:
 			}
 		}
 
+		// Instead of literally computing KHP, use an equivalent
+		// equation involving less mathematical operations: KHP = KS * K^T
 		const Vector24f KS = K * innovation_variance;
-		SquareMatrix24f KHP;
 
-		for (unsigned row = 0; row < _k_num_states; row++) {
-			for (unsigned col = 0; col < _k_num_states; col++) {
-				// Instad of literally computing KHP, use an equvalent
-				// equation involving less mathematical operations
-				KHP(row, col) = KS(row) * K(col);
-			}
-		}
-
-		const bool is_healthy = checkAndFixCovarianceUpdate(KHP);
+		const bool is_healthy = checkAndFixCovarianceUpdate(KS, K);
 
 		if (is_healthy) {
-			// apply the covariance corrections
-			P -= KHP;
+			// apply the covariance corrections (in place, states with zero gain are skipped)
+			P.subtractOuterProduct(KS, K);
 
 			fixCovarianceErrors(true);
 
@@ -810,9 +803,9 @@ private:
 		return is_healthy;
 	}
 
-	// if the covariance correction will result in a negative variance, then
+	// if the covariance correction KHP = K * HP will result in a negative variance, then
 	// the covariance matrix is unhealthy and must be corrected
-	bool checkAndFixCovarianceUpdate(const SquareMatrix24f &KHP);
+	bool checkAndFixCovarianceUpdate(const Vector24f &K, const Vector24f &HP);
 
 	// limit the diagonal of the covariance matrix
 	// force symmetry when the argument is true
@@ -206,21 +206,21 @@ bool Ekf::fuseVelPosHeight(const float innov, const float innov_var, const int o
 		}
 	}
 
-	SquareMatrix24f KHP;
+	// H is zero except for the observed state, so H * P is a row of P
+	// (copied, as P is updated in place)
+	Vector24f HP;
 
-	for (unsigned row = 0; row < _k_num_states; row++) {
-		for (unsigned column = 0; column < _k_num_states; column++) {
-			KHP(row, column) = Kfusion(row) * P(state_index, column);
-		}
+	for (unsigned column = 0; column < _k_num_states; column++) {
+		HP(column) = P(state_index, column);
 	}
 
-	const bool healthy = checkAndFixCovarianceUpdate(KHP);
+	const bool healthy = checkAndFixCovarianceUpdate(Kfusion, HP);
 
 	setVelPosStatus(obs_index, healthy);
 
 	if (healthy) {
-		// apply the covariance corrections
-		P -= KHP;
+		// apply the covariance corrections KHP = K * HP (in place, states with zero gain are skipped)
+		P.subtractOuterProduct(Kfusion, HP);
 
 		fixCovarianceErrors(true);
 
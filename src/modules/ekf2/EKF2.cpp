@@ -192,6 +192,7 @@ EKF2::~EKF2()
 {
 	perf_free(_ecl_ekf_update_perf);
 	perf_free(_ecl_ekf_update_full_perf);
+	perf_free(_output_latency_perf);
 	perf_free(_msg_missed_imu_perf);
 	perf_free(_msg_missed_air_data_perf);
 	perf_free(_msg_missed_airspeed_perf);
@@ -303,6 +304,7 @@ int EKF2::print_status()
 
 	perf_print_counter(_ecl_ekf_update_perf);
 	perf_print_counter(_ecl_ekf_update_full_perf);
+	perf_print_counter(_output_latency_perf);
 	perf_print_counter(_msg_missed_imu_perf);
 	perf_print_counter(_msg_missed_air_data_perf);
 	perf_print_counter(_msg_missed_airspeed_perf);
@@ -637,6 +639,11 @@ void EKF2::Run()
 
 		// publish ekf2_timestamps
 		_ekf2_timestamps_pub.publish(ekf2_timestamps);
+
+		if (!_replay_mode) {
+			// time from the IMU sample to the published estimate
+			perf_set_elapsed(_output_latency_perf, hrt_elapsed_time(&imu_sample_new.time_us));
+		}
 	}
 
 	// re-schedule as backup timeout
@@ -2256,6 +2263,23 @@ int EKF2::custom_command(int argc, char *argv[])
 	return print_usage("unknown command");
 }
 
+#if !defined(CONSTRAINED_FLASH)
+// the CPU of a Multi-EKF instance: the instances are distributed round robin over the CPUs in the mask
+static uint32_t multi_cpu_affinity(uint32_t cpu_mask, int index)
+{
+	const int num_cpus = __builtin_popcount(cpu_mask);
+	int cpu_index = index % num_cpus;
+
+	for (int cpu = 0; cpu < 32; cpu++) {
+		if ((cpu_mask & (1u << cpu)) && (cpu_index-- == 0)) {
+			return 1u << cpu;
+		}
+	}
+
+	return 0;
+}
+#endif // !CONSTRAINED_FLASH
+
 int EKF2::task_spawn(int argc, char *argv[])
 {
 	bool success = false;
@@ -2271,6 +2295,9 @@ int EKF2::task_spawn(int argc, char *argv[])
 	int32_t imu_instances = 0;
 	int32_t mag_instances = 0;
 
+	int32_t multi_wq = 0;
+	int32_t multi_cpu_mask = 0;
+
 	int32_t sens_imu_mode = 1;
 	param_get(param_find("SENS_IMU_MODE"), &sens_imu_mode);
 
@@ -2317,6 +2344,9 @@ int EKF2::task_spawn(int argc, char *argv[])
 		} else {
 			mag_instances = 1;
 		}
+
+		param_get(param_find("EKF2_MULTI_WQ"), &multi_wq);
+		param_get(param_find("EKF2_MULTI_CPU"), &multi_cpu_mask);
 	}
 
 	if (multi_mode && !replay_mode) {
@@ -2361,7 +2391,11 @@ int EKF2::task_spawn(int argc, char *argv[])
 					if ((vehicle_mag_sub.advertised() || mag == 0) && (vehicle_imu_sub.advertised())) {
 
 						if (!ekf2_instance_created[imu][mag]) {
-							EKF2 *ekf2_inst = new EKF2(true, px4::ins_instance_to_wq(imu), false);
+							// either a dedicated work queue per instance, or shared by all instances of an IMU
+							const px4::wq_config_t &wq_config = multi_wq ? px4::ekf_instance_to_wq(multi_instances_allocated)
+											    : px4::ins_instance_to_wq(imu);
+
+							EKF2 *ekf2_inst = new EKF2(true, wq_config, false);
 
 							if (ekf2_inst && ekf2_inst->multi_init(imu, mag)) {
 								int actual_instance = ekf2_inst->instance(); // match uORB instance numbering
@@ -2376,6 +2410,14 @@ int EKF2::task_spawn(int argc, char *argv[])
 										  imu, vehicle_imu_sub.get().accel_device_id,
 										  mag, vehicle_mag_sub.get().device_id);
 
+									if (multi_wq && (multi_cpu_mask != 0)) {
+										const uint32_t cpu_mask = multi_cpu_affinity(multi_cpu_mask, multi_instances_allocated - 1);
+
+										if (px4::WorkQueueSetCpuAffinity(wq_config, cpu_mask) != PX4_OK) {
+											PX4_WARN("CPU affinity not supported (%s)", wq_config.name);
+										}
+									}
+
 									_ekf2_selector.load()->ScheduleNow();
 
 								} else {
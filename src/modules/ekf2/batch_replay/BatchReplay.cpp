@@ -0,0 +1,625 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "BatchReplay.hpp"
+
+#include "EKF/ekf.h"
+
+#include <uORB/topics/sensor_combined.h>
+#include <uORB/topics/vehicle_status.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <sstream>
+
+namespace
+{
+
+template<typename T>
+T readField(const uint8_t *payload, uint16_t payload_size, const ULogIndex::Field &field, T fallback = T{})
+{
+	if (!field.valid() || (field.offset + (int)sizeof(T) > payload_size)) {
+		return fallback;
+	}
+
+	T value;
+	memcpy(&value, payload + field.offset, sizeof(T));
+	return value;
+}
+
+matrix::Vector3f readVector3f(const uint8_t *payload, uint16_t payload_size, const ULogIndex::Field &field)
+{
+	float v[3] {NAN, NAN, NAN};
+
+	if (field.valid() && (field.offset + (int)sizeof(v) <= payload_size)) {
+		memcpy(v, payload + field.offset, sizeof(v));
+	}
+
+	return matrix::Vector3f{v};
+}
+
+/**
+ * Set an EKF2_* parameter in the Ekf parameter struct. This is the same mapping as in the EKF2 module.
+ * @return false if the parameter is not used by the Ekf
+ */
+bool setEkfParameter(parameters &p, const std::string &name, float value)
+{
+	struct Entry {
+		Entry(const char *n, float *f) : name(n), value_float(f) {}
+		Entry(const char *n, int32_t *i) : name(n), value_int(i) {}
+
+		const char *name;
+		float *value_float{nullptr};
+		int32_t *value_int{nullptr};
+	};
+
+	const Entry table[] {
+		{"EKF2_PREDICT_US", &p.filter_update_interval_us},
+		{"EKF2_MAG_DELAY", &p.mag_delay_ms},
+		{"EKF2_BARO_DELAY", &p.baro_delay_ms},
+		{"EKF2_GPS_DELAY", &p.gps_delay_ms},
+		{"EKF2_OF_DELAY", &p.flow_delay_ms},
+		{"EKF2_RNG_DELAY", &p.range_delay_ms},
+		{"EKF2_ASP_DELAY", &p.airspeed_delay_ms},
+		{"EKF2_EV_DELAY", &p.ev_delay_ms},
+		{"EKF2_AVEL_DELAY", &p.auxvel_delay_ms},
+		{"EKF2_GYR_NOISE", &p.gyro_noise},
+		{"EKF2_ACC_NOISE", &p.accel_noise},
+		{"EKF2_GYR_B_NOISE", &p.gyro_bias_p_noise},
+		{"EKF2_ACC_B_NOISE", &p.accel_bias_p_noise},
+		{"EKF2_MAG_E_NOISE", &p.mage_p_noise},
+		{"EKF2_MAG_B_NOISE", &p.magb_p_noise},
+		{"EKF2_WIND_NSD", &p.wind_vel_nsd},
+		{"EKF2_TERR_NOISE", &p.terrain_p_noise},
+		{"EKF2_TERR_GRAD", &p.terrain_gradient},
+		{"EKF2_GPS_V_NOISE", &p.gps_vel_noise},
+		{"EKF2_GPS_P_NOISE", &p.gps_pos_noise},
+		{"EKF2_NOAID_NOISE", &p.pos_noaid_noise},
+		{"EKF2_BARO_NOISE", &p.baro_noise},
+		{"EKF2_BARO_GATE", &p.baro_innov_gate},
+		{"EKF2_GND_EFF_DZ", &p.gnd_effect_deadzone},
+		{"EKF2_GND_MAX_HGT", &p.gnd_effect_max_hgt},
+		{"EKF2_GPS_P_GATE", &p.gps_pos_innov_gate},
+		{"EKF2_GPS_V_GATE", &p.gps_vel_innov_gate},
+		{"EKF2_TAS_GATE", &p.tas_innov_gate},
+		{"EKF2_HEAD_NOISE", &p.mag_heading_noise},
+		{"EKF2_MAG_NOISE", &p.mag_noise},
+		{"EKF2_EAS_NOISE", &p.eas_noise},
+		{"EKF2_BETA_GATE", &p.beta_innov_gate},
+		{"EKF2_BETA_NOISE", &p.beta_noise},
+		{"EKF2_MAG_DECL", &p.mag_declination_deg},
+		{"EKF2_HDG_GATE", &p.heading_innov_gate},
+		{"EKF2_MAG_GATE", &p.mag_innov_gate},
+		{"EKF2_DECL_TYPE", &p.mag_declination_source},
+		{"EKF2_MAG_TYPE", &p.mag_fusion_type},
+		{"EKF2_MAG_ACCLIM", &p.mag_acc_gate},
+		{"EKF2_MAG_YAWLIM", &p.mag_yaw_rate_gate},
+		{"EKF2_GPS_CHECK", &p.gps_check_mask},
+		{"EKF2_REQ_EPH", &p.req_hacc},
+		{"EKF2_REQ_EPV", &p.req_vacc},
+		{"EKF2_REQ_SACC", &p.req_sacc},
+		{"EKF2_REQ_NSATS", &p.req_nsats},
+		{"EKF2_REQ_PDOP", &p.req_pdop},
+		{"EKF2_REQ_HDRIFT", &p.req_hdrift},
+		{"EKF2_REQ_VDRIFT", &p.req_vdrift},
+		{"EKF2_AID_MASK", &p.fusion_mode},
+		{"EKF2_HGT_REF", &p.height_sensor_ref},
+		{"EKF2_BARO_CTRL", &p.baro_ctrl},
+		{"EKF2_GPS_CTRL", &p.gnss_ctrl},
+		{"EKF2_RNG_CTRL", &p.rng_ctrl},
+		{"EKF2_TERR_MASK", &p.terrain_fusion_mode},
+		{"EKF2_NOAID_TOUT", &p.valid_timeout_max},
+		{"EKF2_RNG_NOISE", &p.range_noise},
+		{"EKF2_RNG_SFE", &p.range_noise_scaler},
+		{"EKF2_RNG_GATE", &p.range_innov_gate},
+		{"EKF2_MIN_RNG", &p.rng_gnd_clearance},
+		{"EKF2_RNG_PITCH", &p.rng_sens_pitch},
+		{"EKF2_RNG_A_VMAX", &p.max_vel_for_range_aid},
+		{"EKF2_RNG_A_HMAX", &p.max_hagl_for_range_aid},
+		{"EKF2_RNG_A_IGATE", &p.range_aid_innov_gate},
+		{"EKF2_RNG_QLTY_T", &p.range_valid_quality_s},
+		{"EKF2_RNG_K_GATE", &p.range_kin_consistency_gate},
+		{"EKF2_EV_CTRL", &p.ev_ctrl},
+		{"EKF2_EV_QMIN", &p.ev_quality_minimum},
+		{"EKF2_EVP_NOISE", &p.ev_pos_noise},
+		{"EKF2_EVV_NOISE", &p.ev_vel_noise},
+		{"EKF2_EVA_NOISE", &p.ev_att_noise},
+		{"EKF2_EVV_GATE", &p.ev_vel_innov_gate},
+		{"EKF2_EVP_GATE", &p.ev_pos_innov_gate},
+		{"EKF2_OF_N_MIN", &p.flow_noise},
+		{"EKF2_OF_N_MAX", &p.flow_noise_qual_min},
+		{"EKF2_OF_QMIN", &p.flow_qual_min},
+		{"EKF2_OF_GATE", &p.flow_innov_gate},
+		{"EKF2_IMU_POS_X", &p.imu_pos_body(0)},
+		{"EKF2_IMU_POS_Y", &p.imu_pos_body(1)},
+		{"EKF2_IMU_POS_Z", &p.imu_pos_body(2)},
+		{"EKF2_GPS_POS_X", &p.gps_pos_body(0)},
+		{"EKF2_GPS_POS_Y", &p.gps_pos_body(1)},
+		{"EKF2_GPS_POS_Z", &p.gps_pos_body(2)},
+		{"EKF2_RNG_POS_X", &p.rng_pos_body(0)},
+		{"EKF2_RNG_POS_Y", &p.rng_pos_body(1)},
+		{"EKF2_RNG_POS_Z", &p.rng_pos_body(2)},
+		{"EKF2_OF_POS_X", &p.flow_pos_body(0)},
+		{"EKF2_OF_POS_Y", &p.flow_pos_body(1)},
+		{"EKF2_OF_POS_Z", &p.flow_pos_body(2)},
+		{"EKF2_EV_POS_X", &p.ev_pos_body(0)},
+		{"EKF2_EV_POS_Y", &p.ev_pos_body(1)},
+		{"EKF2_EV_POS_Z", &p.ev_pos_body(2)},
+		{"EKF2_ARSP_THR", &p.arsp_thr},
+		{"EKF2_FUSE_BETA", &p.beta_fusion_enabled},
+		{"EKF2_TAU_VEL", &p.vel_Tau},
+		{"EKF2_TAU_POS", &p.pos_Tau},
+		{"EKF2_GBIAS_INIT", &p.switch_on_gyro_bias},
+		{"EKF2_ABIAS_INIT", &p.switch_on_accel_bias},
+		{"EKF2_ANGERR_INIT", &p.initial_tilt_err},
+		{"EKF2_ABL_LIM", &p.acc_bias_lim},
+		{"EKF2_ABL_ACCLIM", &p.acc_bias_learn_acc_lim},
+		{"EKF2_ABL_GYRLIM", &p.acc_bias_learn_gyr_lim},
+		{"EKF2_ABL_TAU", &p.acc_bias_learn_tc},
+		{"EKF2_DRAG_NOISE", &p.drag_noise},
+		{"EKF2_BCOEF_X", &p.bcoef_x},
+		{"EKF2_BCOEF_Y", &p.bcoef_y},
+		{"EKF2_MCOEF", &p.mcoef},
+		{"EKF2_ASPD_MAX", &p.max_correction_airspeed},
+		{"EKF2_PCOEF_XP", &p.static_pressure_coef_xp},
+		{"EKF2_PCOEF_XN", &p.static_pressure_coef_xn},
+		{"EKF2_PCOEF_YP", &p.static_pressure_coef_yp},
+		{"EKF2_PCOEF_YN", &p.static_pressure_coef_yn},
+		{"EKF2_PCOEF_Z", &p.static_pressure_coef_z},
+		{"EKF2_MAG_CHECK", &p.check_mag_strength},
+		{"EKF2_SYNT_MAG_Z", &p.synthesize_mag_z},
+		{"EKF2_GSF_TAS", &p.EKFGSF_tas_default},
+	};
+
+	for (const Entry &entry : table) {
+		if (name == entry.name) {
+			if (entry.value_float) {
+				*entry.value_float = value;
+
+			} else {
+				*entry.value_int = (int32_t)lroundf(value);
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+} // namespace
+
+void BatchReplay::RatioStatistics::update(float ratio)
+{
+	// inactive sources report NaN or 0
+	if (!std::isfinite(ratio) || !(ratio > 0.f)) {
+		return;
+	}
+
+	count++;
+	sum += ratio;
+
+	if (ratio > max) {
+		max = ratio;
+	}
+
+	if (ratio > 1.f) {
+		exceeded++;
+	}
+}
+
+bool BatchReplay::init(std::string &error)
+{
+	_imu.topic = _log.findTopic("sensor_combined");
+
+	if (!_imu.topic) {
+		error = "sensor_combined not logged";
+		return false;
+	}
+
+	const char *imu_name = _imu.topic->name.c_str();
+	_imu.gyro_rad = _log.findField(imu_name, "gyro_rad");
+	_imu.gyro_integral_dt = _log.findField(imu_name, "gyro_integral_dt");
+	_imu.accelerometer_m_s2 = _log.findField(imu_name, "accelerometer_m_s2");
+	_imu.accelerometer_integral_dt = _log.findField(imu_name, "accelerometer_integral_dt");
+	_imu.accelerometer_clipping = _log.findField(imu_name, "accelerometer_clipping");
+
+	if (!_imu.gyro_rad.valid() || !_imu.gyro_integral_dt.valid()
+	    || !_imu.accelerometer_m_s2.valid() || !_imu.accelerometer_integral_dt.valid()) {
+		error = "unsupported sensor_combined format";
+		return false;
+	}
+
+	_baro.topic = _log.findTopic("vehicle_air_data");
+
+	if (_baro.topic) {
+		const char *name = _baro.topic->name.c_str();
+		_baro.timestamp_sample = _log.findField(name, "timestamp_sample");
+		_baro.baro_device_id = _log.findField(name, "baro_device_id");
+		_baro.baro_alt_meter = _log.findField(name, "baro_alt_meter");
+		_baro.rho = _log.findField(name, "rho");
+		_baro.calibration_count = _log.findField(name, "calibration_count");
+	}
+
+	_gps.topic = _log.findTopic("vehicle_gps_position");
+
+	if (_gps.topic) {
+		const char *name = _gps.topic->name.c_str();
+		_gps.lat = _log.findField(name, "lat");
+		_gps.lon = _log.findField(name, "lon");
+		_gps.alt = _log.findField(name, "alt");
+		_gps.heading = _log.findField(name, "heading");
+		_gps.heading_offset = _log.findField(name, "heading_offset");
+		_gps.heading_accuracy = _log.findField(name, "heading_accuracy");
+		_gps.fix_type = _log.findField(name, "fix_type");
+		_gps.eph = _log.findField(name, "eph");
+		_gps.epv = _log.findField(name, "epv");
+		_gps.s_variance_m_s = _log.findField(name, "s_variance_m_s");
+		_gps.vel_m_s = _log.findField(name, "vel_m_s");
+		_gps.vel_n_m_s = _log.findField(name, "vel_n_m_s");
+		_gps.vel_e_m_s = _log.findField(name, "vel_e_m_s");
+		_gps.vel_d_m_s = _log.findField(name, "vel_d_m_s");
+		_gps.vel_ned_valid = _log.findField(name, "vel_ned_valid");
+		_gps.satellites_used = _log.findField(name, "satellites_used");
+		_gps.hdop = _log.findField(name, "hdop");
+		_gps.vdop = _log.findField(name, "vdop");
+	}
+
+	_mag.topic = _log.findTopic("vehicle_magnetometer");
+
+	if (_mag.topic) {
+		const char *name = _mag.topic->name.c_str();
+		_mag.timestamp_sample = _log.findField(name, "timestamp_sample");
+		_mag.device_id = _log.findField(name, "device_id");
+		_mag.magnetometer_ga = _log.findField(name, "magnetometer_ga");
+		_mag.calibration_count = _log.findField(name, "calibration_count");
+	}
+
+	_airspeed.topic = _log.findTopic("airspeed_validated");
+
+	if (_airspeed.topic) {
+		const char *name = _airspeed.topic->name.c_str();
+		_airspeed.true_airspeed_m_s = _log.findField(name, "true_airspeed_m_s");
+		_airspeed.calibrated_airspeed_m_s = _log.findField(name, "calibrated_airspeed_m_s");
+		_airspeed.selected_airspeed_index = _log.findField(name, "selected_airspeed_index");
+	}
+
+	_land_detected.topic = _log.findTopic("vehicle_land_detected");
+
+	if (_land_detected.topic) {
+		const char *name = _land_detected.topic->name.c_str();
+		_land_detected.landed = _log.findField(name, "landed");
+		_land_detected.at_rest = _log.findField(name, "at_rest");
+		_land_detected.in_ground_effect = _log.findField(name, "in_ground_effect");
+	}
+
+	_status.topic = _log.findTopic("vehicle_status");
+
+	if (_status.topic) {
+		const char *name = _status.topic->name.c_str();
+		_status.arming_state = _log.findField(name, "arming_state");
+		_status.vehicle_type = _log.findField(name, "vehicle_type");
+	}
+
+	return true;
+}
+
+BatchReplay::Summary BatchReplay::run(const ParameterSet &parameter_set) const
+{
+	Summary summary{};
+	const auto wall_time_start = std::chrono::steady_clock::now();
+
+	// the Ekf is large, keep it off the (thread) stack
+	std::unique_ptr<Ekf> ekf = std::make_unique<Ekf>();
+	parameters &params = *ekf->getParamHandle();
+
+	// start with the parameters of the logged flight
+	float req_gps_health_time_s = 10.f;
+	float sens_baro_rate = 0.f;
+	float sens_mag_rate = 0.f;
+
+	for (const auto &logged : _log.parameters()) {
+		const std::string &name = logged.first;
+		const float value = logged.second.is_int ? (float)logged.second.value_int : logged.second.value_float;
+
+		if (name == "EKF2_REQ_GPS_H") {
+			req_gps_health_time_s = value;
+
+		} else if (name == "SENS_BARO_RATE") {
+			sens_baro_rate = value;
+
+		} else if (name == "SENS_MAG_RATE") {
+			sens_mag_rate = value;
+
+		} else if (name.compare(0, 5, "EKF2_") == 0) {
+			setEkfParameter(params, name, value);
+		}
+	}
+
+	for (const ParameterOverride &parameter : parameter_set) {
+		if (parameter.name == "EKF2_REQ_GPS_H") {
+			req_gps_health_time_s = parameter.value;
+
+		} else if (!setEkfParameter(params, parameter.name, parameter.value)) {
+			summary.error = "unsupported parameter " + parameter.name;
+			return summary;
+		}
+	}
+
+	ekf->set_min_required_gps_health_time(req_gps_health_time_s * 1e6f);
+
+	// same as the EKF2 module: the observation buffers must accommodate the averaged baro and mag output
+	if (params.baro_ctrl == 1 && sens_baro_rate > 0.f) {
+		params.sensor_interval_max_ms = math::max(params.sensor_interval_max_ms, (int32_t)roundf(1000.f / sens_baro_rate));
+	}
+
+	if (params.mag_fusion_type != MagFuseType::NONE && sens_mag_rate > 0.f) {
+		params.sensor_interval_max_ms = math::max(params.sensor_interval_max_ms, (int32_t)roundf(1000.f / sens_mag_rate));
+	}
+
+	enum Source {
+		IMU = 0,
+		BARO,
+		GPS,
+		MAG,
+		AIRSPEED,
+		LAND_DETECTED,
+		STATUS,
+		NUM_SOURCES
+	};
+
+	const ULogIndex::Topic *topics[NUM_SOURCES] {
+		_imu.topic, _baro.topic, _gps.topic, _mag.topic, _airspeed.topic, _land_detected.topic, _status.topic
+	};
+
+	size_t cursor[NUM_SOURCES] {};
+
+	uint32_t baro_device_id = 0;
+	uint8_t baro_calibration_count = 0;
+	uint32_t mag_device_id = 0;
+	uint8_t mag_calibration_count = 0;
+
+	systemFlagUpdate system_flags{};
+	bool system_flags_updated = false;
+
+	uint64_t first_imu_timestamp = 0;
+	uint64_t last_imu_timestamp = 0;
+
+	while (true) {
+		// merge the topics in order of publication
+		int source = -1;
+		uint64_t timestamp = UINT64_MAX;
+
+		for (int i = 0; i < NUM_SOURCES; i++) {
+			if (topics[i] && (cursor[i] < topics[i]->size()) && (topics[i]->timestamps[cursor[i]] < timestamp)) {
+				source = i;
+				timestamp = topics[i]->timestamps[cursor[i]];
+			}
+		}
+
+		if (source < 0) {
+			break;
+		}
+
+		const ULogIndex::Topic &topic = *topics[source];
+		const uint8_t *payload = _log.payload(topic, cursor[source]);
+		const uint16_t size = topic.payload_sizes[cursor[source]];
+		cursor[source]++;
+
+		if (timestamp == 0 || (source != IMU && first_imu_timestamp == 0)) {
+			// the Ekf is initialised by the first IMU sample
+			continue;
+		}
+
+		switch (source) {
+		case IMU: {
+				imuSample imu_sample{};
+				imu_sample.time_us = timestamp;
+				imu_sample.delta_ang_dt = readField<uint32_t>(payload, size, _imu.gyro_integral_dt) * 1.e-6f;
+				imu_sample.delta_ang = readVector3f(payload, size, _imu.gyro_rad) * imu_sample.delta_ang_dt;
+				imu_sample.delta_vel_dt = readField<uint32_t>(payload, size, _imu.accelerometer_integral_dt) * 1.e-6f;
+				imu_sample.delta_vel = readVector3f(payload, size, _imu.accelerometer_m_s2) * imu_sample.delta_vel_dt;
+
+				const uint8_t clipping = readField<uint8_t>(payload, size, _imu.accelerometer_clipping);
+				imu_sample.delta_vel_clipping[0] = clipping & sensor_combined_s::CLIPPING_X;
+				imu_sample.delta_vel_clipping[1] = clipping & sensor_combined_s::CLIPPING_Y;
+				imu_sample.delta_vel_clipping[2] = clipping & sensor_combined_s::CLIPPING_Z;
+
+				if (system_flags_updated) {
+					system_flags.time_us = timestamp;
+					ekf->setSystemFlagData(system_flags);
+					system_flags_updated = false;
+				}
+
+				ekf->setIMUData(imu_sample);
+				summary.imu_samples++;
+
+				if (first_imu_timestamp == 0) {
+					first_imu_timestamp = timestamp;
+				}
+
+				last_imu_timestamp = timestamp;
+
+				if (ekf->update()) {
+					summary.filter_updates++;
+
+					uint16_t innovation_status;
+					float mag, vel, pos, hgt, tas, hagl, beta;
+					ekf->get_innovation_test_status(innovation_status, mag, vel, pos, hgt, tas, hagl, beta);
+
+					summary.mag.update(mag);
+					summary.vel.update(vel);
+					summary.pos.update(pos);
+					summary.hgt.update(hgt);
+					summary.tas.update(tas);
+					summary.hagl.update(hagl);
+					summary.beta.update(beta);
+
+					if (innovation_status != 0) {
+						summary.innovation_fault_updates++;
+					}
+				}
+			}
+			break;
+
+		case BARO: {
+				const uint32_t device_id = readField<uint32_t>(payload, size, _baro.baro_device_id);
+				const uint8_t calibration_count = readField<uint8_t>(payload, size, _baro.calibration_count);
+				const bool reset = (device_id != baro_device_id) || (calibration_count != baro_calibration_count);
+				baro_device_id = device_id;
+				baro_calibration_count = calibration_count;
+
+				const float rho = readField<float>(payload, size, _baro.rho, NAN);
+
+				if (std::isfinite(rho)) {
+					ekf->set_air_density(rho);
+				}
+
+				ekf->setBaroData(baroSample{readField<uint64_t>(payload, size, _baro.timestamp_sample, timestamp),
+							    readField<float>(payload, size, _baro.baro_alt_meter, NAN), reset});
+			}
+			break;
+
+		case GPS: {
+				const float hdop = readField<float>(payload, size, _gps.hdop);
+				const float vdop = readField<float>(payload, size, _gps.vdop);
+
+				gpsMessage gps_msg{
+					.time_usec = timestamp,
+					.lat = readField<int32_t>(payload, size, _gps.lat),
+					.lon = readField<int32_t>(payload, size, _gps.lon),
+					.alt = readField<int32_t>(payload, size, _gps.alt),
+					.yaw = readField<float>(payload, size, _gps.heading, NAN),
+					.yaw_offset = readField<float>(payload, size, _gps.heading_offset),
+					.yaw_accuracy = readField<float>(payload, size, _gps.heading_accuracy),
+					.fix_type = readField<uint8_t>(payload, size, _gps.fix_type),
+					.eph = readField<float>(payload, size, _gps.eph),
+					.epv = readField<float>(payload, size, _gps.epv),
+					.sacc = readField<float>(payload, size, _gps.s_variance_m_s),
+					.vel_m_s = readField<float>(payload, size, _gps.vel_m_s),
+					.vel_ned = matrix::Vector3f{
+						readField<float>(payload, size, _gps.vel_n_m_s),
+						readField<float>(payload, size, _gps.vel_e_m_s),
+						readField<float>(payload, size, _gps.vel_d_m_s)
+					},
+					.vel_ned_valid = readField<uint8_t>(payload, size, _gps.vel_ned_valid) != 0,
+					.nsats = readField<uint8_t>(payload, size, _gps.satellites_used),
+					.pdop = sqrtf(hdop * hdop + vdop * vdop),
+				};
+				ekf->setGpsData(gps_msg);
+			}
+			break;
+
+		case MAG: {
+				const uint32_t device_id = readField<uint32_t>(payload, size, _mag.device_id);
+				const uint8_t calibration_count = readField<uint8_t>(payload, size, _mag.calibration_count);
+				const bool reset = (device_id != mag_device_id) || (calibration_count != mag_calibration_count);
+				mag_device_id = device_id;
+				mag_calibration_count = calibration_count;
+
+				ekf->setMagData(magSample{readField<uint64_t>(payload, size, _mag.timestamp_sample, timestamp),
+							  readVector3f(payload, size, _mag.magnetometer_ga), reset});
+			}
+			break;
+
+		case AIRSPEED: {
+				const float true_airspeed = readField<float>(payload, size, _airspeed.true_airspeed_m_s, NAN);
+				const float calibrated_airspeed = readField<float>(payload, size, _airspeed.calibrated_airspeed_m_s, NAN);
+
+				if (std::isfinite(true_airspeed) && std::isfinite(calibrated_airspeed) && (calibrated_airspeed > 0.f)
+				    && (readField<int8_t>(payload, size, _airspeed.selected_airspeed_index) > 0)) {
+
+					airspeedSample airspeed_sample{
+						.time_us = timestamp,
+						.true_airspeed = true_airspeed,
+						.eas2tas = true_airspeed / calibrated_airspeed,
+					};
+					ekf->setAirspeedData(airspeed_sample);
+				}
+			}
+			break;
+
+		case LAND_DETECTED:
+			system_flags.at_rest = readField<uint8_t>(payload, size, _land_detected.at_rest) != 0;
+			system_flags.in_air = readField<uint8_t>(payload, size, _land_detected.landed) == 0;
+			system_flags.gnd_effect = readField<uint8_t>(payload, size, _land_detected.in_ground_effect) != 0;
+			system_flags_updated = true;
+			break;
+
+		case STATUS:
+			if (!_land_detected.topic) {
+				// initially set in_air from arming_state (will be overridden if land detector is available)
+				system_flags.in_air = (readField<uint8_t>(payload, size, _status.arming_state) == vehicle_status_s::ARMING_STATE_ARMED);
+			}
+
+			system_flags.is_fixed_wing = (readField<uint8_t>(payload, size, _status.vehicle_type) == vehicle_status_s::VEHICLE_TYPE_FIXED_WING);
+			system_flags_updated = true;
+			break;
+		}
+	}
+
+	summary.replayed_s = (last_imu_timestamp - first_imu_timestamp) * 1e-6f;
+	summary.wall_time_s = std::chrono::duration<float>(std::chrono::steady_clock::now() - wall_time_start).count();
+
+	return summary;
+}
+
+bool BatchReplay::parseParameterSet(const std::string &line, ParameterSet &parameter_set, std::string &error)
+{
+	std::istringstream stream(line);
+	std::string token;
+
+	while (stream >> token) {
+		const size_t pos = token.find('=');
+
+		if (pos == std::string::npos || pos == 0 || pos == token.size() - 1) {
+			error = "expected NAME=VALUE, got '" + token + "'";
+			return false;
+		}
+
+		const std::string value_string = token.substr(pos + 1);
+		char *end = nullptr;
+		const float value = strtof(value_string.c_str(), &end);
+
+		if (*end != '\0' || !std::isfinite(value)) {
+			error = "invalid value in '" + token + "'";
+			return false;
+		}
+
+		parameter_set.push_back(ParameterOverride{token.substr(0, pos), value});
+	}
+
+	return true;
+}
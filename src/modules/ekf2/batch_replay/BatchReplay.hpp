@@ -0,0 +1,192 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file BatchReplay.hpp
+ *
+ * Replays the sensor data of an indexed ULog file directly into an Ekf instance,
+ * without uORB, work queues or the ekf2 module.
+ *
+ * Each run uses its own Ekf and only reads the shared ULogIndex, so runs with
+ * different parameter sets can be executed in parallel.
+ */
+
+#pragma once
+
+#include "ULogIndex.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class BatchReplay
+{
+public:
+	struct ParameterOverride {
+		std::string name;
+		float value;
+	};
+
+	using ParameterSet = std::vector<ParameterOverride>;
+
+	struct RatioStatistics {
+		void update(float ratio);
+
+		float mean() const { return (count > 0) ? (float)(sum / count) : 0.f; }
+		float exceededPercent() const { return (count > 0) ? 100.f * exceeded / count : 0.f; }
+
+		uint32_t count{0};    ///< number of filter updates with an active source
+		uint32_t exceeded{0}; ///< number of filter updates with a test ratio > 1
+		double sum{0.};
+		float max{0.f};
+	};
+
+	struct Summary {
+		std::string error;                   ///< empty if the run succeeded
+
+		uint64_t imu_samples{0};
+		uint64_t filter_updates{0};
+		uint64_t innovation_fault_updates{0}; ///< filter updates with at least one rejected innovation
+
+		float replayed_s{0.f};               ///< log time replayed
+		float wall_time_s{0.f};
+
+		// innovation test ratios as reported in estimator_status
+		RatioStatistics mag;
+		RatioStatistics vel;
+		RatioStatistics pos;
+		RatioStatistics hgt;
+		RatioStatistics tas;
+		RatioStatistics hagl;
+		RatioStatistics beta;
+	};
+
+	explicit BatchReplay(const ULogIndex &log) : _log(log) {}
+	~BatchReplay() = default;
+
+	/**
+	 * Resolve the input topics and fields of the log
+	 * @return false if the log does not contain the required data
+	 */
+	bool init(std::string &error);
+
+	/**
+	 * Replay the whole log with the logged EKF2 parameters, modified by parameter_set.
+	 * Can be called concurrently from multiple threads.
+	 */
+	Summary run(const ParameterSet &parameter_set) const;
+
+	/**
+	 * Parse a whitespace separated list of NAME=VALUE parameter overrides
+	 */
+	static bool parseParameterSet(const std::string &line, ParameterSet &parameter_set, std::string &error);
+
+private:
+	struct ImuInput {
+		const ULogIndex::Topic *topic{nullptr};
+		ULogIndex::Field gyro_rad;
+		ULogIndex::Field gyro_integral_dt;
+		ULogIndex::Field accelerometer_m_s2;
+		ULogIndex::Field accelerometer_integral_dt;
+		ULogIndex::Field accelerometer_clipping;
+	};
+
+	struct BaroInput {
+		const ULogIndex::Topic *topic{nullptr};
+		ULogIndex::Field timestamp_sample;
+		ULogIndex::Field baro_device_id;
+		ULogIndex::Field baro_alt_meter;
+		ULogIndex::Field rho;
+		ULogIndex::Field calibration_count;
+	};
+
+	struct GpsInput {
+		const ULogIndex::Topic *topic{nullptr};
+		ULogIndex::Field lat;
+		ULogIndex::Field lon;
+		ULogIndex::Field alt;
+		ULogIndex::Field heading;
+		ULogIndex::Field heading_offset;
+		ULogIndex::Field heading_accuracy;
+		ULogIndex::Field fix_type;
+		ULogIndex::Field eph;
+		ULogIndex::Field epv;
+		ULogIndex::Field s_variance_m_s;
+		ULogIndex::Field vel_m_s;
+		ULogIndex::Field vel_n_m_s;
+		ULogIndex::Field vel_e_m_s;
+		ULogIndex::Field vel_d_m_s;
+		ULogIndex::Field vel_ned_valid;
+		ULogIndex::Field satellites_used;
+		ULogIndex::Field hdop;
+		ULogIndex::Field vdop;
+	};
+
+	struct MagInput {
+		const ULogIndex::Topic *topic{nullptr};
+		ULogIndex::Field timestamp_sample;
+		ULogIndex::Field device_id;
+		ULogIndex::Field magnetometer_ga;
+		ULogIndex::Field calibration_count;
+	};
+
+	struct AirspeedInput {
+		const ULogIndex::Topic *topic{nullptr};
+		ULogIndex::Field true_airspeed_m_s;
+		ULogIndex::Field calibrated_airspeed_m_s;
+		ULogIndex::Field selected_airspeed_index;
+	};
+
+	struct LandDetectedInput {
+		const ULogIndex::Topic *topic{nullptr};
+		ULogIndex::Field landed;
+		ULogIndex::Field at_rest;
+		ULogIndex::Field in_ground_effect;
+	};
+
+	struct StatusInput {
+		const ULogIndex::Topic *topic{nullptr};
+		ULogIndex::Field arming_state;
+		ULogIndex::Field vehicle_type;
+	};
+
+	const ULogIndex &_log;
+
+	ImuInput _imu{};
+	BaroInput _baro{};
+	GpsInput _gps{};
+	MagInput _mag{};
+	AirspeedInput _airspeed{};
+	LandDetectedInput _land_detected{};
+	StatusInput _status{};
+};
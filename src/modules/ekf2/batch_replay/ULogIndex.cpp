@@ -0,0 +1,442 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "ULogIndex.hpp"
+
+#include <logger/messages.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+bool ULogIndex::open(const char *file_name)
+{
+	close();
+	_file_name = file_name;
+
+	if (!_file.open(file_name)) {
+		_error = "failed to open file";
+		return false;
+	}
+
+	if (!readFileHeader()) {
+		_error = "not a ULog file";
+		close();
+		return false;
+	}
+
+	_read_until = _file.size();
+
+	// definitions section, it ends with the first subscription
+	size_t data_section_start = sizeof(ulog_file_header_s);
+	ulog_message_header_s header;
+	const uint8_t *message;
+
+	while ((message = _file.message(data_section_start, header)) != nullptr) {
+		if (header.msg_type == (int)ULogMessageType::ADD_LOGGED_MSG || header.msg_type == (int)ULogMessageType::DATA) {
+			break;
+		}
+
+		switch (header.msg_type) {
+		case (int)ULogMessageType::FLAG_BITS:
+			if (!readFlagBits(message, header.msg_size)) {
+				close();
+				return false;
+			}
+
+			break;
+
+		case (int)ULogMessageType::FORMAT:
+			readFormat(message, header.msg_size);
+			break;
+
+		case (int)ULogMessageType::PARAMETER:
+			// only the initial parameters are used
+			readParameter(message, header.msg_size);
+			break;
+
+		default:
+			break;
+		}
+
+		data_section_start += ULOG_MSG_HEADER_LEN + header.msg_size;
+	}
+
+	// a truncated message at the end (e.g. power loss while logging) is not indexed
+	if (!_file.loadOrBuildIndex(data_section_start, _read_until, false)) {
+		_error = "failed to index file";
+		close();
+		return false;
+	}
+
+	readDataSection();
+
+	if (_topics.empty()) {
+		_error = "no logged data";
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void ULogIndex::close()
+{
+	_file.close();
+	_read_until = 0;
+	_formats.clear();
+	_parameters.clear();
+	_topics.clear();
+	_first_timestamp = 0;
+	_last_timestamp = 0;
+}
+
+bool ULogIndex::readFileHeader()
+{
+	static constexpr uint8_t magic[7] = {'U', 'L', 'o', 'g', 0x01, 0x12, 0x35};
+	const uint8_t *header = _file.data(0, sizeof(ulog_file_header_s));
+	return header && (memcmp(magic, header, sizeof(magic)) == 0);
+}
+
+bool ULogIndex::readFlagBits(const uint8_t *message, uint16_t msg_size)
+{
+	if (msg_size != 40) {
+		_error = "unsupported message length for FLAG_BITS message";
+		return false;
+	}
+
+	const uint8_t *incompat_flags = message + 8;
+
+	if (incompat_flags[0] & ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK) {
+		_error = "compressed log, convert it with Tools/decompress_ulog.py first";
+		return false;
+	}
+
+	bool has_unknown_incompat_bits = incompat_flags[0] & ~ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK;
+
+	for (int i = 1; i < 8; ++i) {
+		if (incompat_flags[i]) {
+			has_unknown_incompat_bits = true;
+		}
+	}
+
+	if (has_unknown_incompat_bits) {
+		_error = "log contains unknown incompat bits set";
+		return false;
+	}
+
+	if (incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK) {
+		uint64_t appended_offsets[3];
+		memcpy(appended_offsets, message + 16, sizeof(appended_offsets));
+
+		// the appended data is only used for hardfault dumps
+		if (appended_offsets[0] > 0 && appended_offsets[0] < _read_until) {
+			_read_until = appended_offsets[0];
+		}
+	}
+
+	return true;
+}
+
+void ULogIndex::readFormat(const uint8_t *message, uint16_t msg_size)
+{
+	const std::string format((const char *)message, msg_size);
+	const size_t pos = format.find(':');
+
+	if (pos != std::string::npos) {
+		_formats[format.substr(0, pos)] = format.substr(pos + 1);
+	}
+}
+
+void ULogIndex::readParameter(const uint8_t *message, uint16_t msg_size)
+{
+	if (msg_size < 1) {
+		return;
+	}
+
+	const uint8_t key_len = message[0];
+
+	if (msg_size < 1 + key_len + sizeof(int32_t)) {
+		return;
+	}
+
+	// key is "<type> <name>"
+	const std::string key((const char *)message + 1, key_len);
+	const size_t pos = key.find(' ');
+
+	if (pos == std::string::npos) {
+		return;
+	}
+
+	const std::string type = key.substr(0, pos);
+	Parameter parameter;
+
+	if (type == "int32_t") {
+		parameter.is_int = true;
+		memcpy(&parameter.value_int, message + 1 + key_len, sizeof(int32_t));
+		parameter.value_float = (float)parameter.value_int;
+
+	} else if (type == "float") {
+		memcpy(&parameter.value_float, message + 1 + key_len, sizeof(float));
+		parameter.value_int = (int32_t)parameter.value_float;
+
+	} else {
+		return;
+	}
+
+	_parameters[key.substr(pos + 1)] = parameter;
+}
+
+int ULogIndex::readAddLoggedMessage(const uint8_t *message, uint16_t msg_size, uint16_t &msg_id)
+{
+	if (msg_size <= 3) {
+		return -1;
+	}
+
+	const uint8_t multi_id = message[0];
+	memcpy(&msg_id, message + 1, sizeof(msg_id));
+	const std::string name((const char *)message + 3, msg_size - 3);
+
+	// a topic can be re-added with a different msg_id
+	for (size_t i = 0; i < _topics.size(); ++i) {
+		if (_topics[i].multi_id == multi_id && _topics[i].name == name) {
+			return i;
+		}
+	}
+
+	_topics.emplace_back();
+	_topics.back().name = name;
+	_topics.back().multi_id = multi_id;
+	return _topics.size() - 1;
+}
+
+void ULogIndex::readData(Topic &topic, uint64_t offset)
+{
+	ulog_message_header_s header;
+	const uint8_t *message = _file.message(offset, header);
+	uint16_t msg_id;
+
+	if (!message || header.msg_size < sizeof(msg_id) + sizeof(uint64_t)) {
+		return;
+	}
+
+	// all topics start with the uint64_t timestamp field
+	uint64_t timestamp;
+	memcpy(&timestamp, message + sizeof(msg_id), sizeof(timestamp));
+
+	topic.payload_offsets.push_back(offset + ULOG_MSG_HEADER_LEN + sizeof(msg_id));
+	topic.payload_sizes.push_back(header.msg_size - sizeof(msg_id));
+	topic.timestamps.push_back(timestamp);
+
+	if (timestamp > 0) {
+		if (_first_timestamp == 0 || timestamp < _first_timestamp) {
+			_first_timestamp = timestamp;
+		}
+
+		if (timestamp > _last_timestamp) {
+			_last_timestamp = timestamp;
+		}
+	}
+}
+
+void ULogIndex::readDataSection()
+{
+	struct Subscription {
+		uint64_t offset;
+		int topic_index;
+	};
+
+	// subscriptions of each msg_id in file order, a msg_id can be re-used for another topic
+	std::vector<std::vector<Subscription>> subscriptions;
+	ulog_message_header_s header;
+
+	for (uint64_t offset : _file.otherMessages()) {
+		const uint8_t *message = _file.message(offset, header);
+
+		if (message && header.msg_type == (int)ULogMessageType::ADD_LOGGED_MSG) {
+			uint16_t msg_id;
+			const int topic_index = readAddLoggedMessage(message, header.msg_size, msg_id);
+
+			if (topic_index >= 0) {
+				if (msg_id >= subscriptions.size()) {
+					subscriptions.resize(msg_id + 1);
+				}
+
+				subscriptions[msg_id].push_back({offset, topic_index});
+			}
+		}
+	}
+
+	std::vector<std::vector<uint64_t>> topic_messages(_topics.size());
+
+	for (size_t msg_id = 0; msg_id < subscriptions.size(); ++msg_id) {
+		const std::vector<Subscription> &msg_id_subscriptions = subscriptions[msg_id];
+		size_t current = 0;
+
+		for (uint64_t offset : _file.dataMessages(msg_id)) {
+			while (current + 1 < msg_id_subscriptions.size() && msg_id_subscriptions[current + 1].offset < offset) {
+				++current;
+			}
+
+			// data before the first subscription of the msg_id is ignored
+			if (msg_id_subscriptions.empty() || msg_id_subscriptions[current].offset > offset) {
+				continue;
+			}
+
+			topic_messages[msg_id_subscriptions[current].topic_index].push_back(offset);
+		}
+	}
+
+	for (size_t i = 0; i < _topics.size(); ++i) {
+		// a re-added topic gets its messages from several msg_ids
+		std::sort(topic_messages[i].begin(), topic_messages[i].end());
+
+		for (uint64_t offset : topic_messages[i]) {
+			readData(_topics[i], offset);
+		}
+	}
+}
+
+const ULogIndex::Topic *ULogIndex::findTopic(const char *name, uint8_t multi_id) const
+{
+	for (const Topic &topic : _topics) {
+		if (topic.multi_id == multi_id && topic.name == name) {
+			return &topic;
+		}
+	}
+
+	return nullptr;
+}
+
+ULogIndex::Field ULogIndex::findField(const char *format_name, const char *field_name) const
+{
+	Field field;
+	const auto format = _formats.find(format_name);
+
+	if (format == _formats.end()) {
+		return field;
+	}
+
+	const std::string &fields = format->second;
+	size_t prev_field_end = 0;
+	size_t field_end = fields.find(';');
+	int offset = 0;
+
+	while (field_end != std::string::npos) {
+		const size_t space_pos = fields.find(' ', prev_field_end);
+
+		if (space_pos == std::string::npos || space_pos > field_end) {
+			break;
+		}
+
+		const std::string type_name_full = fields.substr(prev_field_end, space_pos - prev_field_end);
+		const int size = sizeOfFullType(type_name_full);
+
+		if (size <= 0) {
+			break;
+		}
+
+		if (fields.compare(space_pos + 1, field_end - space_pos - 1, field_name) == 0) {
+			field.offset = offset;
+			field.size = size;
+			return field;
+		}
+
+		offset += size;
+		prev_field_end = field_end + 1;
+		field_end = fields.find(';', prev_field_end);
+	}
+
+	return field;
+}
+
+int ULogIndex::sizeOfType(const std::string &type_name, int depth) const
+{
+	if (type_name == "int8_t" || type_name == "uint8_t" || type_name == "char" || type_name == "bool") {
+		return 1;
+
+	} else if (type_name == "int16_t" || type_name == "uint16_t") {
+		return 2;
+
+	} else if (type_name == "int32_t" || type_name == "uint32_t" || type_name == "float") {
+		return 4;
+
+	} else if (type_name == "int64_t" || type_name == "uint64_t" || type_name == "double") {
+		return 8;
+	}
+
+	// nested message type
+	const auto format = _formats.find(type_name);
+
+	if (format == _formats.end() || depth > 8) {
+		return 0;
+	}
+
+	const std::string &fields = format->second;
+	size_t prev_field_end = 0;
+	size_t field_end = fields.find(';');
+	int size = 0;
+
+	while (field_end != std::string::npos) {
+		const size_t space_pos = fields.find(' ', prev_field_end);
+
+		if (space_pos == std::string::npos || space_pos > field_end) {
+			return 0;
+		}
+
+		const int field_size = sizeOfFullType(fields.substr(prev_field_end, space_pos - prev_field_end), depth + 1);
+
+		if (field_size <= 0) {
+			return 0;
+		}
+
+		size += field_size;
+		prev_field_end = field_end + 1;
+		field_end = fields.find(';', prev_field_end);
+	}
+
+	return size;
+}
+
+int ULogIndex::sizeOfFullType(const std::string &type_name_full, int depth) const
+{
+	const size_t start_pos = type_name_full.find('[');
+	const size_t end_pos = type_name_full.find(']');
+
+	if (start_pos == std::string::npos || end_pos == std::string::npos) {
+		return sizeOfType(type_name_full, depth);
+	}
+
+	const int array_size = atoi(type_name_full.substr(start_pos + 1, end_pos - start_pos - 1).c_str());
+	return sizeOfType(type_name_full.substr(0, start_pos), depth) * array_size;
+}
@@ -0,0 +1,154 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file ULogIndex.hpp
+ *
+ * Read-only, memory-mapped ULog file with an index of the data messages of each logged topic.
+ *
+ * The data section is indexed once on open() by px4::ULogFile, after that messages of any topic
+ * can be accessed in O(1) without further reads or copies. An opened index is immutable and can
+ * be shared between threads.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <lib/ulog/ULogFile.hpp>
+
+class ULogIndex
+{
+public:
+	struct Topic {
+		std::string name;                      ///< message format name
+		uint8_t multi_id{0};
+		std::vector<size_t> payload_offsets;   ///< file offset of the payload of each data message
+		std::vector<uint16_t> payload_sizes;   ///< payload size of each data message (may be shorter than the struct)
+		std::vector<uint64_t> timestamps;      ///< value of the timestamp field of each data message
+
+		size_t size() const { return payload_offsets.size(); }
+	};
+
+	struct Field {
+		int offset{-1};
+		int size{0};
+
+		bool valid() const { return offset >= 0; }
+	};
+
+	struct Parameter {
+		bool is_int{false};
+		int32_t value_int{0};
+		float value_float{0.f};
+	};
+
+	ULogIndex() = default;
+	~ULogIndex() = default;
+
+	ULogIndex(const ULogIndex &) = delete;
+	ULogIndex &operator=(const ULogIndex &) = delete;
+
+	/**
+	 * Map a ULog file and build the index.
+	 * @return false if the file cannot be read or is not a supported ULog file (error() contains the reason)
+	 */
+	bool open(const char *file_name);
+
+	void close();
+
+	const std::string &fileName() const { return _file_name; }
+	const std::string &error() const { return _error; }
+
+	/**
+	 * Find a logged topic by name and multi instance
+	 * @return the topic or nullptr if the topic is not in the log
+	 */
+	const Topic *findTopic(const char *name, uint8_t multi_id = 0) const;
+
+	/**
+	 * Find the offset of a top-level field within a message format
+	 */
+	Field findField(const char *format_name, const char *field_name) const;
+
+	const uint8_t *payload(const Topic &topic, size_t index) const
+	{
+		return _file.data(topic.payload_offsets[index], topic.payload_sizes[index]);
+	}
+
+	/**
+	 * Parameters as set at the start of the log. Changes during the log are not applied.
+	 */
+	const std::map<std::string, Parameter> &parameters() const { return _parameters; }
+
+	uint64_t firstTimestamp() const { return _first_timestamp; }
+	uint64_t lastTimestamp() const { return _last_timestamp; }
+	size_t fileSize() const { return _file.size(); }
+
+private:
+	bool readFileHeader();
+	bool readFlagBits(const uint8_t *message, uint16_t msg_size);
+	void readFormat(const uint8_t *message, uint16_t msg_size);
+	void readParameter(const uint8_t *message, uint16_t msg_size);
+
+	/**
+	 * @return index into _topics of the added topic, -1 on error
+	 */
+	int readAddLoggedMessage(const uint8_t *message, uint16_t msg_size, uint16_t &msg_id);
+	void readData(Topic &topic, uint64_t offset);
+
+	/**
+	 * Assign the indexed data messages to the topics
+	 */
+	void readDataSection();
+
+	int sizeOfType(const std::string &type_name, int depth = 0) const;
+	int sizeOfFullType(const std::string &type_name_full, int depth = 0) const;
+
+	std::string _file_name;
+	std::string _error;
+
+	px4::ULogFile _file;
+	size_t _read_until{0};
+
+	std::map<std::string, std::string> _formats; ///< format name -> fields
+	std::map<std::string, Parameter> _parameters;
+	std::vector<Topic> _topics;
+
+	uint64_t _first_timestamp{0};
+	uint64_t _last_timestamp{0};
+};
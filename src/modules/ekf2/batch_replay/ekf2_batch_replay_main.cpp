@@ -0,0 +1,282 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file ekf2_batch_replay_main.cpp
+ *
+ * Host tool for EKF2 tuning sweeps: replays many ULog files with many parameter sets in parallel,
+ * much faster than realtime, and writes a CSV summary of the innovation test ratios of each run.
+ *
+ * Logs should be recorded with the replay logging profile (SDLOG_PROFILE), so that sensor_combined
+ * and the other estimator inputs are logged at full rate.
+ */
+
+#include "BatchReplay.hpp"
+#include "ULogIndex.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace
+{
+
+void usage(const char *name)
+{
+	fprintf(stderr,
+		"Usage: %s [-j <threads>] [-p <parameter sets file>] [-o <output.csv>] <file.ulg> [<file.ulg> ...]\n"
+		"\n"
+		" -j <threads>  number of runs executed in parallel (default: number of CPUs)\n"
+		" -o <file>     CSV output file (default: ekf2_batch_replay.csv)\n"
+		" -p <file>     one parameter set per line, as whitespace separated NAME=VALUE pairs.\n"
+		"               Empty lines and lines starting with # are ignored. Every log is replayed with\n"
+		"               every set. Without this option the logs are replayed with their own parameters.\n"
+		"\n"
+		"Writes one CSV line per run. For each test ratio the number of filter updates with the source\n"
+		"active (n), the mean, the max and the percentage of updates with a ratio > 1 (fail) is reported.\n",
+		name);
+}
+
+bool loadParameterSets(const char *file_name, std::vector<BatchReplay::ParameterSet> &parameter_sets,
+		       std::vector<std::string> &labels)
+{
+	std::ifstream file(file_name);
+
+	if (!file) {
+		fprintf(stderr, "failed to open %s\n", file_name);
+		return false;
+	}
+
+	std::string line;
+	int line_number = 0;
+
+	while (std::getline(file, line)) {
+		line_number++;
+
+		const size_t first = line.find_first_not_of(" \t\r");
+
+		if (first == std::string::npos || line[first] == '#') {
+			continue;
+		}
+
+		line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+
+		BatchReplay::ParameterSet parameter_set;
+		std::string error;
+
+		if (!BatchReplay::parseParameterSet(line, parameter_set, error)) {
+			fprintf(stderr, "%s:%d: %s\n", file_name, line_number, error.c_str());
+			return false;
+		}
+
+		parameter_sets.push_back(parameter_set);
+		labels.push_back(line);
+	}
+
+	return true;
+}
+
+void printStatistics(FILE *out, const BatchReplay::RatioStatistics &statistics)
+{
+	fprintf(out, ",%u,%.3f,%.3f,%.2f", statistics.count, (double)statistics.mean(), (double)statistics.max,
+	       (double)statistics.exceededPercent());
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	unsigned num_threads = std::thread::hardware_concurrency();
+	const char *parameter_file = nullptr;
+	const char *output_file = "ekf2_batch_replay.csv";
+	int ch;
+
+	while ((ch = getopt(argc, argv, "j:p:o:h")) != -1) {
+		switch (ch) {
+		case 'j':
+			num_threads = strtoul(optarg, nullptr, 10);
+			break;
+
+		case 'p':
+			parameter_file = optarg;
+			break;
+
+		case 'o':
+			output_file = optarg;
+			break;
+
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind >= argc) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	if (num_threads == 0) {
+		num_threads = 1;
+	}
+
+	std::vector<BatchReplay::ParameterSet> parameter_sets;
+	std::vector<std::string> parameter_labels;
+
+	if (parameter_file) {
+		if (!loadParameterSets(parameter_file, parameter_sets, parameter_labels)) {
+			return 1;
+		}
+
+		if (parameter_sets.empty()) {
+			fprintf(stderr, "%s contains no parameter sets\n", parameter_file);
+			return 1;
+		}
+
+	} else {
+		parameter_sets.emplace_back();
+		parameter_labels.emplace_back();
+	}
+
+	// map and index all logs once, the runs share them read-only
+	std::vector<std::unique_ptr<ULogIndex>> logs;
+	std::vector<std::unique_ptr<BatchReplay>> replays;
+
+	for (int i = optind; i < argc; i++) {
+		std::unique_ptr<ULogIndex> log = std::make_unique<ULogIndex>();
+		std::string error;
+
+		if (!log->open(argv[i])) {
+			fprintf(stderr, "%s: %s, skipping\n", argv[i], log->error().c_str());
+			continue;
+		}
+
+		std::unique_ptr<BatchReplay> replay = std::make_unique<BatchReplay>(*log);
+
+		if (!replay->init(error)) {
+			fprintf(stderr, "%s: %s, skipping\n", argv[i], error.c_str());
+			continue;
+		}
+
+		logs.push_back(std::move(log));
+		replays.push_back(std::move(replay));
+	}
+
+	if (replays.empty()) {
+		return 1;
+	}
+
+	// the Ekf prints to stdout, the results are written to a separate file
+	FILE *out = fopen(output_file, "w");
+
+	if (!out) {
+		fprintf(stderr, "failed to open %s\n", output_file);
+		return 1;
+	}
+
+	const size_t num_runs = replays.size() * parameter_sets.size();
+	std::vector<BatchReplay::Summary> summaries(num_runs);
+	std::atomic<size_t> next_run{0};
+
+	auto worker = [&]() {
+		size_t run;
+
+		while ((run = next_run.fetch_add(1)) < num_runs) {
+			summaries[run] = replays[run / parameter_sets.size()]->run(parameter_sets[run % parameter_sets.size()]);
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	for (unsigned i = 0; i < num_threads && i < num_runs; i++) {
+		threads.emplace_back(worker);
+	}
+
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	fprintf(out, "log,set,parameters,error,replayed_s,wall_time_s,imu_samples,filter_updates,innovation_fault_pct");
+
+	for (const char *ratio : {"mag", "vel", "pos", "hgt", "tas", "hagl", "beta"}) {
+		fprintf(out, ",%s_n,%s_mean,%s_max,%s_fail_pct", ratio, ratio, ratio, ratio);
+	}
+
+	fprintf(out, "\n");
+
+	int ret = 0;
+	double replayed_s = 0.;
+	double wall_time_s = 0.;
+
+	for (size_t run = 0; run < num_runs; run++) {
+		const BatchReplay::Summary &summary = summaries[run];
+		const size_t set = run % parameter_sets.size();
+
+		fprintf(out, "%s,%zu,\"%s\",%s,%.1f,%.3f,%llu,%llu,%.2f",
+		       logs[run / parameter_sets.size()]->fileName().c_str(), set, parameter_labels[set].c_str(),
+		       summary.error.c_str(), (double)summary.replayed_s, (double)summary.wall_time_s,
+		       (unsigned long long)summary.imu_samples, (unsigned long long)summary.filter_updates,
+		       summary.filter_updates > 0 ? 100. * summary.innovation_fault_updates / summary.filter_updates : 0.);
+
+		printStatistics(out, summary.mag);
+		printStatistics(out, summary.vel);
+		printStatistics(out, summary.pos);
+		printStatistics(out, summary.hgt);
+		printStatistics(out, summary.tas);
+		printStatistics(out, summary.hagl);
+		printStatistics(out, summary.beta);
+		fprintf(out, "\n");
+
+		if (!summary.error.empty()) {
+			fprintf(stderr, "%s, set %zu: %s\n", logs[run / parameter_sets.size()]->fileName().c_str(), set,
+				summary.error.c_str());
+			ret = 1;
+		}
+
+		replayed_s += summary.replayed_s;
+		wall_time_s += summary.wall_time_s;
+	}
+
+	fclose(out);
+
+	printf("%zu runs written to %s, %.0f s of log data replayed in %.1f s run time (%.0fx realtime per thread, %u threads)\n",
+	       num_runs, output_file, replayed_s, wall_time_s, wall_time_s > 0. ? replayed_s / wall_time_s : 0., (unsigned)threads.size());
+
+	return ret;
+}
@@ -56,3 +56,39 @@ PARAM_DEFINE_INT32(EKF2_MULTI_IMU, 0);
  * @max 4
  */
 PARAM_DEFINE_INT32(EKF2_MULTI_MAG, 0);
+
+/**
+ * Multi-EKF dedicated work queues.
+ *
+ * Run each Multi-EKF instance on its own work queue (thread) instead of sharing
+ * the work queue of its IMU, so that the instances can run in parallel on
+ * multicore systems. Each work queue requires an additional thread stack.
+ *
+ * @group EKF2
+ * @reboot_required true
+ * @boolean
+ */
+PARAM_DEFINE_INT32(EKF2_MULTI_WQ, 0);
+
+/**
+ * Multi-EKF CPU affinity.
+ *
+ * Bitmask of the CPUs the dedicated Multi-EKF work queues (EKF2_MULTI_WQ) run on.
+ * The instances are distributed over the selected CPUs (round robin), each
+ * instance is pinned to a single CPU. Set 0 to not restrict the CPUs.
+ * Only supported on Linux.
+ *
+ * @group EKF2
+ * @reboot_required true
+ * @min 0
+ * @max 255
+ * @bit 0 CPU 0
+ * @bit 1 CPU 1
+ * @bit 2 CPU 2
+ * @bit 3 CPU 3
+ * @bit 4 CPU 4
+ * @bit 5 CPU 5
+ * @bit 6 CPU 6
+ * @bit 7 CPU 7
+ */
+PARAM_DEFINE_INT32(EKF2_MULTI_CPU, 0);
@@ -39,6 +39,11 @@
 
 using namespace matrix;
 
+// cosine-sum windows, w(n) = c[0] + 2 * sum(c[i] * cos(2 pi i n / N)),
+// or applied in the frequency domain X_w[k] = c[0] * X[k] + sum(c[i] * (X[k - i] + X[k + i]))
+static constexpr float WINDOW_HANN[] {0.5f, -0.25f};
+static constexpr float WINDOW_BLACKMAN_HARRIS[] {0.35875f, -0.48829f / 2.f, 0.14128f / 2.f, -0.01168f / 2.f};
+
 GyroFFT::GyroFFT() :
 	ModuleParams(nullptr),
 	ScheduledWorkItem(MODULE_NAME, px4::wq_configurations::hp_default)
@@ -63,16 +68,63 @@ GyroFFT::~GyroFFT()
 	delete[] _gyro_data_buffer_x;
 	delete[] _gyro_data_buffer_y;
 	delete[] _gyro_data_buffer_z;
-	delete[] _hanning_window;
+	delete[] _window;
 	delete[] _fft_input_buffer;
 	delete[] _fft_outupt_buffer;
 	delete[] _peak_magnitudes_all;
+	delete[] _sdft_output_buffer;
+	delete[] _sdft_twiddle;
+	delete[] _sdft_state;
 }
 
 bool GyroFFT::init()
 {
 	bool buffers_allocated = false;
 
+	_sliding_dft = (_param_imu_gyro_fft_mod.get() == 1);
+
+	if (_param_imu_gyro_fft_win.get() == 1) {
+		_window_coefficients = WINDOW_BLACKMAN_HARRIS;
+		_window_num_coefficients = sizeof(WINDOW_BLACKMAN_HARRIS) / sizeof(WINDOW_BLACKMAN_HARRIS[0]);
+
+	} else {
+		_window_coefficients = WINDOW_HANN;
+		_window_num_coefficients = sizeof(WINDOW_HANN) / sizeof(WINDOW_HANN[0]);
+	}
+
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+
+	switch (_param_imu_gyro_fft_len.get()) {
+	case 256:
+		buffers_allocated = AllocateBuffers<256>();
+		break;
+
+	case 512:
+		buffers_allocated = AllocateBuffers<512>();
+		break;
+
+	case 1024:
+		buffers_allocated = AllocateBuffers<1024>();
+		break;
+
+	case 2048:
+		buffers_allocated = AllocateBuffers<2048>();
+		break;
+
+	case 4096:
+		buffers_allocated = AllocateBuffers<4096>();
+		break;
+
+	default:
+		// otherwise default to 256
+		PX4_ERR("Invalid IMU_GYRO_FFT_LEN=%" PRId32 ", resetting", _param_imu_gyro_fft_len.get());
+		buffers_allocated = AllocateBuffers<256>();
+		_param_imu_gyro_fft_len.set(256);
+		_param_imu_gyro_fft_len.commit();
+		break;
+	}
+
+#else
 	// arm_rfft_init_q15(&_rfft_q15, _imu_gyro_fft_len, 0, 1) manually inlined to save flash
 	_rfft_q15.pTwiddleAReal = (q15_t *) realCoefAQ15;
 	_rfft_q15.pTwiddleBReal = (q15_t *) realCoefBQ15;
@@ -138,13 +190,16 @@ bool GyroFFT::init()
 		break;
 	}
 
+#endif // CONFIG_GYRO_FFT_FLOAT
+
 	if (buffers_allocated) {
 		_imu_gyro_fft_len = _param_imu_gyro_fft_len.get();
 
-		// init Hanning window
-		for (int n = 0; n < _imu_gyro_fft_len; n++) {
-			const float hanning_value = 0.5f * (1.f - cosf(2.f * M_PI_F * n / (_imu_gyro_fft_len - 1)));
-			arm_float_to_q15(&hanning_value, &_hanning_window[n], 1);
+		if (_sliding_dft) {
+			_sdft_damping_n = powf(SDFT_DAMPING, _imu_gyro_fft_len);
+
+		} else {
+			InitWindow();
 		}
 
 		if (!SensorSelectionUpdate(true)) {
@@ -154,17 +209,72 @@ bool GyroFFT::init()
 		return true;
 	}
 
+	// the buffers that were allocated are freed by the destructor
 	PX4_ERR("failed to allocate buffers");
-	delete[] _gyro_data_buffer_x;
-	delete[] _gyro_data_buffer_y;
-	delete[] _gyro_data_buffer_z;
-	delete[] _hanning_window;
-	delete[] _fft_input_buffer;
-	delete[] _fft_outupt_buffer;
-
 	return false;
 }
 
+bool GyroFFT::AllocateFFTBuffers(int N)
+{
+	_window = new fft_data_t[N];
+	_fft_input_buffer = new fft_data_t[N];
+
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+	_fft_outupt_buffer = new float[N + 2];
+
+	return _window && _fft_input_buffer && _fft_outupt_buffer && _rfft_f32.init(N);
+#else
+	_fft_outupt_buffer = new q15_t[N * 2];
+
+	return _window && _fft_input_buffer && _fft_outupt_buffer;
+#endif // CONFIG_GYRO_FFT_FLOAT
+}
+
+void GyroFFT::InitWindow()
+{
+	for (int n = 0; n < _imu_gyro_fft_len; n++) {
+		float window_value = _window_coefficients[0];
+
+		for (int i = 1; i < _window_num_coefficients; i++) {
+			window_value += 2.f * _window_coefficients[i] * cosf(2.f * M_PI_F * i * n / (_imu_gyro_fft_len - 1));
+		}
+
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+		_window[n] = window_value;
+#else
+		arm_float_to_q15(&window_value, &_window[n], 1);
+#endif // CONFIG_GYRO_FFT_FLOAT
+	}
+}
+
+void GyroFFT::FallbackToFFT()
+{
+	PX4_ERR("sliding DFT not possible with IMU_GYRO_FFT_MIN/MAX at %.1f Hz, using FFT", (double)_gyro_sample_rate_hz);
+
+	delete[] _sdft_output_buffer;
+	delete[] _sdft_twiddle;
+	delete[] _sdft_state;
+	_sdft_output_buffer = nullptr;
+	_sdft_twiddle = nullptr;
+	_sdft_state = nullptr;
+	_sdft_num_bins = 0;
+
+	if (!AllocateFFTBuffers(_imu_gyro_fft_len)) {
+		PX4_ERR("failed to allocate buffers");
+		request_stop();
+		return;
+	}
+
+	InitWindow();
+
+	_sliding_dft = false;
+
+	// the gyro data buffers are used linearly again
+	_fft_buffer_index[0] = 0;
+	_fft_buffer_index[1] = 0;
+	_fft_buffer_index[2] = 0;
+}
+
 bool GyroFFT::SensorSelectionUpdate(bool force)
 {
 	if (_sensor_selection_sub.updated() || (_selected_sensor_device_id == 0) || force) {
@@ -255,45 +365,35 @@ void GyroFFT::VehicleIMUStatusUpdate(bool force)
 	}
 }
 
-// helper function used for frequency estimation
-static inline float tau(float x)
-{
-	// tau(x) = 1/4 * log(3x^2 + 6x + 1) – sqrt(6)/24 * log((x + 1 – sqrt(2/3))  /  (x + 1 + sqrt(2/3)))
-	float p1 = logf(3.f * powf(x, 2.f) + 6.f * x + 1.f);
-	float part1 = x + 1.f - sqrtf(2.f / 3.f);
-	float part2 = x + 1.f + sqrtf(2.f / 3.f);
-	float p2 = logf(part1 / part2);
-	return (0.25f * p1 - sqrtf(6.f) / 24.f * p2);
-}
-
-float GyroFFT::EstimatePeakFrequencyBin(q15_t fft[], int peak_index)
+template<typename T>
+float GyroFFT::EstimatePeakFrequencyBin(T fft[], int peak_index)
 {
 	if (peak_index >= 2) {
-		// find peak location using Quinn's Second Estimator (2020-06-14: http://dspguru.com/dsp/howtos/how-to-interpolate-fft-peak/)
-		float real[3] { (float)fft[peak_index - 2], (float)fft[peak_index], (float)fft[peak_index + 2]     };
-		float imag[3] { (float)fft[peak_index - 2 + 1], (float)fft[peak_index + 1], (float)fft[peak_index + 2 + 1] };
+		// find peak location using log-parabolic (Gaussian) interpolation of the windowed magnitudes
+		// (nearly unbiased for the Hann and Blackman-Harris windows, unlike Quinn's estimator which assumes a rectangular window)
+		float log_magnitude[3];
 
-		static constexpr int k = 1;
+		for (int i = 0; i < 3; i++) {
+			const float real = fft[peak_index + 2 * (i - 1)];
+			const float imag = fft[peak_index + 2 * (i - 1) + 1];
+			const float magnitude_squared = real * real + imag * imag;
 
-		const float divider = (real[k] * real[k] + imag[k] * imag[k]);
-
-		// ap = (X[k + 1].r * X[k].r + X[k+1].i * X[k].i) / (X[k].r * X[k].r + X[k].i * X[k].i)
-		float ap = (real[k + 1] * real[k] + imag[k + 1] * imag[k]) / divider;
-
-		// dp = -ap / (1 – ap)
-		float dp = -ap  / (1.f - ap);
+			if (!(magnitude_squared > 0.f)) {
+				return NAN;
+			}
 
-		// am = (X[k - 1].r * X[k].r + X[k – 1].i * X[k].i) / (X[k].r * X[k].r + X[k].i * X[k].i)
-		float am = (real[k - 1] * real[k] + imag[k - 1] * imag[k]) / divider;
+			// ln(|X|^2) = 2 ln(|X|), the factor cancels
+			log_magnitude[i] = logf(magnitude_squared);
+		}
 
-		// dm = am / (1 – am)
-		float dm = am / (1.f - am);
+		const float divider = log_magnitude[0] - 2.f * log_magnitude[1] + log_magnitude[2];
 
-		// d = (dp + dm) / 2 + tau(dp * dp) – tau(dm * dm)
-		float d = (dp + dm) / 2.f + tau(dp * dp) - tau(dm * dm);
+		if (divider < 0.f) {
+			const float d = 0.5f * (log_magnitude[0] - log_magnitude[2]) / divider;
 
-		// k’ = k + d
-		return peak_index + 2.f * d;
+			// k' = k + d
+			return peak_index + 2.f * d;
+		}
 	}
 
 	return NAN;
@@ -384,6 +484,11 @@ void GyroFFT::Run()
 		}
 	}
 
+	if (_sliding_dft && _fft_updated) {
+		// estimate peaks once per cycle from the latest sliding DFT spectrum
+		SlidingDFTFindPeaks();
+	}
+
 	if (_publish) {
 		Publish();
 		_publish = false;
@@ -394,6 +499,11 @@ void GyroFFT::Run()
 
 void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N)
 {
+	if (_sliding_dft) {
+		UpdateSlidingDFT(timestamp_sample, input, N);
+		return;
+	}
+
 	q15_t *gyro_data_buffer[] {_gyro_data_buffer_x, _gyro_data_buffer_y, _gyro_data_buffer_z};
 
 	for (int axis = 0; axis < 3; axis++) {
@@ -410,12 +520,21 @@ void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint
 			if ((buffer_index >= _imu_gyro_fft_len) && !_fft_updated) {
 				perf_begin(_fft_perf);
 
-				arm_mult_q15(gyro_data_buffer[axis], _hanning_window, _fft_input_buffer, _imu_gyro_fft_len);
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+
+				for (int n = 0; n < _imu_gyro_fft_len; n++) {
+					_fft_input_buffer[n] = gyro_data_buffer[axis][n] * _window[n];
+				}
+
+				_rfft_f32.transform(_fft_input_buffer, _fft_outupt_buffer);
+#else
+				arm_mult_q15(gyro_data_buffer[axis], _window, _fft_input_buffer, _imu_gyro_fft_len);
 				arm_rfft_q15(&_rfft_q15, _fft_input_buffer, _fft_outupt_buffer);
+#endif // CONFIG_GYRO_FFT_FLOAT
 
 				_fft_updated = true;
 
-				FindPeaks(timestamp_sample, axis, _fft_outupt_buffer);
+				FindPeaks(timestamp_sample, axis, _fft_outupt_buffer, 1, _imu_gyro_fft_len / 2 - 1);
 
 				// reset
 				// shift buffer (3/4 overlap)
@@ -429,15 +548,201 @@ void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint
 	}
 }
 
-void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *fft_outupt_buffer)
+bool GyroFFT::SlidingDFTConfigure()
+{
+	_sdft_sample_rate_hz = _gyro_sample_rate_hz;
+
+	const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
+
+	// window width in bins (frequency domain)
+	const int window_bins = _window_num_coefficients - 1;
+
+	// bins searched for peaks
+	const int bin_min = math::max(2, (int)floorf(_param_imu_gyro_fft_min.get() / resolution_hz));
+	const int bin_max = math::min(_imu_gyro_fft_len / 2 - 2 - window_bins,
+				      (int)ceilf(_param_imu_gyro_fft_max.get() / resolution_hz));
+
+	if (bin_max < bin_min) {
+		return false;
+	}
+
+	// track all bins from DC (for the noise estimate) up to the search range plus the bins needed for the peak estimate and windowing
+	const int num_bins = bin_max + 2 + window_bins;
+
+	if (num_bins != _sdft_num_bins) {
+		delete[] _sdft_twiddle;
+		delete[] _sdft_state;
+
+		_sdft_twiddle = new float[num_bins * 2];
+		_sdft_state = new float[num_bins * 2 * 3];
+
+		if (!_sdft_twiddle || !_sdft_state) {
+			PX4_ERR("failed to allocate sliding DFT buffers");
+			delete[] _sdft_twiddle;
+			delete[] _sdft_state;
+			_sdft_twiddle = nullptr;
+			_sdft_state = nullptr;
+			_sdft_num_bins = 0;
+			return false;
+		}
+
+		_sdft_num_bins = num_bins;
+	}
+
+	_sdft_bin_min = bin_min;
+
+	for (int k = 0; k < _sdft_num_bins; k++) {
+		const float omega = 2.f * M_PI_F * k / _imu_gyro_fft_len;
+		_sdft_twiddle[2 * k] = cosf(omega);
+		_sdft_twiddle[2 * k + 1] = sinf(omega);
+	}
+
+	// force reset
+	_fft_buffer_index[0] = 0;
+	_fft_buffer_index[1] = 0;
+	_fft_buffer_index[2] = 0;
+
+	return true;
+}
+
+void GyroFFT::UpdateSlidingDFT(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N)
+{
+	if (fabsf(_gyro_sample_rate_hz - _sdft_sample_rate_hz) > FLT_EPSILON) {
+		if (!SlidingDFTConfigure()) {
+			// e.g. the search range doesn't fit the sample rate, don't retry with every sample
+			FallbackToFFT();
+			return;
+		}
+	}
+
+	if (_sdft_num_bins == 0) {
+		// only if FallbackToFFT() failed
+		return;
+	}
+
+	perf_begin(_fft_perf);
+
+	q15_t *gyro_data_buffer[] {_gyro_data_buffer_x, _gyro_data_buffer_y, _gyro_data_buffer_z};
+
+	for (int axis = 0; axis < 3; axis++) {
+		int &buffer_index = _fft_buffer_index[axis];
+		int &ring_index = _sdft_ring_index[axis];
+		q15_t *ring_buffer = gyro_data_buffer[axis];
+		float *state = &_sdft_state[axis * _sdft_num_bins * 2];
+		float &energy = _sdft_energy[axis];
+
+		if (buffer_index == 0) {
+			// (re)start from an empty window
+			memset(ring_buffer, 0, sizeof(q15_t) * _imu_gyro_fft_len);
+			memset(state, 0, sizeof(float) * _sdft_num_bins * 2);
+			energy = 0.f;
+		}
+
+		for (int n = 0; n < N; n++) {
+			// convert int16_t -> q15_t (scaling isn't relevant)
+			const q15_t sample = input[axis][n] / 2;
+			const float sample_oldest = _sdft_damping_n * ring_buffer[ring_index];
+
+			ring_buffer[ring_index] = sample;
+
+			if (++ring_index >= _imu_gyro_fft_len) {
+				ring_index = 0;
+			}
+
+			// sum of squares over the window with the same damping (Parseval: sum of |X_k|^2 = N * energy)
+			energy = SDFT_DAMPING * SDFT_DAMPING * energy + sample * sample - sample_oldest * sample_oldest;
+
+			// X_k(n) = e^(j*2*pi*k/N) * (r * X_k(n-1) + x(n) - r^N * x(n-N))
+			const float delta = sample - sample_oldest;
+
+			for (int k = 0; k < _sdft_num_bins; k++) {
+				const float real = SDFT_DAMPING * state[2 * k] + delta;
+				const float imag = SDFT_DAMPING * state[2 * k + 1];
+				const float c = _sdft_twiddle[2 * k];
+				const float s = _sdft_twiddle[2 * k + 1];
+
+				state[2 * k]     = real * c - imag * s;
+				state[2 * k + 1] = real * s + imag * c;
+			}
+
+			if (buffer_index < _imu_gyro_fft_len) {
+				buffer_index++;
+			}
+		}
+	}
+
+	_sdft_timestamp_sample = timestamp_sample;
+	_fft_updated = true;
+
+	perf_end(_fft_perf);
+}
+
+void GyroFFT::SlidingDFTFindPeaks()
+{
+	for (int axis = 0; axis < 3; axis++) {
+		// window full
+		if (_fft_buffer_index[axis] >= _imu_gyro_fft_len) {
+			const float *state = &_sdft_state[axis * _sdft_num_bins * 2];
+
+			const int window_bins = _window_num_coefficients - 1;
+			const int bin_max = _sdft_num_bins - 2 - window_bins;
+
+			// window applied in the frequency domain: X_w[k] = c[0] * X[k] + sum(c[i] * (X[k - i] + X[k + i]))
+			for (int k = _sdft_bin_min - 1; k <= bin_max + 1; k++) {
+				float real = _window_coefficients[0] * state[2 * k];
+				float imag = _window_coefficients[0] * state[2 * k + 1];
+
+				for (int i = 1; i < _window_num_coefficients; i++) {
+					// X[-k] = conj(X[k]) for real input
+					const int k_minus = (k >= i) ? (k - i) : (i - k);
+					const float imag_minus = (k >= i) ? state[2 * k_minus + 1] : -state[2 * k_minus + 1];
+
+					real += _window_coefficients[i] * (state[2 * k_minus] + state[2 * (k + i)]);
+					imag += _window_coefficients[i] * (imag_minus + state[2 * (k + i) + 1]);
+				}
+
+				_sdft_output_buffer[2 * k] = real;
+				_sdft_output_buffer[2 * k + 1] = imag;
+			}
+
+			// The untracked bins are needed for the SNR, estimate their noise floor from the remaining energy
+			// (one sided, without the tracked bins), assuming white noise with Rayleigh distributed magnitudes.
+			float power_untracked = 0.5f * (_imu_gyro_fft_len * _sdft_energy[axis] - (state[0] * state[0] + state[1] * state[1]));
+
+			for (int k = 1; k < _sdft_num_bins; k++) {
+				power_untracked -= state[2 * k] * state[2 * k] + state[2 * k + 1] * state[2 * k + 1];
+			}
+
+			const float power_mean = math::max(power_untracked, 0.f) / math::max(_imu_gyro_fft_len / 2 - _sdft_num_bins, 1);
+
+			// window noise power gain c[0]^2 + 2 * sum(c[i]^2)
+			float window_power_gain = _window_coefficients[0] * _window_coefficients[0];
+
+			for (int i = 1; i < _window_num_coefficients; i++) {
+				window_power_gain += 2.f * _window_coefficients[i] * _window_coefficients[i];
+			}
+
+			// mean Rayleigh magnitude sqrt(pi/4 * power)
+			const float magnitude_mean = sqrtf(M_PI_F / 4.f * window_power_gain * power_mean);
+
+			const float bin_mag_sum_other = magnitude_mean * (_imu_gyro_fft_len / 2 - 1 - (bin_max - _sdft_bin_min + 1));
+
+			FindPeaks(_sdft_timestamp_sample, axis, _sdft_output_buffer, _sdft_bin_min, bin_max, bin_mag_sum_other);
+		}
+	}
+}
+
+template<typename T>
+void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, T *fft_outupt_buffer, int bin_start, int bin_end,
+			float bin_mag_sum_other)
 {
 	const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
 
 	// sum total energy across all used buckets for SNR
-	float bin_mag_sum = 0;
+	float bin_mag_sum = bin_mag_sum_other;
 
 	// FFT output buffer is ordered [real[0], imag[0], real[1], imag[1], real[2], imag[2] ... real[(N/2)-1], imag[(N/2)-1]
-	for (uint16_t fft_index = 2; fft_index < _imu_gyro_fft_len; fft_index += 2) {
+	for (int fft_index = 2 * bin_start; fft_index <= 2 * bin_end; fft_index += 2) {
 
 		const float real = fft_outupt_buffer[fft_index];
 		const float imag = fft_outupt_buffer[fft_index + 1];
@@ -460,7 +765,7 @@ void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *ff
 		float largest_peak = 0;
 		int largest_peak_index = 0;
 
-		for (int bin_index = 1; bin_index < _imu_gyro_fft_len; bin_index++) {
+		for (int bin_index = bin_start; bin_index <= bin_end; bin_index++) {
 
 			const float freq_hz = bin_index * resolution_hz;
 
@@ -703,6 +1008,12 @@ int GyroFFT::task_spawn(int argc, char *argv[])
 int GyroFFT::print_status()
 {
 	PX4_INFO("gyro sample rate: %.3f Hz", (double)_gyro_sample_rate_hz);
+
+	if (_sliding_dft) {
+		const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
+		PX4_INFO("sliding DFT: %d bins (0 - %.1f Hz)", _sdft_num_bins, (double)((_sdft_num_bins - 1) * resolution_hz));
+	}
+
 	perf_print_counter(_cycle_perf);
 	perf_print_counter(_cycle_interval_perf);
 	perf_print_counter(_fft_perf);
@@ -41,6 +41,7 @@
 #include <px4_platform_common/module.h>
 #include <px4_platform_common/module_params.h>
 #include <px4_platform_common/posix.h>
+#include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
 #include <uORB/Publication.hpp>
 #include <uORB/PublicationMulti.hpp>
@@ -56,6 +57,10 @@
 #include "arm_math.h"
 #include "arm_const_structs.h"
 
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+# include "RealFFT.hpp"
+#endif // CONFIG_GYRO_FFT_FLOAT
+
 using namespace time_literals;
 
 class GyroFFT : public ModuleBase<GyroFFT>, public ModuleParams, public px4::ScheduledWorkItem
@@ -84,12 +89,30 @@ private:
 	static constexpr int MAX_NUM_PEAKS = sizeof(sensor_gyro_fft_s::peak_frequencies_x) / sizeof(
 			sensor_gyro_fft_s::peak_frequencies_x[0]);
 
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+	using fft_data_t = float;
+#else
+	using fft_data_t = q15_t;
+#endif // CONFIG_GYRO_FFT_FLOAT
+
+	// sliding DFT pole damping (r < 1) to keep accumulated float rounding errors bounded
+	static constexpr float SDFT_DAMPING = 0.9999f;
+
 	void Run() override;
-	inline void FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *fft_outupt_buffer);
-	inline float EstimatePeakFrequencyBin(q15_t fft[], int peak_index);
+	template<typename T>
+	inline void FindPeaks(const hrt_abstime &timestamp_sample, int axis, T *fft_outupt_buffer, int bin_start, int bin_end,
+			      float bin_mag_sum_other = 0.f);
+	template<typename T>
+	inline float EstimatePeakFrequencyBin(T fft[], int peak_index);
 	inline void Publish();
+	bool AllocateFFTBuffers(int N);
+	void FallbackToFFT();
+	void InitWindow();
 	bool SensorSelectionUpdate(bool force = false);
+	bool SlidingDFTConfigure();
+	void SlidingDFTFindPeaks();
 	void Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N);
+	void UpdateSlidingDFT(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N);
 	inline void UpdateOutput(const hrt_abstime &timestamp_sample, int axis, float peak_frequencies[MAX_NUM_PEAKS],
 				 float peak_snr[MAX_NUM_PEAKS], int num_peaks_found);
 	void VehicleIMUStatusUpdate(bool force = false);
@@ -100,16 +123,20 @@ private:
 		_gyro_data_buffer_x = new q15_t[N];
 		_gyro_data_buffer_y = new q15_t[N];
 		_gyro_data_buffer_z = new q15_t[N];
-		_hanning_window = new q15_t[N];
-		_fft_input_buffer = new q15_t[N];
-		_fft_outupt_buffer = new q15_t[N * 2];
 
 		_peak_magnitudes_all = new float[N];
 
-		return (_gyro_data_buffer_x && _gyro_data_buffer_y && _gyro_data_buffer_z
-			&& _hanning_window
-			&& _fft_input_buffer
-			&& _fft_outupt_buffer);
+		if (!_gyro_data_buffer_x || !_gyro_data_buffer_y || !_gyro_data_buffer_z || !_peak_magnitudes_all) {
+			return false;
+		}
+
+		if (_sliding_dft) {
+			// the gyro data buffers are used as ring buffers, no FFT working buffers needed
+			_sdft_output_buffer = new float[N];
+			return (_sdft_output_buffer != nullptr);
+		}
+
+		return AllocateFFTBuffers(N);
 	}
 
 	uORB::Publication<sensor_gyro_fft_s> _sensor_gyro_fft_pub{ORB_ID(sensor_gyro_fft)};
@@ -132,17 +159,37 @@ private:
 
 	bool _gyro_fifo{false};
 
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+	RealFFT _rfft_f32;
+#else
 	arm_rfft_instance_q15 _rfft_q15;
+#endif // CONFIG_GYRO_FFT_FLOAT
 
 	q15_t *_gyro_data_buffer_x{nullptr};
 	q15_t *_gyro_data_buffer_y{nullptr};
 	q15_t *_gyro_data_buffer_z{nullptr};
-	q15_t *_hanning_window{nullptr};
-	q15_t *_fft_input_buffer{nullptr};
-	q15_t *_fft_outupt_buffer{nullptr};
+	fft_data_t *_window{nullptr};
+	fft_data_t *_fft_input_buffer{nullptr};
+	fft_data_t *_fft_outupt_buffer{nullptr};
+
+	// cosine-sum window (IMU_GYRO_FFT_WIN) coefficients c, w(n) = c[0] + 2 * sum(c[i] * cos(2 pi i n / N))
+	const float *_window_coefficients{nullptr};
+	int _window_num_coefficients{0};
 
 	float *_peak_magnitudes_all{nullptr};
 
+	// sliding DFT (IMU_GYRO_FFT_MOD 1), only the bins up to IMU_GYRO_FFT_MAX are tracked
+	float *_sdft_output_buffer{nullptr}; // windowed spectrum, same layout as _fft_outupt_buffer
+	float *_sdft_twiddle{nullptr};       // [cos, sin] per tracked bin
+	float *_sdft_state{nullptr};         // [real, imag] per tracked bin and axis
+	float _sdft_sample_rate_hz{0.f};
+	float _sdft_damping_n{1.f};          // SDFT_DAMPING^N
+	hrt_abstime _sdft_timestamp_sample{0};
+	float _sdft_energy[3] {};
+	int _sdft_bin_min{0};
+	int _sdft_num_bins{0};
+	int _sdft_ring_index[3] {};
+
 	float _gyro_sample_rate_hz{8000}; // 8 kHz default
 
 	float _fifo_last_scale{0};
@@ -161,12 +208,15 @@ private:
 
 	bool _fft_updated{false};
 	bool _publish{false};
+	bool _sliding_dft{false};
 
 	DEFINE_PARAMETERS(
 		(ParamInt<px4::params::IMU_GYRO_FFT_LEN>) _param_imu_gyro_fft_len,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_MIN>) _param_imu_gyro_fft_min,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_MAX>) _param_imu_gyro_fft_max,
-		(ParamFloat<px4::params::IMU_GYRO_FFT_SNR>) _param_imu_gyro_fft_snr
+		(ParamFloat<px4::params::IMU_GYRO_FFT_SNR>) _param_imu_gyro_fft_snr,
+		(ParamInt<px4::params::IMU_GYRO_FFT_MOD>) _param_imu_gyro_fft_mod,
+		(ParamInt<px4::params::IMU_GYRO_FFT_WIN>) _param_imu_gyro_fft_win
 	)
 };
 
@@ -0,0 +1,167 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "RealFFT.hpp"
+
+#include <math.h>
+#include <px4_platform_common/defines.h>
+
+RealFFT::~RealFFT()
+{
+	free();
+}
+
+void RealFFT::free()
+{
+	delete[] _twiddle;
+	delete[] _bit_reverse;
+
+	_twiddle = nullptr;
+	_bit_reverse = nullptr;
+	_length = 0;
+}
+
+bool RealFFT::init(int length)
+{
+	if ((length < 8) || (length > UINT16_MAX) || ((length & (length - 1)) != 0)) {
+		return false;
+	}
+
+	free();
+
+	const int M = length / 2; // complex FFT length
+
+	_twiddle = new float[length];
+	_bit_reverse = new uint16_t[M];
+
+	if (!_twiddle || !_bit_reverse) {
+		free();
+		return false;
+	}
+
+	for (int k = 0; k < M; k++) {
+		const float omega = 2.f * M_PI_F * k / length;
+		_twiddle[2 * k] = cosf(omega);
+		_twiddle[2 * k + 1] = -sinf(omega);
+	}
+
+	int bits = 0;
+
+	while ((1 << bits) < M) {
+		bits++;
+	}
+
+	for (int i = 0; i < M; i++) {
+		int reversed = 0;
+
+		for (int b = 0; b < bits; b++) {
+			if (i & (1 << b)) {
+				reversed |= 1 << (bits - 1 - b);
+			}
+		}
+
+		_bit_reverse[i] = reversed;
+	}
+
+	_length = length;
+
+	return true;
+}
+
+void RealFFT::transform(const float *input, float *output) const
+{
+	const int M = _length / 2;
+
+	// pack even/odd real samples as complex z[n] = x[2n] + j x[2n+1] in bit reversed order
+	for (int i = 0; i < M; i++) {
+		const int r = _bit_reverse[i];
+		output[2 * r] = input[2 * i];
+		output[2 * r + 1] = input[2 * i + 1];
+	}
+
+	// radix-2 decimation in time butterflies, W_M^m = W_N^2m
+	for (int size = 2; size <= M; size *= 2) {
+		const int half = size / 2;
+		const int twiddle_stride = 2 * (_length / size);
+
+		for (int i = 0; i < M; i += size) {
+			float *a = &output[2 * i];
+			float *b = &output[2 * (i + half)];
+
+			for (int j = 0; j < half; j++) {
+				const float w_re = _twiddle[j * twiddle_stride];
+				const float w_im = _twiddle[j * twiddle_stride + 1];
+
+				const float t_re = w_re * b[2 * j] - w_im * b[2 * j + 1];
+				const float t_im = w_re * b[2 * j + 1] + w_im * b[2 * j];
+
+				b[2 * j]     = a[2 * j] - t_re;
+				b[2 * j + 1] = a[2 * j + 1] - t_im;
+				a[2 * j]     += t_re;
+				a[2 * j + 1] += t_im;
+			}
+		}
+	}
+
+	// split into the real spectrum: X[k] = E + W_N^k O, X[M - k] = conj(E - W_N^k O)
+	//  E = (Z[k] + conj(Z[M - k])) / 2, O = -j (Z[k] - conj(Z[M - k])) / 2
+	const float z0_re = output[0];
+	const float z0_im = output[1];
+	output[0] = z0_re + z0_im;
+	output[1] = 0.f;
+	output[2 * M] = z0_re - z0_im;
+	output[2 * M + 1] = 0.f;
+
+	for (int k = 1; k <= M / 2; k++) {
+		const float zk_re = output[2 * k];
+		const float zk_im = output[2 * k + 1];
+		const float zm_re = output[2 * (M - k)];
+		const float zm_im = output[2 * (M - k) + 1];
+
+		const float e_re = 0.5f * (zk_re + zm_re);
+		const float e_im = 0.5f * (zk_im - zm_im);
+		const float o_re = 0.5f * (zk_im + zm_im);
+		const float o_im = -0.5f * (zk_re - zm_re);
+
+		const float w_re = _twiddle[2 * k];
+		const float w_im = _twiddle[2 * k + 1];
+
+		const float wo_re = w_re * o_re - w_im * o_im;
+		const float wo_im = w_re * o_im + w_im * o_re;
+
+		output[2 * k]           = e_re + wo_re;
+		output[2 * k + 1]       = e_im + wo_im;
+		output[2 * (M - k)]     = e_re - wo_re;
+		output[2 * (M - k) + 1] = -(e_im - wo_im);
+	}
+}
@@ -0,0 +1,73 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file RealFFT.hpp
+ *
+ * Portable single precision real FFT (radix-2 complex FFT of N/2 points with real split).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class RealFFT
+{
+public:
+	RealFFT() = default;
+	~RealFFT();
+
+	/**
+	 * Allocate and initialize the tables for a transform length.
+	 * @param length FFT length, power of 2 (>= 8)
+	 * @return true on success
+	 */
+	bool init(int length);
+
+	int length() const { return _length; }
+
+	/**
+	 * Forward transform of length real input samples.
+	 * @param input length samples
+	 * @param output length + 2 values, ordered [real[0], imag[0], real[1], imag[1], ... real[N/2], imag[N/2]]
+	 */
+	void transform(const float *input, float *output) const;
+
+private:
+	void free();
+
+	float *_twiddle{nullptr};       // [cos, -sin](2 pi k / N), k = 0 .. N/2 - 1
+	uint16_t *_bit_reverse{nullptr}; // bit reversed index of the N/2 point complex FFT
+
+	int _length{0};
+};
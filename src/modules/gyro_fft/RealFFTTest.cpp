@@ -0,0 +1,187 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file RealFFTTest.cpp
+ * Tests for the portable real FFT, compared against a naive DFT.
+ */
+
+#include <gtest/gtest.h>
+
+#include "RealFFT.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+static constexpr int MIN_LENGTH = 8;
+static constexpr int MAX_LENGTH = 4096;
+
+// X[k] = sum x[n] * e^(-j 2 pi k n / N), k = 0 .. N/2, same layout as RealFFT::transform()
+std::vector<double> naiveDFT(const std::vector<float> &input)
+{
+	const int N = input.size();
+	std::vector<double> output(N + 2);
+
+	for (int k = 0; k <= N / 2; k++) {
+		double real = 0.0;
+		double imag = 0.0;
+
+		for (int n = 0; n < N; n++) {
+			// k * n modulo N keeps the argument exact
+			const double omega = 2.0 * M_PI * ((int64_t)k * n % N) / N;
+			real += input[n] * cos(omega);
+			imag -= input[n] * sin(omega);
+		}
+
+		output[2 * k] = real;
+		output[2 * k + 1] = imag;
+	}
+
+	return output;
+}
+
+std::vector<float> transform(const std::vector<float> &input)
+{
+	RealFFT fft;
+	EXPECT_TRUE(fft.init(input.size()));
+	EXPECT_EQ(fft.length(), (int)input.size());
+
+	std::vector<float> output(input.size() + 2);
+	fft.transform(input.data(), output.data());
+	return output;
+}
+
+// wrap a phase difference to [-pi, pi]
+double phaseError(double a, double b)
+{
+	return remainder(a - b, 2.0 * M_PI);
+}
+
+} // namespace
+
+TEST(RealFFTTest, InitLength)
+{
+	RealFFT fft;
+	EXPECT_FALSE(fft.init(0));
+	EXPECT_FALSE(fft.init(4));
+	EXPECT_FALSE(fft.init(100));
+	EXPECT_FALSE(fft.init(-256));
+
+	EXPECT_TRUE(fft.init(256));
+	EXPECT_EQ(fft.length(), 256);
+
+	// re-init with another length
+	EXPECT_TRUE(fft.init(64));
+	EXPECT_EQ(fft.length(), 64);
+}
+
+TEST(RealFFTTest, PureTone)
+{
+	const float amplitude = 1000.f;
+
+	for (int N = MIN_LENGTH; N <= MAX_LENGTH; N *= 2) {
+		for (int tone_bin : {1, N / 8, N / 2 - 1}) {
+			for (float phase : {0.f, 1.f, -2.5f}) {
+				// GIVEN: a cosine exactly on a bin
+				std::vector<float> input(N);
+
+				for (int n = 0; n < N; n++) {
+					input[n] = amplitude * cosf(2.f * (float)M_PI * (tone_bin * n % N) / N + phase);
+				}
+
+				// WHEN: we transform it
+				const std::vector<float> output = transform(input);
+
+				// THEN: all energy is in the tone bin, with magnitude A * N / 2 and the phase of the cosine
+				const double peak = amplitude * N / 2.0;
+
+				for (int k = 0; k <= N / 2; k++) {
+					const double magnitude = hypot(output[2 * k], output[2 * k + 1]);
+
+					if (k == tone_bin) {
+						EXPECT_NEAR(magnitude, peak, 1e-5 * peak) << "N " << N << " bin " << k;
+						EXPECT_NEAR(phaseError(atan2(output[2 * k + 1], output[2 * k]), phase), 0.0, 1e-4)
+								<< "N " << N << " bin " << k;
+
+					} else {
+						EXPECT_LT(magnitude, 1e-5 * peak) << "N " << N << " bin " << k;
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST(RealFFTTest, RandomInput)
+{
+	std::mt19937 random_generator(1);
+	std::uniform_real_distribution<float> distribution(-1000.f, 1000.f);
+
+	for (int N = MIN_LENGTH; N <= MAX_LENGTH; N *= 2) {
+		// GIVEN: random input
+		std::vector<float> input(N);
+
+		for (float &sample : input) {
+			sample = distribution(random_generator);
+		}
+
+		// WHEN: we transform it with the FFT and the naive DFT
+		const std::vector<float> output = transform(input);
+		const std::vector<double> expected = naiveDFT(input);
+
+		// THEN: both match, relative to the RMS bin magnitude (N^1/2 * input RMS)
+		const double rms_magnitude = sqrt((double)N) * 1000.0 / sqrt(3.0);
+
+		// DC and Nyquist are real
+		EXPECT_EQ(output[1], 0.f);
+		EXPECT_EQ(output[N + 1], 0.f);
+
+		for (int k = 0; k <= N / 2; k++) {
+			const double magnitude = hypot(output[2 * k], output[2 * k + 1]);
+			const double expected_magnitude = hypot(expected[2 * k], expected[2 * k + 1]);
+
+			EXPECT_NEAR(magnitude, expected_magnitude, 1e-5 * rms_magnitude) << "N " << N << " bin " << k;
+
+			// the phase is only defined for bins with some energy
+			if (expected_magnitude > 0.1 * rms_magnitude) {
+				const double phase = atan2(output[2 * k + 1], output[2 * k]);
+				const double expected_phase = atan2(expected[2 * k + 1], expected[2 * k]);
+				EXPECT_NEAR(phaseError(phase, expected_phase), 0.0, 1e-4) << "N " << N << " bin " << k;
+			}
+		}
+	}
+}
@@ -65,9 +65,12 @@ PARAM_DEFINE_FLOAT(IMU_GYRO_FFT_MAX, 150.f);
 /**
 * IMU gyro FFT length.
 *
+* 2048 and 4096 are only available with the float32 FFT (CONFIG_GYRO_FFT_FLOAT).
+*
 * @value 256 256
 * @value 512 512
 * @value 1024 1024
+* @value 2048 2048
 * @value 4096 4096
 * @unit Hz
 * @reboot_required true
@@ -83,3 +86,33 @@ PARAM_DEFINE_INT32(IMU_GYRO_FFT_LEN, 512);
 * @group Sensors
 */
 PARAM_DEFINE_FLOAT(IMU_GYRO_FFT_SNR, 10.f);
+
+/**
+* IMU gyro FFT mode.
+*
+* Full FFT estimates the peaks once per IMU_GYRO_FFT_LEN/4 new samples (one axis per cycle).
+* Sliding DFT updates the bins from DC up to IMU_GYRO_FFT_MAX (plus the few bins needed
+* for the window) with every new sample and estimates the peaks of all axes every cycle
+* (sample block), at constant cost proportional to IMU_GYRO_FFT_MAX.
+* The full FFT is used if IMU_GYRO_FFT_MIN and IMU_GYRO_FFT_MAX don't fit the sample rate.
+*
+* @value 0 Full FFT
+* @value 1 Sliding DFT
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_FFT_MOD, 0);
+
+/**
+* IMU gyro FFT window.
+*
+* Blackman-Harris has a wider main lobe than Hann, but much lower
+* sidelobes, reducing the leakage of large low frequency motion
+* and strong peaks into the searched frequency range.
+*
+* @value 0 Hann
+* @value 1 Blackman-Harris
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_FFT_WIN, 0);
@@ -109,6 +109,10 @@ void LoadMon::Run()
 
 #endif
 
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+	work_item_stats();
+#endif
+
 	if (should_exit()) {
 		ScheduleClear();
 #if defined (__PX4_LINUX)
@@ -300,6 +304,39 @@ void LoadMon::stack_usage()
 }
 #endif
 
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+void LoadMon::work_item_stats()
+{
+	px4::wq_run_stats_t stats;
+
+	if (!px4::WorkQueueManagerRunStats(_work_item_index, stats)) {
+		// wrap around after the last work item
+		_work_item_index = 0;
+
+		if (!px4::WorkQueueManagerRunStats(_work_item_index, stats)) {
+			return;
+		}
+	}
+
+	work_item_stats_s work_item_stats{};
+	strncpy(work_item_stats.item_name, stats.item_name, sizeof(work_item_stats.item_name) - 1);
+	strncpy(work_item_stats.work_queue, stats.wq_name, sizeof(work_item_stats.work_queue) - 1);
+	work_item_stats.interval = stats.interval;
+	work_item_stats.deadline_misses = stats.deadline_misses;
+
+	static_assert(sizeof(work_item_stats.latency) == sizeof(stats.latency), "histogram size mismatch");
+	static_assert(sizeof(work_item_stats.run_time) == sizeof(stats.run_time), "histogram size mismatch");
+	memcpy(work_item_stats.latency, stats.latency, sizeof(work_item_stats.latency));
+	memcpy(work_item_stats.run_time, stats.run_time, sizeof(work_item_stats.run_time));
+
+	work_item_stats.timestamp = hrt_absolute_time();
+	_work_item_stats_pub.publish(work_item_stats);
+
+	// continue with the next work item next cycle
+	_work_item_index++;
+}
+#endif
+
 int LoadMon::print_usage(const char *reason)
 {
 	if (reason) {
@@ -314,6 +351,9 @@ usage and publish the `cpuload` topic.
 
 On NuttX it also checks the stack usage of each process and if it falls below 300 bytes, a warning is output,
 which will also appear in the log file.
+
+With CONFIG_WORK_QUEUE_RUN_STATS it publishes the run time statistics of one work item per cycle
+(`work_item_stats` topic).
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("load_mon", "system");
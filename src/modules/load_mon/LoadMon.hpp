@@ -47,6 +47,7 @@
 #include <uORB/Publication.hpp>
 #include <uORB/topics/cpuload.h>
 #include <uORB/topics/task_stack_info.h>
+#include <uORB/topics/work_item_stats.h>
 
 #if defined(__PX4_LINUX)
 #include <sys/times.h>
@@ -92,6 +93,15 @@ private:
 #endif
 	uORB::Publication<cpuload_s> _cpuload_pub {ORB_ID(cpuload)};
 
+#if defined(CONFIG_WORK_QUEUE_RUN_STATS)
+	/* Publish the run time statistics of the next work item */
+	void work_item_stats();
+
+	unsigned _work_item_index{0};
+
+	uORB::Publication<work_item_stats_s> _work_item_stats_pub{ORB_ID(work_item_stats)};
+#endif
+
 #if defined(__PX4_LINUX)
 	FILE *_proc_fd = nullptr;
 	/* calculate usage directly from clock ticks on Linux */
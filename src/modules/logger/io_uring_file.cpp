@@ -0,0 +1,562 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "io_uring_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <px4_platform_common/posix.h>
+
+#if defined(LOGGER_HAVE_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace px4
+{
+namespace logger
+{
+
+IoUringFile::IoUringFile(perf_counter_t perf_write, perf_counter_t perf_fsync)
+	: _perf_write(perf_write), _perf_fsync(perf_fsync)
+{
+}
+
+IoUringFile::~IoUringFile()
+{
+	if (_fd >= 0) {
+		close();
+	}
+
+	teardown_ring();
+
+	for (Slot &slot : _slots) {
+		free(slot.buffer);
+	}
+}
+
+#if defined(LOGGER_HAVE_IO_URING)
+
+static int io_uring_setup(unsigned entries, struct io_uring_params *params)
+{
+	return syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+	return syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+bool IoUringFile::supported()
+{
+	struct io_uring_params params {};
+
+	int ring_fd = io_uring_setup(1, &params);
+
+	if (ring_fd < 0) {
+		return false;
+	}
+
+	::close(ring_fd);
+	return true;
+}
+
+bool IoUringFile::setup_ring()
+{
+	struct io_uring_params params {};
+
+	// one entry per slot, plus the fsync
+	_ring_fd = io_uring_setup(NUM_SLOTS + 1, &params);
+
+	if (_ring_fd < 0) {
+		return false;
+	}
+
+	_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+	const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+
+	if (single_mmap) {
+		_sq_ring_size = _cq_ring_size = (_sq_ring_size > _cq_ring_size) ? _sq_ring_size : _cq_ring_size;
+	}
+
+	void *sq_ring = mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+			     IORING_OFF_SQ_RING);
+
+	if (sq_ring == MAP_FAILED) {
+		teardown_ring();
+		return false;
+	}
+
+	_sq_ring = sq_ring;
+
+	if (single_mmap) {
+		_cq_ring = _sq_ring;
+
+	} else {
+		void *cq_ring = mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+				     IORING_OFF_CQ_RING);
+
+		if (cq_ring == MAP_FAILED) {
+			teardown_ring();
+			return false;
+		}
+
+		_cq_ring = cq_ring;
+	}
+
+	_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	void *sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+			  IORING_OFF_SQES);
+
+	if (sqes == MAP_FAILED) {
+		teardown_ring();
+		return false;
+	}
+
+	_sqes = (struct io_uring_sqe *)sqes;
+
+	uint8_t *sq = (uint8_t *)_sq_ring;
+	_sq_head = (unsigned *)(sq + params.sq_off.head);
+	_sq_tail = (unsigned *)(sq + params.sq_off.tail);
+	_sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+	_sq_array = (unsigned *)(sq + params.sq_off.array);
+
+	uint8_t *cq = (uint8_t *)_cq_ring;
+	_cq_head = (unsigned *)(cq + params.cq_off.head);
+	_cq_tail = (unsigned *)(cq + params.cq_off.tail);
+	_cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+	_cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+	return true;
+}
+
+void IoUringFile::teardown_ring()
+{
+	if (_sqes) {
+		munmap(_sqes, _sqes_size);
+		_sqes = nullptr;
+	}
+
+	if (_cq_ring && _cq_ring != _sq_ring) {
+		munmap(_cq_ring, _cq_ring_size);
+	}
+
+	_cq_ring = nullptr;
+
+	if (_sq_ring) {
+		munmap(_sq_ring, _sq_ring_size);
+		_sq_ring = nullptr;
+	}
+
+	if (_ring_fd >= 0) {
+		::close(_ring_fd);
+		_ring_fd = -1;
+	}
+
+	_sq_head = _sq_tail = _sq_mask = _sq_array = nullptr;
+	_cq_head = _cq_tail = _cq_mask = nullptr;
+	_cqes = nullptr;
+}
+
+int IoUringFile::open(const char *filename)
+{
+	for (Slot &slot : _slots) {
+		if (slot.buffer == nullptr) {
+			void *buffer = nullptr;
+
+			if (posix_memalign(&buffer, DIRECT_IO_ALIGNMENT, SLOT_SIZE) != 0) {
+				errno = ENOMEM;
+				return -1;
+			}
+
+			slot.buffer = (uint8_t *)buffer;
+		}
+
+		slot.size = 0;
+		slot.in_flight = false;
+	}
+
+	if (!setup_ring()) {
+		return -1;
+	}
+
+	_direct_io = true;
+	_fd = ::open(filename, O_CREAT | O_WRONLY | O_DIRECT, PX4_O_MODE_666);
+
+	if (_fd < 0 && errno == EINVAL) {
+		// file system without O_DIRECT support (e.g. tmpfs): still write asynchronously
+		_direct_io = false;
+		_fd = ::open(filename, O_CREAT | O_WRONLY, PX4_O_MODE_666);
+	}
+
+	if (_fd >= 0 && _direct_io) {
+		_fd_buffered = ::open(filename, O_WRONLY);
+
+		if (_fd_buffered < 0) {
+			const int error = errno;
+			::close(_fd);
+			_fd = -1;
+			errno = error;
+		}
+	}
+
+	if (_fd < 0) {
+		const int error = errno;
+		teardown_ring();
+		errno = error;
+		return -1;
+	}
+
+	_current = 0;
+	_file_offset = 0;
+	_fsync_in_flight = false;
+	_error = 0;
+
+	return _fd;
+}
+
+struct io_uring_sqe *IoUringFile::get_sqe()
+{
+	const unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+	const unsigned tail = *_sq_tail;
+
+	if (tail - head > *_sq_mask) {
+		return nullptr;
+	}
+
+	const unsigned index = tail & *_sq_mask;
+	struct io_uring_sqe *sqe = &_sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	_sq_array[index] = index;
+	return sqe;
+}
+
+bool IoUringFile::submit_sqe()
+{
+	__atomic_store_n(_sq_tail, *_sq_tail + 1, __ATOMIC_RELEASE);
+
+	int ret;
+
+	do {
+		ret = io_uring_enter(_ring_fd, 1, 0, 0);
+	} while (ret < 0 && errno == EINTR);
+
+	if (ret != 1) {
+		if (_error == 0) {
+			_error = (ret < 0) ? errno : EIO;
+		}
+
+		return false;
+	}
+
+	return true;
+}
+
+bool IoUringFile::submit_current()
+{
+	Slot &slot = _slots[_current];
+
+	if (slot.in_flight || slot.size == 0) {
+		return true;
+	}
+
+	struct io_uring_sqe *sqe = get_sqe();
+
+	if (sqe == nullptr) {
+		// cannot happen, there are more entries than requests
+		_error = EBUSY;
+		return false;
+	}
+
+	slot.iov.iov_base = slot.buffer;
+	slot.iov.iov_len = slot.size;
+
+	// IORING_OP_WRITEV instead of IORING_OP_WRITE, it is available since Linux 5.1
+	sqe->opcode = IORING_OP_WRITEV;
+	sqe->fd = _fd;
+	sqe->addr = (uint64_t)(uintptr_t)&slot.iov;
+	sqe->len = 1;
+	sqe->off = _file_offset;
+	sqe->user_data = _current;
+
+	slot.in_flight = true;
+	slot.submit_time = hrt_absolute_time();
+
+	if (!submit_sqe()) {
+		slot.in_flight = false;
+		return false;
+	}
+
+	_file_offset += slot.size;
+	_current = (_current + 1) % NUM_SLOTS;
+	return true;
+}
+
+bool IoUringFile::reap(bool wait)
+{
+	while (true) {
+		unsigned head = *_cq_head;
+		const unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+
+		if (head == tail) {
+			if (!wait) {
+				return true;
+			}
+
+			if (io_uring_enter(_ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+				if (_error == 0) {
+					_error = errno;
+				}
+
+				return false;
+			}
+
+			continue;
+		}
+
+		const hrt_abstime now = hrt_absolute_time();
+
+		for (; head != tail; ++head) {
+			const struct io_uring_cqe &cqe = _cqes[head & *_cq_mask];
+
+			if (cqe.user_data == FSYNC_USER_DATA) {
+				perf_set_elapsed(_perf_fsync, now - _fsync_submit_time);
+				_fsync_in_flight = false;
+
+				if (cqe.res < 0 && _error == 0) {
+					_error = -cqe.res;
+				}
+
+			} else if (cqe.user_data < NUM_SLOTS) {
+				Slot &slot = _slots[cqe.user_data];
+				perf_set_elapsed(_perf_write, now - slot.submit_time);
+
+				if (cqe.res < 0 && _error == 0) {
+					_error = -cqe.res;
+
+				} else if ((size_t)cqe.res != slot.size && _error == 0) {
+					// short write (e.g. disk full), there is no retry at that offset
+					_error = ENOSPC;
+				}
+
+				slot.in_flight = false;
+				slot.size = 0;
+			}
+		}
+
+		__atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+
+		return true;
+	}
+}
+
+void IoUringFile::wait_all()
+{
+	bool in_flight = true;
+
+	while (in_flight) {
+		in_flight = _fsync_in_flight;
+
+		for (const Slot &slot : _slots) {
+			in_flight = in_flight || slot.in_flight;
+		}
+
+		if (in_flight && !reap(true)) {
+			break;
+		}
+	}
+}
+
+ssize_t IoUringFile::write(const void *data, size_t size)
+{
+	if (_error == 0) {
+		reap(false);
+	}
+
+	const uint8_t *src = (const uint8_t *)data;
+	size_t remaining = size;
+
+	while (remaining > 0 && _error == 0) {
+		Slot &slot = _slots[_current];
+
+		// all slots in flight: wait for the oldest one
+		while (slot.in_flight && reap(true)) {}
+
+		if (_error != 0) {
+			break;
+		}
+
+		const size_t n = (remaining < SLOT_SIZE - slot.size) ? remaining : SLOT_SIZE - slot.size;
+		memcpy(slot.buffer + slot.size, src, n);
+		slot.size += n;
+		src += n;
+		remaining -= n;
+
+		if (slot.size == SLOT_SIZE) {
+			submit_current();
+		}
+	}
+
+	if (_error != 0) {
+		errno = _error;
+		return -1;
+	}
+
+	return size;
+}
+
+void IoUringFile::write_partial_slot()
+{
+	const Slot &slot = _slots[_current];
+
+	if (slot.in_flight || slot.size == 0 || _error != 0) {
+		return;
+	}
+
+	// with O_DIRECT this only copies the data into the page cache, it does not wait for the storage.
+	// The slot stays current and is written again with O_DIRECT once it is full (same data at the same offset).
+	perf_begin(_perf_write);
+	const ssize_t ret = pwrite(_direct_io ? _fd_buffered : _fd, slot.buffer, slot.size, _file_offset);
+	perf_end(_perf_write);
+
+	if (ret != (ssize_t)slot.size) {
+		_error = (ret < 0) ? errno : ENOSPC;
+	}
+}
+
+void IoUringFile::fsync()
+{
+	if (_fd < 0 || _error != 0) {
+		return;
+	}
+
+	reap(false);
+
+	if (_direct_io) {
+		// the fsync below syncs the file, including what was written through _fd_buffered
+		write_partial_slot();
+
+	} else {
+		submit_current();
+	}
+
+	if (_fsync_in_flight || _error != 0) {
+		return;
+	}
+
+	struct io_uring_sqe *sqe = get_sqe();
+
+	if (sqe == nullptr) {
+		return;
+	}
+
+	// runs after all previously submitted writes
+	sqe->opcode = IORING_OP_FSYNC;
+	sqe->flags = IOSQE_IO_DRAIN;
+	sqe->fd = _fd;
+	sqe->user_data = FSYNC_USER_DATA;
+
+	_fsync_in_flight = true;
+	_fsync_submit_time = hrt_absolute_time();
+
+	if (!submit_sqe()) {
+		_fsync_in_flight = false;
+	}
+}
+
+int IoUringFile::close()
+{
+	if (_fd < 0) {
+		return 0;
+	}
+
+	wait_all();
+
+	// write the remaining data synchronously: with O_DIRECT only a multiple of the block size can be written
+	write_partial_slot();
+	_slots[_current].size = 0;
+
+	perf_begin(_perf_fsync);
+
+	if (::fsync(_fd) != 0 && _error == 0) {
+		_error = errno;
+	}
+
+	perf_end(_perf_fsync);
+
+	if (::close(_fd) != 0 && _error == 0) {
+		_error = errno;
+	}
+
+	_fd = -1;
+
+	if (_fd_buffered >= 0) {
+		::close(_fd_buffered);
+		_fd_buffered = -1;
+	}
+
+	teardown_ring();
+
+	const int error = _error;
+	_error = 0;
+
+	if (error != 0) {
+		errno = error;
+		return -1;
+	}
+
+	return 0;
+}
+
+#else /* LOGGER_HAVE_IO_URING */
+
+bool IoUringFile::supported() { return false; }
+bool IoUringFile::setup_ring() { return false; }
+void IoUringFile::teardown_ring() {}
+int IoUringFile::open(const char *) { errno = ENOSYS; return -1; }
+ssize_t IoUringFile::write(const void *, size_t) { errno = ENOSYS; return -1; }
+void IoUringFile::fsync() {}
+int IoUringFile::close() { return 0; }
+
+#endif /* LOGGER_HAVE_IO_URING */
+
+}
+}
@@ -0,0 +1,176 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <drivers/drv_hrt.h>
+#include <perf/perf_counter.h>
+
+#if defined(__PX4_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define LOGGER_HAVE_IO_URING 1
+#endif
+#endif
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace px4
+{
+namespace logger
+{
+
+/**
+ * @class IoUringFile
+ * Asynchronous log file writes with io_uring (Linux only).
+ *
+ * Data is copied into a few aligned staging buffers, which are submitted as soon as they are full, so that
+ * several writes are in flight and the writer thread does not block on the storage. The file is opened with
+ * O_DIRECT if the file system supports it (the page cache is bypassed, so there are no writeback stalls).
+ * With O_DIRECT only full buffers are written asynchronously, the partially filled buffer is written through a
+ * second, buffered file descriptor on fsync() and close().
+ */
+class IoUringFile
+{
+public:
+	IoUringFile(perf_counter_t perf_write, perf_counter_t perf_fsync);
+	~IoUringFile();
+
+	/**
+	 * Check if io_uring is supported by the kernel (and not blocked, e.g. by seccomp).
+	 */
+	static bool supported();
+
+	/**
+	 * Open (create) a file and set up the ring.
+	 * @return file descriptor, -1 on error (errno is set)
+	 */
+	int open(const char *filename);
+
+	/**
+	 * Queue data to be written. This only blocks if all staging buffers are in flight.
+	 * @return size, or -1 if a write failed (errno is set)
+	 */
+	ssize_t write(const void *data, size_t size);
+
+	/**
+	 * Queue an fsync after all submitted writes (without blocking). Also writes a partial buffer
+	 * (with O_DIRECT into the page cache, the buffer is written again once it is full).
+	 */
+	void fsync();
+
+	/**
+	 * Write the remaining data, wait for all requests and close the file.
+	 * @return 0 on success, -1 otherwise (errno is set)
+	 */
+	int close();
+
+	bool direct_io() const { return _direct_io; }
+
+private:
+	static constexpr unsigned NUM_SLOTS = 4;
+	static constexpr size_t SLOT_SIZE = 16 * 1024; ///< must be a multiple of DIRECT_IO_ALIGNMENT
+	static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+	static constexpr uint64_t FSYNC_USER_DATA = NUM_SLOTS;
+
+	struct Slot {
+		uint8_t *buffer{nullptr};
+		size_t size{0};
+		bool in_flight{false};
+		hrt_abstime submit_time{0};
+		struct iovec iov {};
+	};
+
+	bool setup_ring();
+	void teardown_ring();
+
+	/** submit the current slot and advance to the next one */
+	bool submit_current();
+
+	/** get a submission queue entry, nullptr if the queue is full */
+	struct io_uring_sqe *get_sqe();
+	bool submit_sqe();
+
+	/**
+	 * Process completions
+	 * @param wait block until at least one completion is available
+	 * @return false if waiting failed
+	 */
+	bool reap(bool wait);
+
+	void wait_all();
+
+	/** write the partially filled current slot synchronously (through _fd_buffered with O_DIRECT) */
+	void write_partial_slot();
+
+	Slot _slots[NUM_SLOTS] {};
+	unsigned _current{0}; ///< slot that is being filled
+	off_t _file_offset{0}; ///< file offset for the next submitted write
+	bool _fsync_in_flight{false};
+	hrt_abstime _fsync_submit_time{0};
+
+	int _fd{-1};
+	int _fd_buffered{-1}; ///< same file without O_DIRECT, to write partial buffers
+	bool _direct_io{false};
+	int _error{0}; ///< errno of the first failed request
+
+	int _ring_fd{-1};
+	void *_sq_ring{nullptr};
+	size_t _sq_ring_size{0};
+	void *_cq_ring{nullptr};
+	size_t _cq_ring_size{0};
+	struct io_uring_sqe *_sqes{nullptr};
+	size_t _sqes_size{0};
+
+	// pointers into the mapped rings
+	unsigned *_sq_head{nullptr};
+	unsigned *_sq_tail{nullptr};
+	unsigned *_sq_mask{nullptr};
+	unsigned *_sq_array{nullptr};
+	unsigned *_cq_head{nullptr};
+	unsigned *_cq_tail{nullptr};
+	unsigned *_cq_mask{nullptr};
+	struct io_uring_cqe *_cqes{nullptr};
+
+	perf_counter_t _perf_write;
+	perf_counter_t _perf_fsync;
+};
+
+}
+}
@@ -0,0 +1,270 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Round trip of a compressed log through LogWriterFile: the header and Flags message must stay uncompressed
+ * (as written by Logger::write_header()), everything after it is decompressed and compared.
+ * Run this test only using make tests TESTFILTER=log_compression
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include <px4_platform_common/defines.h>
+
+#include "log_writer_file.h"
+#include "messages.h"
+
+using namespace px4::logger;
+
+class LogCompressionTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		snprintf(_filename, sizeof(_filename), "log_compression_test_%i.ulg", (int)getpid());
+	}
+
+	void TearDown() override
+	{
+		unlink(_filename);
+	}
+
+	std::vector<uint8_t> readFile()
+	{
+		std::vector<uint8_t> data;
+		FILE *f = fopen(_filename, "rb");
+
+		if (f) {
+			uint8_t buffer[1024];
+			size_t n;
+
+			while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+				data.insert(data.end(), buffer, buffer + n);
+			}
+
+			fclose(f);
+		}
+
+		return data;
+	}
+
+	/** decode an LZ4 block, @return false on malformed input */
+	static bool decompressBlock(const uint8_t *src, size_t size, std::vector<uint8_t> &dst)
+	{
+		size_t i = 0;
+
+		while (i < size) {
+			const uint8_t token = src[i++];
+			size_t length = token >> 4;
+
+			if (length == 15) {
+				uint8_t b;
+
+				do {
+					if (i >= size) { return false; }
+
+					b = src[i++];
+					length += b;
+				} while (b == 255);
+			}
+
+			if (i + length > size) { return false; }
+
+			dst.insert(dst.end(), src + i, src + i + length);
+			i += length;
+
+			if (i == size) {
+				return true; // last sequence has no match
+			}
+
+			if (i + 2 > size) { return false; }
+
+			const size_t offset = src[i] | (src[i + 1] << 8);
+			i += 2;
+			length = token & 0xf;
+
+			if (length == 15) {
+				uint8_t b;
+
+				do {
+					if (i >= size) { return false; }
+
+					b = src[i++];
+					length += b;
+				} while (b == 255);
+			}
+
+			length += 4;
+
+			if (offset == 0 || offset > dst.size()) { return false; }
+
+			const size_t start = dst.size() - offset;
+
+			for (size_t k = 0; k < length; ++k) {
+				dst.push_back(dst[start + k]);
+			}
+		}
+
+		return true;
+	}
+
+	char _filename[64] {};
+};
+
+TEST_F(LogCompressionTest, HeaderRoundTrip)
+{
+	LogWriterFile writer(32 * 1024);
+	ASSERT_TRUE(writer.init());
+	ASSERT_EQ(writer.thread_start(), 0);
+
+	writer.start_log(LogType::Full, _filename);
+
+	// same sequence as Logger::write_header()
+	ulog_file_header_s header{};
+	memcpy(header.magic, "ULog\x01\x12\x35\x01", sizeof(header.magic));
+	header.timestamp = 1234;
+
+	ulog_message_flag_bits_s flag_bits{};
+	flag_bits.msg_size = sizeof(flag_bits) - ULOG_MSG_HEADER_LEN;
+	flag_bits.msg_type = static_cast<uint8_t>(ULogMessageType::FLAG_BITS);
+
+	writer.lock();
+	writer.write_message(LogType::Full, &header, sizeof(header));
+
+	const bool compressed = writer.init_compression(LogType::Full);
+	EXPECT_TRUE(compressed);
+
+	if (compressed) {
+		flag_bits.incompat_flags[0] |= ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK;
+	}
+
+	writer.write_message(LogType::Full, &flag_bits, sizeof(flag_bits));
+
+	if (compressed) {
+		writer.start_compression(LogType::Full);
+	}
+
+	// compressible messages, more than a frame in total
+	std::vector<uint8_t> payload;
+	uint8_t message[3 + 100];
+
+	for (int i = 0; i < 400; ++i) {
+		const uint16_t msg_size = sizeof(message) - ULOG_MSG_HEADER_LEN;
+		memcpy(message, &msg_size, sizeof(msg_size));
+		message[2] = static_cast<uint8_t>(ULogMessageType::DATA);
+
+		for (size_t k = 3; k < sizeof(message); ++k) {
+			message[k] = (k % 7 == 0) ? static_cast<uint8_t>(i) : static_cast<uint8_t>(k);
+		}
+
+		while (writer.write_message(LogType::Full, message, sizeof(message)) != 0) {
+			// buffer full: let the writer thread catch up
+			writer.unlock();
+			writer.notify();
+			usleep(1000);
+			writer.lock();
+		}
+
+		payload.insert(payload.end(), message, message + sizeof(message));
+	}
+
+	writer.unlock();
+
+	const size_t total = sizeof(header) + sizeof(flag_bits) + payload.size();
+
+	// wait until everything is written (the file is closed in the same step)
+	writer.stop_log(LogType::Full);
+	bool done = false;
+
+	for (int i = 0; i < 500 && !done; ++i) {
+		writer.notify();
+		usleep(10000);
+		writer.lock();
+		done = writer.get_total_written(LogType::Full) == total;
+		writer.unlock();
+	}
+
+	writer.thread_stop();
+	ASSERT_TRUE(done);
+
+	const std::vector<uint8_t> file = readFile();
+
+	// header and Flags message are stored as is
+	ASSERT_GT(file.size(), sizeof(header) + sizeof(flag_bits));
+	EXPECT_EQ(memcmp(file.data(), &header, sizeof(header)), 0);
+
+	ulog_message_flag_bits_s flag_bits_read;
+	memcpy(&flag_bits_read, file.data() + sizeof(header), sizeof(flag_bits_read));
+	EXPECT_EQ(flag_bits_read.msg_type, static_cast<uint8_t>(ULogMessageType::FLAG_BITS));
+	EXPECT_EQ(flag_bits_read.msg_size, sizeof(flag_bits) - ULOG_MSG_HEADER_LEN);
+	EXPECT_TRUE(flag_bits_read.incompat_flags[0] & ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK);
+
+	// followed by compressed frames
+	std::vector<uint8_t> decompressed;
+	size_t offset = sizeof(header) + sizeof(flag_bits);
+	int num_frames = 0;
+
+	while (offset < file.size()) {
+		ulog_compressed_frame_header_s frame;
+		ASSERT_LE(offset + sizeof(frame), file.size());
+		memcpy(&frame, file.data() + offset, sizeof(frame));
+		offset += sizeof(frame);
+
+		ASSERT_EQ(memcmp(frame.magic, "ULz4", sizeof(frame.magic)), 0);
+		ASSERT_LE(offset + frame.compressed_size, file.size());
+
+		const size_t size_before = decompressed.size();
+
+		if (frame.compressed_size == frame.uncompressed_size) {
+			decompressed.insert(decompressed.end(), file.data() + offset, file.data() + offset + frame.compressed_size);
+
+		} else {
+			ASSERT_LT(frame.compressed_size, frame.uncompressed_size);
+			ASSERT_TRUE(decompressBlock(file.data() + offset, frame.compressed_size, decompressed));
+		}
+
+		EXPECT_EQ(decompressed.size() - size_before, frame.uncompressed_size);
+		offset += frame.compressed_size;
+		++num_frames;
+	}
+
+	EXPECT_GT(num_frames, 1);
+	EXPECT_LT(file.size(), total);
+	ASSERT_EQ(decompressed.size(), payload.size());
+	EXPECT_EQ(memcmp(decompressed.data(), payload.data(), payload.size()), 0);
+}
@@ -0,0 +1,221 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "log_compressor.h"
+#include "messages.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace px4
+{
+namespace logger
+{
+
+// LZ4 block format constants
+static constexpr size_t MIN_MATCH = 4;
+static constexpr size_t LAST_LITERALS = 5; ///< the last 5 bytes are always literals
+static constexpr size_t MF_LIMIT = 12; ///< the last match must start at least 12 bytes before the end
+
+static constexpr size_t compress_bound(size_t size) { return size + size / 255 + 16; }
+
+static constexpr size_t FRAME_BUFFER_SIZE = sizeof(ulog_compressed_frame_header_s) + compress_bound(
+			LogCompressor::MAX_FRAME_SIZE);
+
+static inline uint32_t read32(const uint8_t *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint8_t *write_length(uint8_t *op, size_t length)
+{
+	while (length >= 255) {
+		*op++ = 255;
+		length -= 255;
+	}
+
+	*op++ = (uint8_t)length;
+	return op;
+}
+
+LogCompressor::~LogCompressor()
+{
+	free(_frame);
+	free(_hash_table);
+}
+
+bool LogCompressor::init()
+{
+	if (_frame == nullptr) {
+		_frame = (uint8_t *)malloc(FRAME_BUFFER_SIZE);
+	}
+
+	if (_hash_table == nullptr) {
+		_hash_table = (uint16_t *)malloc(sizeof(uint16_t) << HASH_LOG);
+	}
+
+	return _frame && _hash_table;
+}
+
+size_t LogCompressor::compress(const void *data, size_t size)
+{
+	ulog_compressed_frame_header_s header{};
+	header.magic[0] = 'U';
+	header.magic[1] = 'L';
+	header.magic[2] = 'z';
+	header.magic[3] = '4';
+	header.uncompressed_size = size;
+
+	uint8_t *payload = _frame + sizeof(header);
+
+	// leave at least one byte, so that a compressed block never has the size of the uncompressed data
+	size_t compressed_size = 0;
+
+	if (size > 1) {
+		compressed_size = compress_block((const uint8_t *)data, size, payload, size - 1);
+	}
+
+	if (compressed_size == 0) {
+		// not compressible: store
+		memcpy(payload, data, size);
+		compressed_size = size;
+	}
+
+	header.compressed_size = compressed_size;
+	memcpy(_frame, &header, sizeof(header));
+
+	return sizeof(header) + compressed_size;
+}
+
+size_t LogCompressor::compress_block(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_capacity)
+{
+	const uint8_t *ip = src;
+	const uint8_t *anchor = src; // start of the pending literals
+	const uint8_t *const iend = src + src_size;
+	uint8_t *op = dst;
+	uint8_t *const oend = dst + dst_capacity;
+
+	memset(_hash_table, 0, sizeof(uint16_t) << HASH_LOG);
+
+	if (src_size > MF_LIMIT) {
+		const uint8_t *const mflimit = iend - MF_LIMIT;
+		const uint8_t *const matchlimit = iend - LAST_LITERALS;
+
+		while (ip < mflimit) {
+			const uint32_t sequence = read32(ip);
+			const uint32_t hash = (sequence * 2654435761U) >> (32 - HASH_LOG);
+			const uint8_t *match = src + _hash_table[hash];
+			_hash_table[hash] = (uint16_t)(ip - src);
+
+			if (match >= ip || read32(match) != sequence) {
+				++ip;
+				continue;
+			}
+
+			// extend backwards into the literals, then forward
+			while (ip > anchor && match > src && ip[-1] == match[-1]) {
+				--ip;
+				--match;
+			}
+
+			const uint8_t *match_end = ip + MIN_MATCH;
+			const uint8_t *ref = match + MIN_MATCH;
+
+			while (match_end < matchlimit && *match_end == *ref) {
+				++match_end;
+				++ref;
+			}
+
+			const size_t literals = ip - anchor;
+			const size_t match_length = match_end - ip - MIN_MATCH;
+
+			// token + literal length + literals + offset + match length
+			if ((size_t)(oend - op) < 1 + literals / 255 + 1 + literals + 2 + match_length / 255 + 1) {
+				return 0;
+			}
+
+			uint8_t *token = op++;
+
+			if (literals >= 15) {
+				*token = 15 << 4;
+				op = write_length(op, literals - 15);
+
+			} else {
+				*token = (uint8_t)(literals << 4);
+			}
+
+			memcpy(op, anchor, literals);
+			op += literals;
+
+			const uint16_t offset = (uint16_t)(ip - match);
+			*op++ = offset & 0xff;
+			*op++ = offset >> 8;
+
+			if (match_length >= 15) {
+				*token |= 15;
+				op = write_length(op, match_length - 15);
+
+			} else {
+				*token |= (uint8_t)match_length;
+			}
+
+			ip = anchor = match_end;
+		}
+	}
+
+	// last sequence: literals only
+	const size_t literals = iend - anchor;
+
+	if ((size_t)(oend - op) < 1 + literals / 255 + 1 + literals) {
+		return 0;
+	}
+
+	if (literals >= 15) {
+		*op++ = 15 << 4;
+		op = write_length(op, literals - 15);
+
+	} else {
+		*op++ = (uint8_t)(literals << 4);
+	}
+
+	memcpy(op, anchor, literals);
+	op += literals;
+
+	return op - dst;
+}
+
+}
+}
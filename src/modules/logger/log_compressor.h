@@ -0,0 +1,85 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace px4
+{
+namespace logger
+{
+
+/**
+ * @class LogCompressor
+ * Compresses log data into independent frames (@see ulog_compressed_frame_header_s).
+ *
+ * Each frame is a single LZ4 block (greedy matching, no dictionary between frames), or the data stored
+ * uncompressed if it does not get smaller. The output can be decompressed with Tools/decompress_ulog.py.
+ */
+class LogCompressor
+{
+public:
+	static constexpr size_t MAX_FRAME_SIZE = 16 * 1024; ///< maximum uncompressed data size per frame
+
+	LogCompressor() = default;
+	~LogCompressor();
+
+	bool init();
+
+	/**
+	 * Compress data into a frame, including the frame header.
+	 * @param size data size, at most MAX_FRAME_SIZE
+	 * @return frame size, @see frame()
+	 */
+	size_t compress(const void *data, size_t size);
+
+	const uint8_t *frame() const { return _frame; }
+
+private:
+	static constexpr int HASH_LOG = 12;
+
+	/**
+	 * Compress into an LZ4 block
+	 * @return compressed size, 0 if it does not fit into dst_capacity
+	 */
+	size_t compress_block(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_capacity);
+
+	uint8_t *_frame{nullptr};
+	uint16_t *_hash_table{nullptr};
+};
+
+}
+}
@@ -55,7 +55,7 @@ public:
 	static constexpr Backend BackendMavlink = 1 << 1;
 	static constexpr Backend BackendAll = BackendFile | BackendMavlink;
 
-	LogWriter(Backend configured_backend, size_t file_buffer_size);
+	LogWriter(Backend configured_backend, size_t file_buffer_size, bool file_async_io = false);
 	~LogWriter();
 
 	bool init();
@@ -138,6 +138,25 @@ public:
 		return 0;
 	}
 
+	bool init_compression_file(LogType type)
+	{
+		if (_log_writer_file) { return _log_writer_file->init_compression(type); }
+
+		return false;
+	}
+
+	void start_compression_file(LogType type)
+	{
+		if (_log_writer_file) { _log_writer_file->start_compression(type); }
+	}
+
+	const char *io_backend_str_file(LogType type) const
+	{
+		if (_log_writer_file) { return _log_writer_file->io_backend_str(type); }
+
+		return "";
+	}
+
 	pthread_t thread_id_file() const
 	{
 		if (_log_writer_file) { return _log_writer_file->thread_id(); }
@@ -55,19 +55,27 @@ namespace logger
 {
 constexpr size_t LogWriterFile::_min_write_chunk;
 
-LogWriterFile::LogWriterFile(size_t buffer_size)
-	: _buffers{
+LogWriterFile::LogWriterFile(size_t buffer_size, bool async_io)
+	: _io_uring(async_io && IoUringFile::supported()),
+	  _buffers{
 	//We always write larger chunks (orb messages) to the buffer, so the buffer
 	//needs to be larger than the minimum write chunk (300 is somewhat arbitrary)
 	{
 		math::max(buffer_size, _min_write_chunk + 300),
-		perf_alloc(PC_ELAPSED, "logger_sd_write"), perf_alloc(PC_ELAPSED, "logger_sd_fsync")},
+		// separate counters per backend, for the io_uring backend they measure the time until completion
+		perf_alloc(PC_ELAPSED, _io_uring ? "logger_sd_write_uring" : "logger_sd_write"),
+		perf_alloc(PC_ELAPSED, _io_uring ? "logger_sd_fsync_uring" : "logger_sd_fsync"),
+		_io_uring},
 
 	{
 		300, // buffer size for the mission log (can be kept fairly small)
 		perf_alloc(PC_ELAPSED, "logger_sd_write_mission"), perf_alloc(PC_ELAPSED, "logger_sd_fsync_mission")}
 }
 {
+	if (async_io && !_io_uring) {
+		PX4_WARN("io_uring not available, using blocking writes");
+	}
+
 	pthread_mutex_init(&_mtx, nullptr);
 	pthread_cond_init(&_cv, nullptr);
 }
@@ -286,6 +294,25 @@ int LogWriterFile::hardfault_store_filename(const char *log_file)
 	return 0;
 }
 
+bool LogWriterFile::init_compression(LogType type)
+{
+#if defined(PX4_CRYPTO)
+
+	if (_algorithm != CRYPTO_NONE) {
+		PX4_WARN("log compression is not supported with encryption");
+		return false;
+	}
+
+#endif
+
+	return _buffers[(int)type].init_compression();
+}
+
+void LogWriterFile::start_compression(LogType type)
+{
+	_buffers[(int)type].start_compression();
+}
+
 void LogWriterFile::stop_log(LogType type)
 {
 	lock();
@@ -577,18 +604,25 @@ const char *log_type_str(LogType type)
 }
 
 LogWriterFile::LogFileBuffer::LogFileBuffer(size_t log_buffer_size, perf_counter_t perf_write,
-		perf_counter_t perf_fsync)
+		perf_counter_t perf_fsync, bool io_uring)
 	: _buffer_size(log_buffer_size), _perf_write(perf_write), _perf_fsync(perf_fsync)
 {
+	if (io_uring) {
+		_io_uring_file = new IoUringFile(perf_write, perf_fsync);
+	}
 }
 
 LogWriterFile::LogFileBuffer::~LogFileBuffer()
 {
-	if (_fd >= 0) {
+	if (_io_uring_file) {
+		delete _io_uring_file;
+
+	} else if (_fd >= 0) {
 		close(_fd);
 	}
 
 	free(_buffer);
+	delete _compressor;
 
 	perf_free(_perf_write);
 	perf_free(_perf_fsync);
@@ -621,23 +655,61 @@ size_t LogWriterFile::LogFileBuffer::get_read_ptr(void **ptr, bool *is_part)
 {
 	// bytes available to read
 	int read_ptr = _head - _count;
+	size_t available;
 
 	if (read_ptr < 0) {
 		read_ptr += _buffer_size;
 		*ptr = &_buffer[read_ptr];
 		*is_part = true;
-		return _buffer_size - read_ptr;
+		available = _buffer_size - read_ptr;
 
 	} else {
 		*ptr = &_buffer[read_ptr];
 		*is_part = false;
-		return _count;
+		available = _count;
+	}
+
+	// do not write uncompressed and compressed data at once
+	_read_compressed = _total_written >= _compress_from;
+
+	if (!_read_compressed && _total_written + available > _compress_from) {
+		available = _compress_from - _total_written;
+		*is_part = true;
+	}
+
+	return available;
+}
+
+bool LogWriterFile::LogFileBuffer::init_compression()
+{
+	if (_compressor == nullptr) {
+		_compressor = new LogCompressor();
+	}
+
+	if (_compressor == nullptr || !_compressor->init()) {
+		PX4_ERR("Can't create log compressor");
+		return false;
+	}
+
+	return true;
+}
+
+void LogWriterFile::LogFileBuffer::start_compression()
+{
+	if (_compressor) {
+		// everything written from now on
+		_compress_from = _total_written + _count;
 	}
 }
 
 bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 {
-	_fd = ::open(filename, O_CREAT | O_WRONLY, PX4_O_MODE_666);
+	if (_io_uring_file) {
+		_fd = _io_uring_file->open(filename);
+
+	} else {
+		_fd = ::open(filename, O_CREAT | O_WRONLY, PX4_O_MODE_666);
+	}
 
 	if (_fd < 0) {
 		PX4_ERR("Can't open log file %s, errno: %d", filename, errno);
@@ -649,7 +721,14 @@ bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 
 		if (_buffer == nullptr) {
 			PX4_ERR("Can't create log buffer");
-			::close(_fd);
+
+			if (_io_uring_file) {
+				_io_uring_file->close();
+
+			} else {
+				::close(_fd);
+			}
+
 			_fd = -1;
 			return false;
 		}
@@ -659,6 +738,8 @@ bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 	_head = 0;
 	_count = 0;
 	_total_written = 0;
+	_file_size = 0;
+	_compress_from = SIZE_MAX;
 
 	_should_run = true;
 
@@ -667,16 +748,59 @@ bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 
 void LogWriterFile::LogFileBuffer::fsync() const
 {
+	if (_io_uring_file) {
+		_io_uring_file->fsync();
+		return;
+	}
+
 	perf_begin(_perf_fsync);
 	::fsync(_fd);
 	perf_end(_perf_fsync);
 }
 
-ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t size, bool call_fsync) const
+ssize_t LogWriterFile::LogFileBuffer::write_raw(const void *buffer, size_t size)
 {
-	perf_begin(_perf_write);
-	ssize_t ret = ::write(_fd, buffer, size);
-	perf_end(_perf_write);
+	ssize_t ret;
+
+	if (_io_uring_file) {
+		ret = _io_uring_file->write(buffer, size);
+
+	} else {
+		perf_begin(_perf_write);
+		ret = ::write(_fd, buffer, size);
+		perf_end(_perf_write);
+	}
+
+	if (ret > 0) {
+		_file_size += ret;
+	}
+
+	return ret;
+}
+
+ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t size, bool call_fsync)
+{
+	ssize_t ret = 0;
+
+	if (_read_compressed && _compressor) {
+		const uint8_t *data = (const uint8_t *)buffer;
+
+		while (ret < (ssize_t)size) {
+			const size_t frame_data_size = math::min(size - ret, LogCompressor::MAX_FRAME_SIZE);
+			const size_t frame_size = _compressor->compress(data + ret, frame_data_size);
+
+			// a partially written frame cannot be continued
+			if (write_raw(_compressor->frame(), frame_size) != (ssize_t)frame_size) {
+				ret = -1;
+				break;
+			}
+
+			ret += frame_data_size;
+		}
+
+	} else {
+		ret = write_raw(buffer, size);
+	}
 
 	if (call_fsync) {
 		fsync();
@@ -691,17 +815,31 @@ void LogWriterFile::LogFileBuffer::close_file()
 	_count = 0;
 
 	if (_fd >= 0) {
-		int res = close(_fd);
+		int res = _io_uring_file ? _io_uring_file->close() : close(_fd);
 		_fd = -1;
 
 		if (res) {
 			PX4_WARN("closing log file failed (%i)", errno);
 
 		} else {
-			PX4_INFO("closed logfile, bytes written: %zu", _total_written);
+			if (_file_size != _total_written) {
+				PX4_INFO("closed logfile, bytes written: %zu (compressed: %zu)", _total_written, _file_size);
+
+			} else {
+				PX4_INFO("closed logfile, bytes written: %zu", _total_written);
+			}
 		}
 	}
 }
 
+const char *LogWriterFile::LogFileBuffer::io_backend_str() const
+{
+	if (_io_uring_file) {
+		return _io_uring_file->direct_io() ? "io_uring (O_DIRECT)" : "io_uring";
+	}
+
+	return "write";
+}
+
 }
 }
@@ -41,6 +41,9 @@
 #include <perf/perf_counter.h>
 #include <px4_platform_common/crypto.h>
 
+#include "io_uring_file.h"
+#include "log_compressor.h"
+
 namespace px4
 {
 namespace logger
@@ -66,7 +69,10 @@ const char *log_type_str(LogType type);
 class LogWriterFile
 {
 public:
-	LogWriterFile(size_t buffer_size);
+	/**
+	 * @param async_io write the full log with io_uring (Linux only, falls back to blocking writes)
+	 */
+	LogWriterFile(size_t buffer_size, bool async_io = false);
 	~LogWriterFile();
 
 	bool init();
@@ -83,6 +89,18 @@ public:
 
 	void stop_log(LogType type);
 
+	/**
+	 * Allocate the compressor, so that start_compression() cannot fail.
+	 * @return true if compression can be used
+	 */
+	bool init_compression(LogType type);
+
+	/**
+	 * Compress all data written from now on (in the writer thread). Must be called with the lock held,
+	 * after a successful init_compression().
+	 */
+	void start_compression(LogType type);
+
 	bool is_started(LogType type) const { return _buffers[(int)type]._should_run; }
 
 	/** @see LogWriter::write_message() */
@@ -130,6 +148,11 @@ public:
 
 	pthread_t thread_id() const { return _thread; }
 
+	/**
+	 * name of the file I/O backend in use
+	 */
+	const char *io_backend_str(LogType type) const { return _buffers[(int)type].io_backend_str(); }
+
 #if defined(PX4_CRYPTO)
 	void set_encryption_parameters(px4_crypto_algorithm_t algorithm, uint8_t key_idx,  uint8_t exchange_key_idx)
 	{
@@ -163,7 +186,7 @@ private:
 	class LogFileBuffer
 	{
 	public:
-		LogFileBuffer(size_t log_buffer_size, perf_counter_t perf_write, perf_counter_t perf_fsync);
+		LogFileBuffer(size_t log_buffer_size, perf_counter_t perf_write, perf_counter_t perf_fsync, bool io_uring = false);
 
 		~LogFileBuffer();
 
@@ -182,7 +205,11 @@ private:
 
 		int fd() const { return _fd; }
 
-		inline ssize_t write_to_file(const void *buffer, size_t size, bool call_fsync) const;
+		/**
+		 * Write data, compressed if it is after the start of compression
+		 * @return number of bytes from buffer that were written, -1 on error
+		 */
+		inline ssize_t write_to_file(const void *buffer, size_t size, bool call_fsync);
 
 		inline void fsync() const;
 
@@ -192,6 +219,11 @@ private:
 		size_t buffer_size() const { return _buffer_size; }
 		size_t count() const { return _count; }
 
+		const char *io_backend_str() const;
+
+		bool init_compression();
+		void start_compression();
+
 		bool _should_run = false;
 	private:
 		const size_t _buffer_size;
@@ -202,8 +234,17 @@ private:
 		size_t _total_written = 0;
 		perf_counter_t _perf_write;
 		perf_counter_t _perf_fsync;
+		IoUringFile *_io_uring_file{nullptr}; ///< nullptr for blocking writes
+		LogCompressor *_compressor{nullptr};
+		size_t _compress_from = SIZE_MAX; ///< compress data after this many bytes
+		bool _read_compressed = false; ///< whether the data returned by get_read_ptr() needs to be compressed
+		size_t _file_size = 0; ///< bytes written to the file
+
+		ssize_t write_raw(const void *buffer, size_t size);
 	};
 
+	const bool _io_uring; ///< full log is written with io_uring
+
 	LogFileBuffer _buffers[(int)LogType::Count];
 
 	px4::atomic_bool	_exit_thread{false};
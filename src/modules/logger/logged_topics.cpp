@@ -87,6 +87,7 @@ void LoggedTopics::add_default_topics()
 	add_topic("offboard_control_mode", 100);
 	add_topic("onboard_computer_status", 10);
 	add_topic("parameter_update");
+	add_optional_topic("perf_counter_delta");
 	add_topic("position_controller_status", 500);
 	add_topic("position_controller_landing_status", 100);
 	add_topic("position_setpoint_triplet", 200);
@@ -123,6 +124,7 @@ void LoggedTopics::add_default_topics()
 	add_topic("vehicle_status");
 	add_optional_topic("vtol_vehicle_status", 200);
 	add_topic("wind", 1000);
+	add_optional_topic("work_item_stats");
 
 	// multi topics
 	add_optional_topic_multi("actuator_outputs", 100, 3);
@@ -358,12 +360,12 @@ void LoggedTopics::add_vision_and_avoidance_topics()
 
 void LoggedTopics::add_raw_imu_gyro_fifo()
 {
-	add_topic("sensor_gyro_fifo");
+	add_drained_topic("sensor_gyro_fifo");
 }
 
 void LoggedTopics::add_raw_imu_accel_fifo()
 {
-	add_topic("sensor_accel_fifo");
+	add_drained_topic("sensor_accel_fifo");
 }
 
 void LoggedTopics::add_system_identification_topics()
@@ -520,6 +522,23 @@ bool LoggedTopics::add_topic(const char *name, uint16_t interval_ms, uint8_t ins
 	return success;
 }
 
+bool LoggedTopics::add_drained_topic(const char *name, uint8_t instance)
+{
+	if (!add_topic(name, 0, instance)) {
+		return false;
+	}
+
+	for (int i = 0; i < _subscriptions.count; ++i) {
+		RequestedSubscription &sub = _subscriptions.sub[i];
+
+		if (sub.instance == instance && strcmp(name, get_orb_meta(sub.id)->o_name) == 0) {
+			sub.drain = true;
+		}
+	}
+
+	return true;
+}
+
 bool LoggedTopics::add_topic_multi(const char *name, uint16_t interval_ms, uint8_t max_num_instances, bool optional)
 {
 	// add all possible instances
@@ -83,6 +83,7 @@ public:
 		uint16_t interval_ms;
 		uint8_t instance;
 		ORB_ID id{ORB_ID::INVALID};
+		bool drain{false}; ///< log every queued message, not only the latest one
 	};
 	struct RequestedSubscriptionArray {
 		RequestedSubscription sub[MAX_TOPICS_NUM];
@@ -143,6 +144,15 @@ private:
 		return add_topic_multi(name, interval_ms, max_num_instances, true);
 	}
 
+	/**
+	 * Add a (queued) topic to be logged without losing any message: on each logger iteration
+	 * all the messages in the queue are written, and the queue is grown if it still overflows.
+	 * @param name topic name
+	 * @param instance orb topic instance
+	 * @return true on success
+	 */
+	bool add_drained_topic(const char *name, uint8_t instance = 0);
+
 	/**
 	 * Parse a file containing a list of uORB topics to log, calling add_topic for each
 	 * @param fname name of file
@@ -184,8 +184,8 @@ int Logger::task_spawn(int argc, char *argv[])
 int Logger::print_status()
 {
 	PX4_INFO("Running in mode: %s", configured_backend_mode());
-	PX4_INFO("Number of subscriptions: %i (%i bytes)", _num_subscriptions,
-		 (int)(_num_subscriptions * sizeof(LoggerSubscription)));
+	PX4_INFO("Number of subscriptions: %i (%i bytes)%s", _num_subscriptions,
+		 (int)(_num_subscriptions * sizeof(LoggerSubscription)), _event_driven ? ", event-driven" : "");
 
 	bool is_logging = false;
 
@@ -226,7 +226,8 @@ void Logger::print_statistics(LogType type)
 	float mebibytes = kibibytes / 1024.0f;
 	float seconds = ((float)(hrt_absolute_time() - stats.start_time_file)) / 1000000.0f;
 
-	PX4_INFO("Log file: %s/%s/%s", LOG_ROOT[(int)type], _file_name[(int)type].log_dir, _file_name[(int)type].log_file_name);
+	PX4_INFO("Log file: %s/%s/%s (%s)", LOG_ROOT[(int)type], _file_name[(int)type].log_dir,
+		 _file_name[(int)type].log_file_name, _writer.io_backend_str_file(type));
 
 	if (mebibytes < 0.1f) {
 		PX4_INFO("Wrote %4.2f KiB (avg %5.2f KiB/s)", (double)kibibytes, (double)(kibibytes / seconds));
@@ -250,6 +251,8 @@ Logger *Logger::instantiate(int argc, char *argv[])
 	Logger::LogMode log_mode = Logger::LogMode::while_armed;
 	bool error_flag = false;
 	bool log_name_timestamp = false;
+	bool async_file_io = false;
+	bool event_driven = false;
 	LogWriter::Backend backend = LogWriter::BackendAll;
 	const char *poll_topic = nullptr;
 
@@ -257,7 +260,7 @@ Logger *Logger::instantiate(int argc, char *argv[])
 	int ch;
 	const char *myoptarg = nullptr;
 
-	while ((ch = px4_getopt(argc, argv, "r:b:etfm:p:xc:", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "r:b:etfm:p:xc:au", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'r': {
 				unsigned long r = strtoul(myoptarg, nullptr, 10);
@@ -306,6 +309,14 @@ Logger *Logger::instantiate(int argc, char *argv[])
 			log_name_timestamp = true;
 			break;
 
+		case 'a':
+			async_file_io = true;
+			break;
+
+		case 'u':
+			event_driven = true;
+			break;
+
 
 		case 'm':
 			if (!strcmp(myoptarg, "file")) {
@@ -344,7 +355,7 @@ Logger *Logger::instantiate(int argc, char *argv[])
 	}
 
 	Logger *logger = new Logger(backend, log_buffer_size, log_interval, poll_topic, log_mode, log_name_timestamp,
-				    rate_factor);
+				    rate_factor, async_file_io);
 
 #if defined(DBGPRINT) && defined(__PX4_NUTTX)
 	struct mallinfo alloc_info = mallinfo();
@@ -366,18 +377,20 @@ Logger *Logger::instantiate(int argc, char *argv[])
 
 #endif /* __PX4_NUTTX */
 
+		logger->setEventDriven(event_driven);
+
 	}
 
 	return logger;
 }
 
 Logger::Logger(LogWriter::Backend backend, size_t buffer_size, uint32_t log_interval, const char *poll_topic_name,
-	       LogMode log_mode, bool log_name_timestamp, float rate_factor) :
+	       LogMode log_mode, bool log_name_timestamp, float rate_factor, bool async_file_io) :
 	ModuleParams(nullptr),
 	_log_mode(log_mode),
 	_log_name_timestamp(log_name_timestamp),
 	_event_subscription(ORB_ID::event),
-	_writer(backend, buffer_size),
+	_writer(backend, buffer_size, async_file_io),
 	_log_interval(log_interval),
 	_rate_factor(rate_factor)
 {
@@ -404,6 +417,16 @@ Logger::~Logger()
 	}
 
 	delete[](_msg_buffer);
+
+	if (_update_callbacks) {
+		for (int i = 0; i < _num_subscriptions; ++i) {
+			delete _update_callbacks[i];
+		}
+
+		delete[](_update_callbacks);
+	}
+
+	delete[](_updated_topics);
 	delete[](_subscriptions);
 }
 
@@ -445,6 +468,16 @@ bool Logger::copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe)
 			if (updated && (sub.get_last_generation() != last_generation + 1)) {
 				// error, missed a message
 				_message_gaps++;
+
+				// drained topics: grow the queue so that it can hold all the messages of a logging interval.
+				// Topics without queue are not grown, as this would change what their other subscribers read.
+				const uint8_t queue_size = sub.get_queue_size();
+
+				if (sub.drain && queue_size > 1 && queue_size < MAX_DRAIN_QUEUE_SIZE) {
+					if (sub.grow_queue(queue_size * 2)) {
+						PX4_DEBUG("%s: queue size increased to %i", sub.get_topic()->o_name, queue_size * 2);
+					}
+				}
 			}
 
 		} else {
@@ -459,6 +492,8 @@ bool Logger::copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe)
 				write_add_logged_msg(LogType::Mission, sub);
 			}
 
+			register_update_callback(sub_idx);
+
 			// copy first data
 			updated = sub.copy(buffer);
 		}
@@ -467,6 +502,93 @@ bool Logger::copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe)
 	return updated;
 }
 
+bool Logger::write_topic_update(int sub_idx, bool try_to_subscribe, hrt_abstime loop_time, uint32_t &total_bytes)
+{
+	LoggerSubscription &sub = _subscriptions[sub_idx];
+
+	/* if this topic has been updated, copy the new data into the message buffer
+	 * and write a message to the log
+	 */
+	if (!copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_s), try_to_subscribe)) {
+		return false;
+	}
+
+	write_topic_message(sub_idx, loop_time, total_bytes);
+
+	if (sub.drain) {
+		// write the rest of the queue as well (bounded, in case the publisher is faster than the logger)
+		for (int i = 1; i < MAX_DRAIN_QUEUE_SIZE; ++i) {
+			if (!copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_s), false)) {
+				break;
+			}
+
+			write_topic_message(sub_idx, loop_time, total_bytes);
+		}
+	}
+
+	return true;
+}
+
+void Logger::write_topic_message(int sub_idx, hrt_abstime loop_time, uint32_t &total_bytes)
+{
+	LoggerSubscription &sub = _subscriptions[sub_idx];
+
+	// each message consists of a header followed by an orb data object
+	const size_t msg_size = sizeof(ulog_message_data_s) + sub.get_topic()->o_size_no_padding;
+	const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
+	const uint16_t write_msg_id = sub.msg_id;
+
+	//write one byte after another (necessary because of alignment)
+	_msg_buffer[0] = (uint8_t)write_msg_size;
+	_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
+	_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
+	_msg_buffer[3] = (uint8_t)write_msg_id;
+	_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+
+	// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
+
+	// full log
+	if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+
+#ifdef DBGPRINT
+		total_bytes += msg_size;
+#endif /* DBGPRINT */
+	}
+
+	// mission log
+	if (sub_idx < _num_mission_subs) {
+		if (_writer.is_started(LogType::Mission)) {
+			if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
+				unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
+
+				if (delta_time > 0) {
+					_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
+				}
+
+				write_message(LogType::Mission, _msg_buffer, msg_size);
+			}
+		}
+	}
+}
+
+void Logger::register_update_callback(int sub_idx)
+{
+	if (!_update_callbacks || !_update_callbacks[sub_idx] || _update_callbacks[sub_idx]->registered()) {
+		return;
+	}
+
+	LoggerUpdateCallback *callback = _update_callbacks[sub_idx];
+
+	// the topic exists, as the logger subscription is valid
+	if (callback->subscribe() && callback->registerCallback()) {
+		// the topic might already have data
+		callback->call();
+
+	} else {
+		PX4_ERR("failed to register callback for %s", _subscriptions[sub_idx].get_topic()->o_name);
+	}
+}
+
 const char *Logger::configured_backend_mode() const
 {
 	switch (_writer.backend()) {
@@ -550,11 +672,33 @@ bool Logger::initialize_topics()
 		for (int i = 0; i < logged_topics.subscriptions().count; ++i) {
 			const LoggedTopics::RequestedSubscription &sub = logged_topics.subscriptions().sub[i];
 			_subscriptions[i] = LoggerSubscription(sub.id, sub.interval_ms, sub.instance);
+			_subscriptions[i].drain = sub.drain;
 			_subscriptions[i].subscribe();
 		}
 	}
 
 	_num_subscriptions = logged_topics.subscriptions().count;
+
+	if (_event_driven && _num_subscriptions > 0) {
+		_updated_topics = new px4::atomic<uint32_t>[(_num_subscriptions + 31) / 32]();
+		_update_callbacks = new LoggerUpdateCallback*[_num_subscriptions];
+
+		if (!_updated_topics || !_update_callbacks) {
+			PX4_ERR("alloc failed");
+			return false;
+		}
+
+		for (int i = 0; i < _num_subscriptions; ++i) {
+			const LoggedTopics::RequestedSubscription &sub = logged_topics.subscriptions().sub[i];
+			_update_callbacks[i] = new LoggerUpdateCallback(get_orb_meta(sub.id), sub.instance, _updated_topics[i / 32],
+					1u << (i % 32));
+
+			if (_subscriptions[i].valid()) {
+				register_update_callback(i);
+			}
+		}
+	}
+
 	return true;
 }
 
@@ -739,51 +883,34 @@ void Logger::run()
 			/* wait for lock on log buffer */
 			_writer.lock();
 
-			for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
-				LoggerSubscription &sub = _subscriptions[sub_idx];
-				/* if this topic has been updated, copy the new data into the message buffer
-				 * and write a message to the log
-				 */
-				const bool try_to_subscribe = (sub_idx == next_subscribe_topic_index);
-
-				if (copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_s), try_to_subscribe)) {
-					// each message consists of a header followed by an orb data object
-					const size_t msg_size = sizeof(ulog_message_data_s) + sub.get_topic()->o_size_no_padding;
-					const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
-					const uint16_t write_msg_id = sub.msg_id;
-
-					//write one byte after another (necessary because of alignment)
-					_msg_buffer[0] = (uint8_t)write_msg_size;
-					_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
-					_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
-					_msg_buffer[3] = (uint8_t)write_msg_id;
-					_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
-
-					// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
-
-					// full log
-					if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+			if (_event_driven) {
+				// topics that are not subscribed yet do not have a callback
+				if (next_subscribe_topic_index != -1 && !_subscriptions[next_subscribe_topic_index].valid()) {
+					write_topic_update(next_subscribe_topic_index, true, loop_time, total_bytes);
+				}
 
-#ifdef DBGPRINT
-						total_bytes += msg_size;
-#endif /* DBGPRINT */
-					}
+				for (int i = 0; i < (_num_subscriptions + 31) / 32; ++i) {
+					uint32_t updated = _updated_topics[i].fetch_and(0);
 
-					// mission log
-					if (sub_idx < _num_mission_subs) {
-						if (_writer.is_started(LogType::Mission)) {
-							if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
-								unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
+					while (updated != 0) {
+						const int bit = __builtin_ctz(updated);
+						const uint32_t mask = 1u << bit;
+						const int sub_idx = i * 32 + bit;
+						updated &= ~mask;
 
-								if (delta_time > 0) {
-									_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
-								}
+						write_topic_update(sub_idx, false, loop_time, total_bytes);
 
-								write_message(LogType::Mission, _msg_buffer, msg_size);
-							}
+						if (_subscriptions[sub_idx].new_data_available()) {
+							// limited by the logging interval or more messages queued: check again in the next iteration
+							_updated_topics[i].fetch_or(mask);
 						}
 					}
 				}
+
+			} else {
+				for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
+					write_topic_update(sub_idx, sub_idx == next_subscribe_topic_index, loop_time, total_bytes);
+				}
 			}
 
 			// check for new events
@@ -867,8 +994,9 @@ void Logger::run()
 			// - we avoid subscribing to many topics at once, when logging starts
 			// - we'll get the data immediately once we start logging (no need to wait for the next subscribe timeout)
 			if (next_subscribe_topic_index != -1) {
-				if (!_subscriptions[next_subscribe_topic_index].valid()) {
-					_subscriptions[next_subscribe_topic_index].subscribe();
+				if (!_subscriptions[next_subscribe_topic_index].valid()
+				    && _subscriptions[next_subscribe_topic_index].subscribe()) {
+					register_update_callback(next_subscribe_topic_index);
 				}
 
 				if (++next_subscribe_topic_index >= _num_subscriptions) {
@@ -1408,7 +1536,7 @@ void Logger::start_log_file(LogType type)
 	_writer.select_write_backend(LogWriter::BackendFile);
 	_writer.set_need_reliable_transfer(true);
 
-	write_header(type);
+	write_header(type, type == LogType::Full && _param_sdlog_compress.get());
 	write_version(type);
 	write_formats(type);
 
@@ -1504,6 +1632,7 @@ void Logger::stop_log_mavlink()
 struct perf_callback_data_t {
 	Logger *logger;
 	int counter;
+	int histogram_counter;
 	bool preflight;
 	char *buffer;
 };
@@ -1526,6 +1655,19 @@ void Logger::perf_iterate_callback(perf_counter_t handle, void *user)
 
 	callback_data->logger->write_info_multiple(LogType::Full, perf_name, buffer, callback_data->counter != 0);
 	++callback_data->counter;
+
+	// raw buckets of histogram counters (PC_HISTOGRAM), to get the full distribution
+	if (perf_print_histogram_buffer(buffer, buffer_length, handle) > 0) {
+		if (callback_data->preflight) {
+			perf_name = "perf_histogram_preflight";
+
+		} else {
+			perf_name = "perf_histogram_postflight";
+		}
+
+		callback_data->logger->write_info_multiple(LogType::Full, perf_name, buffer, callback_data->histogram_counter != 0);
+		++callback_data->histogram_counter;
+	}
 }
 
 void Logger::write_perf_data(bool preflight)
@@ -1533,6 +1675,7 @@ void Logger::write_perf_data(bool preflight)
 	perf_callback_data_t callback_data = {};
 	callback_data.logger = this;
 	callback_data.counter = 0;
+	callback_data.histogram_counter = 0;
 	callback_data.preflight = preflight;
 
 	// write the perf counters
@@ -1983,7 +2126,7 @@ void Logger::write_excluded_optional_topics(LogType type)
 	}
 }
 
-void Logger::write_header(LogType type)
+void Logger::write_header(LogType type, bool compress)
 {
 	ulog_file_header_s header = {};
 	header.magic[0] = 'U';
@@ -2003,11 +2146,23 @@ void Logger::write_header(LogType type)
 
 	flag_bits.compat_flags[0] = ULOG_COMPAT_FLAG0_DEFAULT_PARAMETERS_MASK;
 
+	// only set the flag if compression can be started
+	const bool compressed = compress && _writer.init_compression_file(type);
+
+	if (compressed) {
+		flag_bits.incompat_flags[0] |= ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK;
+	}
+
 	flag_bits.msg_size = sizeof(flag_bits) - ULOG_MSG_HEADER_LEN;
 	flag_bits.msg_type = static_cast<uint8_t>(ULogMessageType::FLAG_BITS);
 
 	write_message(type, &flag_bits, sizeof(flag_bits));
 
+	// everything after the (uncompressed) Flags message is compressed
+	if (compressed) {
+		_writer.start_compression_file(type);
+	}
+
 	_writer.unlock();
 }
 
@@ -2408,6 +2563,9 @@ $ logger on
 	PRINT_MODULE_USAGE_PARAM_FLAG('e', "Enable logging right after start until disarm (otherwise only when armed)", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('f', "Log until shutdown (implies -e)", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('t', "Use date/time for naming log directories and files", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('u', "Only check published topics (uORB update callbacks) instead of all topics in each iteration",
+				      true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('a', "Write the log file asynchronously with io_uring and O_DIRECT (Linux only)", true);
 	PRINT_MODULE_USAGE_PARAM_INT('r', 280, 0, 8000, "Log rate in Hz, 0 means unlimited rate", true);
 	PRINT_MODULE_USAGE_PARAM_INT('b', 12, 4, 10000, "Log buffer size in KiB", true);
 	PRINT_MODULE_USAGE_PARAM_STRING('p', nullptr, "<topic_name>",
@@ -38,6 +38,7 @@
 #include "messages.h"
 #include <containers/Array.hpp>
 #include "util.h"
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
 #include <drivers/drv_hrt.h>
 #include <version/version.h>
@@ -48,6 +49,7 @@
 
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
 #include <uORB/SubscriptionInterval.hpp>
 #include <uORB/topics/logger_status.h>
 #include <uORB/topics/log_message.h>
@@ -78,6 +80,35 @@ struct LoggerSubscription : public uORB::SubscriptionInterval {
 	{}
 
 	uint8_t msg_id{MSG_ID_INVALID};
+	bool drain{false}; ///< write all queued messages, see LoggedTopics::add_drained_topic()
+
+	/**
+	 * Check for new data, ignoring the interval
+	 */
+	bool new_data_available() { return _subscription.updated(); }
+
+	uint8_t get_queue_size() const { return _subscription.get_queue_size(); }
+
+	bool grow_queue(uint8_t queue_size) { return _subscription.grow_queue(queue_size); }
+};
+
+/**
+ * Marks a logged topic as updated on each publication (event-driven topic collection)
+ */
+class LoggerUpdateCallback : public uORB::SubscriptionCallback
+{
+public:
+	LoggerUpdateCallback(const orb_metadata *meta, uint8_t instance, px4::atomic<uint32_t> &updated, uint32_t mask) :
+		uORB::SubscriptionCallback(meta, 0, instance),
+		_updated(updated),
+		_mask(mask)
+	{}
+
+	void call() override { _updated.fetch_or(_mask); }
+
+private:
+	px4::atomic<uint32_t> &_updated;
+	const uint32_t _mask;
 };
 
 class Logger : public ModuleBase<Logger>, public ModuleParams
@@ -91,7 +122,7 @@ public:
 	};
 
 	Logger(LogWriter::Backend backend, size_t buffer_size, uint32_t log_interval, const char *poll_topic_name,
-	       LogMode log_mode, bool log_name_timestamp, float rate_factor);
+	       LogMode log_mode, bool log_name_timestamp, float rate_factor, bool async_file_io);
 
 	~Logger();
 
@@ -120,6 +151,12 @@ public:
 	 */
 	void setReplayFile(const char *file_name);
 
+	/**
+	 * Only check topics that got published, using uORB update callbacks, instead of
+	 * checking all topics in each iteration. This must be called before starting the logger.
+	 */
+	void setEventDriven(bool event_driven) { _event_driven = event_driven; }
+
 	/**
 	 * request the logger thread to stop (this method does not block).
 	 * @return true if the logger is stopped, false if (still) running
@@ -140,6 +177,7 @@ private:
 
 	static constexpr int		MAX_MISSION_TOPICS_NUM = 5; /**< Maximum number of mission topics */
 	static constexpr unsigned	MAX_NO_LOGFILE = 999;	/**< Maximum number of log files */
+	static constexpr uint8_t	MAX_DRAIN_QUEUE_SIZE = 128; /**< Maximum queue size of drained topics (uORB limit) */
 	static constexpr const char	*LOG_ROOT[(int)LogType::Count] = {
 		PX4_STORAGEDIR "/log",
 		PX4_STORAGEDIR "/mission_log"
@@ -216,8 +254,9 @@ private:
 
 	/**
 	 * write the file header with file magic and timestamp.
+	 * @param compress compress everything after the Flags message (file backend only)
 	 */
-	void write_header(LogType type);
+	void write_header(LogType type, bool compress = false);
 
 	/// Array to store written formats for nested definitions (only)
 	using WrittenFormats = Array < const orb_metadata *, 20 >;
@@ -269,6 +308,24 @@ private:
 
 	inline bool copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe);
 
+	/**
+	 * Copy a topic if updated and write it to the full and mission log.
+	 * For drained topics all queued messages are written.
+	 * Must be called with _writer.lock() held.
+	 * @return true if the topic was updated
+	 */
+	bool write_topic_update(int sub_idx, bool try_to_subscribe, hrt_abstime loop_time, uint32_t &total_bytes);
+
+	/**
+	 * Write the topic data in _msg_buffer (filled by copy_if_updated()) to the full and mission log.
+	 */
+	void write_topic_message(int sub_idx, hrt_abstime loop_time, uint32_t &total_bytes);
+
+	/**
+	 * Register the update callback of a (subscribed) topic for the event-driven mode
+	 */
+	void register_update_callback(int sub_idx);
+
 	/**
 	 * Write exactly one ulog message to the logger and handle dropouts.
 	 * Must be called with _writer.lock() held.
@@ -341,6 +398,9 @@ private:
 
 	LoggerSubscription	 			*_subscriptions{nullptr}; ///< all subscriptions for full & mission log (in front)
 	int						_num_subscriptions{0};
+	bool						_event_driven{false};
+	LoggerUpdateCallback				**_update_callbacks{nullptr}; ///< per subscription, event-driven mode only
+	px4::atomic<uint32_t>				*_updated_topics{nullptr}; ///< bitset of updated subscriptions, event-driven mode only
 	MissionSubscription 				_mission_subscriptions[MAX_MISSION_TOPICS_NUM] {}; ///< additional data for mission subscriptions
 	int						_num_mission_subs{0};
 	LoggerSubscription				_event_subscription; ///< Subscription for the event topic (handled separately)
@@ -382,7 +442,8 @@ private:
 		(ParamInt<px4::params::SDLOG_PROFILE>) _param_sdlog_profile,
 		(ParamInt<px4::params::SDLOG_MISSION>) _param_sdlog_mission,
 		(ParamBool<px4::params::SDLOG_BOOT_BAT>) _param_sdlog_boot_bat,
-		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid
+		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid,
+		(ParamBool<px4::params::SDLOG_COMPRESS>) _param_sdlog_compress
 #if defined(PX4_CRYPTO)
 		, (ParamInt<px4::params::SDLOG_ALGORITHM>) _param_sdlog_crypto_algorithm,
 		(ParamInt<px4::params::SDLOG_KEY>) _param_sdlog_crypto_key,
@@ -282,6 +282,7 @@ struct ulog_message_parameter_default_s {
 
 
 #define ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK (1<<0)
+#define ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK (1<<1) ///< all data after the Flags message is in compressed frames
 
 #define ULOG_COMPAT_FLAG0_DEFAULT_PARAMETERS_MASK (1<<0)
 
@@ -294,4 +295,19 @@ struct ulog_message_flag_bits_s {
 	uint64_t appended_offsets[3]; ///< file offset(s) for appended data if ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK is set
 };
 
+/**
+ * @brief Compressed frame header
+ *
+ * If ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK is set, the Flags message is followed by a sequence of frames, each
+ * consisting of this header and the data. The data is an LZ4 block that decompresses to uncompressed_size bytes,
+ * or the uncompressed data if compressed_size == uncompressed_size. Frames are independent, so decompression can
+ * start at any frame (the messages are not aligned to frames though).
+ * Appended data (ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK) follows the last frame uncompressed.
+ */
+struct ulog_compressed_frame_header_s {
+	uint8_t magic[4]; ///< 'U', 'L', 'z', '4'
+	uint32_t compressed_size;
+	uint32_t uncompressed_size;
+};
+
 #pragma pack(pop)
@@ -176,6 +176,21 @@ PARAM_DEFINE_INT32(SDLOG_DIRS_MAX, 0);
  */
 PARAM_DEFINE_INT32(SDLOG_UUID, 1);
 
+/**
+ * Log compression
+ *
+ * If enabled, the full log file is compressed (LZ4) while logging. This reduces the
+ * required write bandwidth, at the cost of CPU load in the log writer thread.
+ * Compressed logs need to be decompressed with Tools/decompress_ulog.py before
+ * they can be analyzed.
+ *
+ * Not supported together with log encryption.
+ *
+ * @boolean
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_COMPRESS, 0);
+
 /**
  * Logfile Encryption algorithm
  *
@@ -0,0 +1,192 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "mavlink_message_handler_table.h"
+#include "mavlink_ftp.h"
+#include "mavlink_log_handler.h"
+#include "mavlink_mission.h"
+#include "mavlink_parameters.h"
+#include "mavlink_timesync.h"
+#include <gtest/gtest.h>
+
+// handler bits as used by MavlinkReceiver
+static constexpr uint8_t handler_mission = 1 << 0;
+static constexpr uint8_t handler_parameters = 1 << 1;
+static constexpr uint8_t handler_ftp = 1 << 2;
+static constexpr uint8_t handler_log = 1 << 3;
+static constexpr uint8_t handler_timesync = 1 << 4;
+
+static constexpr uint32_t msgid_max = 0xFFFF;
+
+// same as MavlinkMessageHandlerTable<N>::hash()
+static int table_hash(uint32_t msgid, int n)
+{
+	return ((msgid * 2654435761u) >> 16) & (n - 1);
+}
+
+template<size_t N>
+static bool contains(const uint32_t (&msgids)[N], uint32_t msgid)
+{
+	for (size_t i = 0; i < N; i++) {
+		if (msgids[i] == msgid) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+template<size_t N>
+static void add_all(MavlinkMessageHandlerTable<64> &table, const uint32_t (&msgids)[N], uint8_t handlers)
+{
+	for (size_t i = 0; i < N; i++) {
+		ASSERT_TRUE(table.add(msgids[i], handlers));
+	}
+}
+
+class MavlinkMessageHandlerTableTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		// registered like in the MavlinkReceiver constructor
+		add_all(table, MavlinkMissionManager::handled_messages, handler_mission);
+		add_all(table, MavlinkParametersManager::handled_messages, handler_parameters);
+		add_all(table, MavlinkFTP::handled_messages, handler_ftp);
+		add_all(table, MavlinkLogHandler::handled_messages, handler_log);
+		add_all(table, MavlinkTimesync::handled_messages, handler_timesync);
+	}
+
+	static uint8_t expected_handlers(uint32_t msgid)
+	{
+		uint8_t handlers = 0;
+		handlers |= contains(MavlinkMissionManager::handled_messages, msgid) ? handler_mission : 0;
+		handlers |= contains(MavlinkParametersManager::handled_messages, msgid) ? handler_parameters : 0;
+		handlers |= contains(MavlinkFTP::handled_messages, msgid) ? handler_ftp : 0;
+		handlers |= contains(MavlinkLogHandler::handled_messages, msgid) ? handler_log : 0;
+		handlers |= contains(MavlinkTimesync::handled_messages, msgid) ? handler_timesync : 0;
+		return handlers;
+	}
+
+	MavlinkMessageHandlerTable<64> table;
+};
+
+TEST_F(MavlinkMessageHandlerTableTest, RegisteredMessages)
+{
+	EXPECT_EQ(table.get(MAVLINK_MSG_ID_MISSION_ITEM_INT), handler_mission);
+	EXPECT_EQ(table.get(MAVLINK_MSG_ID_PARAM_SET), handler_parameters);
+	EXPECT_EQ(table.get(MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL), handler_ftp);
+	EXPECT_EQ(table.get(MAVLINK_MSG_ID_LOG_REQUEST_DATA), handler_log);
+	EXPECT_EQ(table.get(MAVLINK_MSG_ID_TIMESYNC), handler_timesync);
+
+	// every handled and unhandled message id
+	for (uint32_t msgid = 0; msgid <= msgid_max; msgid++) {
+		EXPECT_EQ(table.get(msgid), expected_handlers(msgid)) << "msgid " << msgid;
+	}
+}
+
+TEST_F(MavlinkMessageHandlerTableTest, UnregisteredMessages)
+{
+	EXPECT_EQ(table.get(MAVLINK_MSG_ID_HEARTBEAT), 0);
+	EXPECT_EQ(table.get(MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED), 0);
+	EXPECT_EQ(table.get(MAVLINK_MSG_ID_ODOMETRY), 0);
+	EXPECT_EQ(table.get(MAVLINK_MSG_ID_COMMAND_LONG), 0);
+}
+
+TEST_F(MavlinkMessageHandlerTableTest, CollidingMessages)
+{
+	// unregistered ids hashing to the slot of a registered one
+	const uint32_t registered = MAVLINK_MSG_ID_TIMESYNC;
+	uint32_t colliding[2] {};
+	int found = 0;
+
+	for (uint32_t msgid = 0; (msgid <= msgid_max) && (found < 2); msgid++) {
+		if ((table_hash(msgid, 64) == table_hash(registered, 64)) && (expected_handlers(msgid) == 0)) {
+			colliding[found++] = msgid;
+		}
+	}
+
+	ASSERT_EQ(found, 2);
+
+	for (uint32_t msgid : colliding) {
+		EXPECT_EQ(table.get(msgid), 0) << "msgid " << msgid;
+	}
+
+	EXPECT_TRUE(table.add(colliding[0], handler_log));
+	EXPECT_TRUE(table.add(colliding[1], handler_ftp));
+
+	EXPECT_EQ(table.get(registered), handler_timesync);
+	EXPECT_EQ(table.get(colliding[0]), handler_log);
+	EXPECT_EQ(table.get(colliding[1]), handler_ftp);
+
+	// the other entries are unchanged
+	for (uint32_t msgid = 0; msgid <= msgid_max; msgid++) {
+		if ((msgid != colliding[0]) && (msgid != colliding[1])) {
+			EXPECT_EQ(table.get(msgid), expected_handlers(msgid)) << "msgid " << msgid;
+		}
+	}
+}
+
+TEST_F(MavlinkMessageHandlerTableTest, RepeatedAdd)
+{
+	EXPECT_TRUE(table.add(MAVLINK_MSG_ID_TIMESYNC, handler_mission));
+	EXPECT_EQ(table.get(MAVLINK_MSG_ID_TIMESYNC), handler_timesync | handler_mission);
+
+	// adding the same handler again keeps the mask
+	EXPECT_TRUE(table.add(MAVLINK_MSG_ID_TIMESYNC, handler_mission));
+	EXPECT_EQ(table.get(MAVLINK_MSG_ID_TIMESYNC), handler_timesync | handler_mission);
+
+	EXPECT_TRUE(table.add(MAVLINK_MSG_ID_HEARTBEAT, handler_log));
+	EXPECT_TRUE(table.add(MAVLINK_MSG_ID_HEARTBEAT, handler_parameters));
+	EXPECT_EQ(table.get(MAVLINK_MSG_ID_HEARTBEAT), handler_log | handler_parameters);
+}
+
+TEST(MavlinkMessageHandlerTable, Full)
+{
+	MavlinkMessageHandlerTable<4> table;
+
+	EXPECT_TRUE(table.add(1, handler_mission));
+	EXPECT_TRUE(table.add(2, handler_parameters));
+	EXPECT_TRUE(table.add(3, handler_ftp));
+	EXPECT_TRUE(table.add(4, handler_log));
+	EXPECT_FALSE(table.add(5, handler_timesync));
+
+	// existing entries can still be extended
+	EXPECT_TRUE(table.add(1, handler_timesync));
+
+	EXPECT_EQ(table.get(1), handler_mission | handler_timesync);
+	EXPECT_EQ(table.get(2), handler_parameters);
+	EXPECT_EQ(table.get(3), handler_ftp);
+	EXPECT_EQ(table.get(4), handler_log);
+	EXPECT_EQ(table.get(5), 0);
+}
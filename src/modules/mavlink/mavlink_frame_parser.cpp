@@ -0,0 +1,162 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_frame_parser.cpp
+ */
+
+#include "mavlink_frame_parser.h"
+
+#include <string.h>
+
+void
+MavlinkFrameParser::set_buffer(mavlink_channel_t channel, const uint8_t *buf, ssize_t len)
+{
+	_channel = channel;
+	_buf = buf;
+	_len = (len > 0) ? len : 0;
+	_pos = 0;
+}
+
+bool
+MavlinkFrameParser::parse(mavlink_message_t *msg, mavlink_status_t *status)
+{
+	mavlink_status_t *channel_status = mavlink_get_channel_status(_channel);
+
+	while (_pos < _len) {
+		// the fast path requires the byte-wise parser to be between frames
+		if ((channel_status->parse_state <= MAVLINK_PARSE_STATE_IDLE) && (channel_status->signing == nullptr)) {
+
+			// skip data up to the next start byte, the byte-wise parser ignores it as well
+			while ((_pos < _len) && (_buf[_pos] != MAVLINK_STX) && (_buf[_pos] != MAVLINK_STX_MAVLINK1)) {
+				_pos++;
+			}
+
+			if (_pos >= _len) {
+				break;
+			}
+
+			if (_buf[_pos] == MAVLINK_STX) {
+				const size_t frame_len = decode_frame(&_buf[_pos], _len - _pos, msg, status);
+
+				if (frame_len > 0) {
+					_pos += frame_len;
+					_frames_scanned++;
+					return true;
+				}
+			}
+		}
+
+		if (mavlink_parse_char(_channel, _buf[_pos++], msg, status)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+size_t
+MavlinkFrameParser::decode_frame(const uint8_t *frame, size_t len, mavlink_message_t *msg, mavlink_status_t *status)
+{
+	if (len < MAVLINK_NUM_HEADER_BYTES) {
+		return 0;
+	}
+
+	const uint8_t payload_len = frame[1];
+	const uint8_t incompat_flags = frame[2];
+	const size_t frame_len = MAVLINK_NUM_HEADER_BYTES + payload_len + MAVLINK_NUM_CHECKSUM_BYTES;
+
+	// incomplete frame, or signed/unknown incompatibility flags
+	if ((frame_len > len) || (incompat_flags != 0)) {
+		return 0;
+	}
+
+	const uint32_t msgid = frame[7] | (frame[8] << 8) | ((uint32_t)frame[9] << 16);
+	const mavlink_msg_entry_t *entry = mavlink_get_msg_entry(msgid);
+
+	uint16_t checksum;
+	crc_init(&checksum);
+	crc_accumulate_buffer(&checksum, (const char *)&frame[1], MAVLINK_CORE_HEADER_LEN + payload_len);
+	crc_accumulate((entry != nullptr) ? entry->crc_extra : 0, &checksum);
+
+	const uint8_t *ck = &frame[MAVLINK_NUM_HEADER_BYTES + payload_len];
+
+	if ((ck[0] != (checksum & 0xFF)) || (ck[1] != (checksum >> 8))) {
+		// let the byte-wise parser account for the error and resynchronize
+		return 0;
+	}
+
+	msg->checksum = checksum;
+	msg->magic = MAVLINK_STX;
+	msg->len = payload_len;
+	msg->incompat_flags = incompat_flags;
+	msg->compat_flags = frame[3];
+	msg->seq = frame[4];
+	msg->sysid = frame[5];
+	msg->compid = frame[6];
+	msg->msgid = msgid;
+	memcpy(_MAV_PAYLOAD_NON_CONST(msg), &frame[MAVLINK_NUM_HEADER_BYTES], payload_len);
+	msg->ck[0] = ck[0];
+	msg->ck[1] = ck[1];
+
+	// zero-fill truncated payloads, same as mavlink_frame_char_buffer()
+	if ((entry != nullptr) && (payload_len < entry->max_msg_len)) {
+		memset(&_MAV_PAYLOAD_NON_CONST(msg)[payload_len], 0, entry->max_msg_len - payload_len);
+	}
+
+	// update the channel status as the byte-wise parser does for a received message
+	mavlink_status_t *channel_status = mavlink_get_channel_status(_channel);
+	channel_status->flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+	channel_status->msg_received = MAVLINK_FRAMING_OK;
+	channel_status->parse_state = MAVLINK_PARSE_STATE_IDLE;
+	channel_status->packet_idx = payload_len;
+	channel_status->current_rx_seq = msg->seq;
+
+	if (channel_status->packet_rx_success_count == 0) {
+		channel_status->packet_rx_drop_count = 0;
+	}
+
+	channel_status->packet_rx_success_count++;
+	channel_status->parse_error = 0;
+
+	if (status != nullptr) {
+		status->parse_state = channel_status->parse_state;
+		status->packet_idx = channel_status->packet_idx;
+		status->current_rx_seq = channel_status->current_rx_seq + 1;
+		status->packet_rx_success_count = channel_status->packet_rx_success_count;
+		status->packet_rx_drop_count = channel_status->parse_error;
+		status->flags = channel_status->flags;
+	}
+
+	return frame_len;
+}
@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_frame_parser.h
+ * Bulk MAVLink frame parser.
+ *
+ * Complete, unsigned MAVLink 2 frames are located and CRC checked directly in the
+ * receive buffer. Everything else (MAVLink 1, signed or partial frames, corrupted
+ * data) is passed to mavlink_parse_char(), so the channel parser state is always
+ * consistent with byte-wise parsing.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifndef MAVLINK_FTP_UNIT_TEST
+#include "mavlink_bridge_header.h"
+#else
+#include <mavlink.h>
+#endif
+
+class MavlinkFrameParser
+{
+public:
+	MavlinkFrameParser() = default;
+	~MavlinkFrameParser() = default;
+
+	/**
+	 * Set the received data to parse. The buffer needs to stay valid until parse() returns false.
+	 *
+	 * @param channel MAVLink channel the data was received on
+	 * @param buf received data
+	 * @param len number of bytes in buf, nothing is parsed if <= 0
+	 */
+	void set_buffer(mavlink_channel_t channel, const uint8_t *buf, ssize_t len);
+
+	/**
+	 * Parse the next message from the buffer.
+	 *
+	 * @param msg the parsed message
+	 * @param status parser status, as returned by mavlink_parse_char()
+	 * @return true if a message was received, false if the buffer is consumed
+	 */
+	bool parse(mavlink_message_t *msg, mavlink_status_t *status);
+
+	/**
+	 * @return number of messages taken from the fast path (not parsed byte-wise)
+	 */
+	uint32_t frames_scanned() const { return _frames_scanned; }
+
+private:
+	/**
+	 * Decode a complete MAVLink 2 frame starting at frame[0] == MAVLINK_STX.
+	 *
+	 * @return the frame length, 0 if the frame needs to be parsed byte-wise
+	 */
+	size_t decode_frame(const uint8_t *frame, size_t len, mavlink_message_t *msg, mavlink_status_t *status);
+
+	mavlink_channel_t _channel{MAVLINK_COMM_0};
+	const uint8_t *_buf{nullptr};
+	size_t _len{0};
+	size_t _pos{0};
+
+	uint32_t _frames_scanned{0};
+};
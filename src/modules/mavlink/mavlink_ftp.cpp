@@ -66,6 +66,7 @@ MavlinkFTP::~MavlinkFTP()
 {
 	delete[] _work_buffer1;
 	delete[] _work_buffer2;
+	delete[] _read_ahead_buffer;
 }
 
 unsigned
@@ -124,6 +125,8 @@ MavlinkFTP::_getServerChannel()
 #endif
 }
 
+constexpr uint32_t MavlinkFTP::handled_messages[];
+
 void
 MavlinkFTP::handle_message(const mavlink_message_t *msg)
 {
@@ -543,6 +546,7 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 	_session_info.fd = fd;
 	_session_info.file_size = fileSize;
 	_session_info.stream_download = false;
+	_read_ahead_size = 0;
 
 	payload->session = 0;
 	payload->size = sizeof(uint32_t);
@@ -567,19 +571,12 @@ MavlinkFTP::_workRead(PayloadHeader *payload)
 		return kErrEOF;
 	}
 
-	PX4_DEBUG("lseek with offset: %ld", payload->offset);
-
-	if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-		_our_errno = errno;
-		PX4_ERR("seek fail: %s", strerror(_our_errno));
-		return kErrFailErrno;
-	}
-
-	int bytes_read = ::read(_session_info.fd, &payload->data[0], payload->size);
+	// Gaps of a burst download are requested with single reads, which are mostly served from the read-ahead buffer
+	const int read_size = payload->size < kMaxDataLength ? payload->size : kMaxDataLength;
+	int bytes_read = _read_ahead(payload->offset, &payload->data[0], read_size);
 
 	if (bytes_read < 0) {
 		// Negative return indicates error other than eof
-		_our_errno = errno;
 		PX4_ERR("read fail %d, %s", bytes_read, strerror(_our_errno));
 		return kErrFailErrno;
 	}
@@ -603,10 +600,15 @@ MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id, uint8_t
 	_session_info.stream_download = true;
 	_session_info.stream_offset = payload->offset;
 	_session_info.stream_chunk_transmitted = 0;
+	_session_info.stream_packets_transmitted = 0;
 	_session_info.stream_seq_number = payload->seq_number + 1;
 	_session_info.stream_target_system_id = target_system_id;
 	_session_info.stream_target_component_id = target_component_id;
 
+#ifndef MAVLINK_FTP_UNIT_TEST
+	_burst_window = _mavlink->ftp_burst_window();
+#endif
+
 	return kErrNone;
 }
 
@@ -1029,8 +1031,80 @@ MavlinkFTP::_copy_file(const char *src_path, const char *dst_path, size_t length
 	return (length > 0) ? -1 : 0;
 }
 
+int MavlinkFTP::_read_ahead(uint32_t offset, uint8_t *data, int len)
+{
+	if (!_read_ahead_buffer) {
+		_read_ahead_buffer = new uint8_t[_read_ahead_buffer_len];
+		_read_ahead_size = 0;
+	}
+
+	if (!_read_ahead_buffer) {
+		// no memory for the read-ahead buffer: read directly
+		if (lseek(_session_info.fd, offset, SEEK_SET) < 0) {
+			_our_errno = errno;
+			PX4_ERR("seek fail: %s", strerror(_our_errno));
+			return -1;
+		}
+
+		int bytes_read = ::read(_session_info.fd, data, len);
+
+		if (bytes_read < 0) {
+			_our_errno = errno;
+		}
+
+		return bytes_read;
+	}
+
+	const uint32_t buffer_end = _read_ahead_offset + _read_ahead_size;
+
+	// the buffered data is usable if it contains the full request, or everything up to the end of the file
+	const bool hit = _read_ahead_size > 0 && offset >= _read_ahead_offset && offset < buffer_end
+			 && (offset + len <= buffer_end || buffer_end >= _session_info.file_size);
+
+	if (!hit) {
+		const uint32_t block_offset = offset - (offset % _read_ahead_block_size);
+
+		if (lseek(_session_info.fd, block_offset, SEEK_SET) < 0) {
+			_our_errno = errno;
+			_read_ahead_size = 0;
+			PX4_ERR("seek fail: %s", strerror(_our_errno));
+			return -1;
+		}
+
+		int bytes_read = ::read(_session_info.fd, _read_ahead_buffer, _read_ahead_buffer_len);
+
+		if (bytes_read < 0) {
+			_our_errno = errno;
+			_read_ahead_size = 0;
+			return -1;
+		}
+
+		_read_ahead_offset = block_offset;
+		_read_ahead_size = bytes_read;
+	}
+
+	const uint32_t read_end = _read_ahead_offset + _read_ahead_size;
+
+	if (offset >= read_end) {
+		return 0;
+	}
+
+	if ((uint32_t)len > read_end - offset) {
+		len = read_end - offset;
+	}
+
+	memcpy(data, &_read_ahead_buffer[offset - _read_ahead_offset], len);
+	return len;
+}
+
 void MavlinkFTP::send()
 {
+	if (_read_ahead_buffer && !_session_info.stream_download
+	    && hrt_elapsed_time(&_last_work_buffer_access) > 2_s) {
+		delete[] _read_ahead_buffer;
+		_read_ahead_buffer = nullptr;
+		_read_ahead_size = 0;
+	}
 
 	if (_work_buffer1 || _work_buffer2) {
 		// free the work buffers if they are not used for a while
@@ -1101,14 +1175,7 @@ void MavlinkFTP::send()
 		}
 
 		if (error_code == kErrNone) {
-			if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-				error_code = kErrFailErrno;
-				PX4_WARN("stream download: seek fail");
-			}
-		}
-
-		if (error_code == kErrNone) {
-			int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+			int bytes_read = _read_ahead(payload->offset, &payload->data[0], kMaxDataLength);
 
 			if (bytes_read < 0) {
 				// Negative return indicates error other than eof
@@ -1119,6 +1186,7 @@ void MavlinkFTP::send()
 				payload->size = bytes_read;
 				_session_info.stream_offset += bytes_read;
 				_session_info.stream_chunk_transmitted += bytes_read;
+				_session_info.stream_packets_transmitted++;
 			}
 		}
 
@@ -1135,14 +1203,20 @@ void MavlinkFTP::send()
 
 			_session_info.stream_download = false;
 
+		} else if (_burst_window > 0 && _session_info.stream_packets_transmitted >= (unsigned)_burst_window) {
+			// window is full: let the client request the next burst (or the missing offsets)
+			payload->burst_complete = true;
+			_session_info.stream_download = false;
+
 		} else {
+			payload->burst_complete = false;
 #ifndef MAVLINK_FTP_UNIT_TEST
 
 			if (max_bytes_to_send < (get_size() * 2)) {
 				more_data = false;
 
 				/* perform transfers in 35K chunks - this is determined empirical */
-				if (_session_info.stream_chunk_transmitted > 35000) {
+				if (_burst_window == 0 && _session_info.stream_chunk_transmitted > 35000) {
 					payload->burst_complete = true;
 					_session_info.stream_download = false;
 					_session_info.stream_chunk_transmitted = 0;
@@ -1151,7 +1225,6 @@ void MavlinkFTP::send()
 			} else {
 #endif
 				more_data = true;
-				payload->burst_complete = false;
 #ifndef MAVLINK_FTP_UNIT_TEST
 				max_bytes_to_send -= get_size();
 			}
@@ -68,6 +68,11 @@ public:
 	/// Handle possible FTP message
 	void handle_message(const mavlink_message_t *msg);
 
+	/// Message ids handled by handle_message()
+	static constexpr uint32_t handled_messages[] {
+		MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL,
+	};
+
 	typedef void (*ReceiveMessageFunc_t)(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
 
 	/// @brief Sets up the server to run in unit test mode.
@@ -130,6 +135,9 @@ public:
 
 	unsigned get_size();
 
+	/// @brief true while a burst download is in progress, i.e. send() has packets to transmit
+	bool stream_active() const { return _session_info.stream_download; }
+
 private:
 	char		*_data_as_cstring(PayloadHeader *payload);
 
@@ -163,6 +171,15 @@ private:
 	 */
 	bool _ensure_buffers_exist();
 
+	/**
+	 * read file data of the current session through the read-ahead buffer
+	 * @param offset file offset
+	 * @param data destination
+	 * @param len maximum number of bytes to read
+	 * @return number of bytes read (0 at EOF), -1 on error (_our_errno is set)
+	 */
+	int _read_ahead(uint32_t offset, uint8_t *data, int len);
+
 	static const char	kDirentFile = 'F';	///< Identifies File returned from List command
 	static const char	kDirentDir = 'D';	///< Identifies Directory returned from List command
 	static const char	kDirentSkip = 'S';	///< Identifies Skipped entry from List command
@@ -179,6 +196,7 @@ private:
 		uint8_t		stream_target_system_id;
 		uint8_t         stream_target_component_id;
 		unsigned	stream_chunk_transmitted;
+		unsigned	stream_packets_transmitted;	///< packets sent in the current burst
 	};
 	struct SessionInfo _session_info {};	///< Session info, fd=-1 for no active session
 
@@ -198,6 +216,20 @@ private:
 	static constexpr int _work_buffer2_len = 256;
 	hrt_abstime _last_work_buffer_access{0}; ///< timestamp when the buffers were last accessed
 
+	/* read-ahead buffer for downloads: the file is read in large blocks and the packets are served from memory,
+	 * instead of a seek + read per packet. Allocated on the first read, freed when no download is active. */
+	uint8_t *_read_ahead_buffer{nullptr};
+#ifdef __PX4_NUTTX
+	static constexpr int _read_ahead_buffer_len = 4096;
+#else
+	static constexpr int _read_ahead_buffer_len = 64 * 1024;
+#endif
+	static constexpr uint32_t _read_ahead_block_size = 512; ///< refills start at a multiple of this
+	uint32_t _read_ahead_offset{0}; ///< file offset of _read_ahead_buffer[0]
+	int _read_ahead_size{0}; ///< number of valid bytes in _read_ahead_buffer, 0 if invalid
+
+	int _burst_window{0}; ///< maximum number of packets per burst, 0 for automatic (MAV_FTP_WIN)
+
 	// prepend a root directory to each file/dir access to avoid enumerating the full FS tree (e.g. on Linux).
 	// Note that requests can still fall outside of the root dir by using ../..
 #ifdef MAVLINK_FTP_UNIT_TEST
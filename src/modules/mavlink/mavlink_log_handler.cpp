@@ -90,6 +90,9 @@ MavlinkLogHandler::~MavlinkLogHandler()
 	_close_and_unlink_files();
 }
 
+//-------------------------------------------------------------------
+constexpr uint32_t MavlinkLogHandler::handled_messages[];
+
 //-------------------------------------------------------------------
 void
 MavlinkLogHandler::handle_message(const mavlink_message_t *msg)
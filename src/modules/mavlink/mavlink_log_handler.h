@@ -57,6 +57,14 @@ public:
 	// Handle possible LOG message
 	void handle_message(const mavlink_message_t *msg);
 
+	// Message ids handled by handle_message()
+	static constexpr uint32_t handled_messages[] {
+		MAVLINK_MSG_ID_LOG_REQUEST_LIST,
+		MAVLINK_MSG_ID_LOG_REQUEST_DATA,
+		MAVLINK_MSG_ID_LOG_ERASE,
+		MAVLINK_MSG_ID_LOG_REQUEST_END,
+	};
+
 	/**
 	 * Handle sending of messages. Call this regularly at a fixed frequency.
 	 * @param t current time
@@ -754,66 +754,139 @@ void Mavlink::send_finish()
 		return;
 	}
 
+#if defined(MAVLINK_UDP)
+
+	if (_udp_tx_batch != nullptr) {
+		// append the packet to the pending datagram, sent by send_flush()
+		if (_udp_tx_batch_fill + _buf_fill > UDP_TX_BATCH_SIZE) {
+			udp_tx_batch_flush();
+		}
+
+		if (_udp_tx_batch_fill == 0) {
+			_udp_tx_batch_timestamp = _last_write_try_time;
+		}
+
+		memcpy(&_udp_tx_batch[_udp_tx_batch_fill], _buf, _buf_fill);
+		_udp_tx_batch_fill += _buf_fill;
+		_udp_tx_batch_count++;
+		_buf_fill = 0;
+
+		// bound the latency of packets sent outside of the main loop and receiver iterations
+		if (hrt_elapsed_time(&_udp_tx_batch_timestamp) > _main_loop_delay) {
+			udp_tx_batch_flush();
+		}
+
+		pthread_mutex_unlock(&_send_mutex);
+		return;
+	}
+
+#endif // MAVLINK_UDP
+
 	int ret = -1;
 
 	// send message to UART
 	if (get_protocol() == Protocol::SERIAL) {
 		ret = ::write(_uart_fd, _buf, _buf_fill);
+		count_txsyscall(_buf_fill);
 	}
 
 #if defined(MAVLINK_UDP)
 
 	else if (get_protocol() == Protocol::UDP) {
+		ret = send_udp(_buf, _buf_fill);
+	}
+
+#endif // MAVLINK_UDP
+
+	if (ret == (int)_buf_fill) {
+		_tstatus.tx_message_count++;
+		count_txbytes(_buf_fill);
+		_last_write_success_time = _last_write_try_time;
+
+	} else {
+		count_txerrbytes(_buf_fill);
+	}
+
+	_buf_fill = 0;
+
+	pthread_mutex_unlock(&_send_mutex);
+}
+
+void Mavlink::send_flush()
+{
+#if defined(MAVLINK_UDP)
+
+	if (_udp_tx_batch != nullptr) {
+		pthread_mutex_lock(&_send_mutex);
+		udp_tx_batch_flush();
+		pthread_mutex_unlock(&_send_mutex);
+	}
+
+#endif // MAVLINK_UDP
+}
+
+#if defined(MAVLINK_UDP)
+int Mavlink::send_udp(const uint8_t *buf, unsigned len)
+{
+	int ret = -1;
 
 # if defined(CONFIG_NET)
 
-		if (_src_addr_initialized) {
+	if (_src_addr_initialized) {
 # endif // CONFIG_NET
-			ret = sendto(_socket_fd, _buf, _buf_fill, 0, (struct sockaddr *)&_src_addr, sizeof(_src_addr));
+		ret = sendto(_socket_fd, buf, len, 0, (struct sockaddr *)&_src_addr, sizeof(_src_addr));
+		count_txsyscall(len);
 # if defined(CONFIG_NET)
-		}
+	}
 
 # endif // CONFIG_NET
 
-		if ((_mode != MAVLINK_MODE_ONBOARD) && broadcast_enabled() &&
-		    (!get_client_source_initialized() || !is_gcs_connected())) {
-
-			if (!_broadcast_address_found) {
-				find_broadcast_address();
-			}
+	if ((_mode != MAVLINK_MODE_ONBOARD) && broadcast_enabled() &&
+	    (!get_client_source_initialized() || !is_gcs_connected())) {
 
-			if (_broadcast_address_found && _buf_fill > 0) {
+		if (!_broadcast_address_found) {
+			find_broadcast_address();
+		}
 
-				int bret = sendto(_socket_fd, _buf, _buf_fill, 0, (struct sockaddr *)&_bcast_addr, sizeof(_bcast_addr));
+		if (_broadcast_address_found && len > 0) {
 
-				if (bret <= 0) {
-					if (!_broadcast_failed_warned) {
-						PX4_ERR("sending broadcast failed, errno: %d: %s", errno, strerror(errno));
-						_broadcast_failed_warned = true;
-					}
+			int bret = sendto(_socket_fd, buf, len, 0, (struct sockaddr *)&_bcast_addr, sizeof(_bcast_addr));
+			count_txsyscall(len);
 
-				} else {
-					_broadcast_failed_warned = false;
+			if (bret <= 0) {
+				if (!_broadcast_failed_warned) {
+					PX4_ERR("sending broadcast failed, errno: %d: %s", errno, strerror(errno));
+					_broadcast_failed_warned = true;
 				}
+
+			} else {
+				_broadcast_failed_warned = false;
 			}
 		}
 	}
 
-#endif // MAVLINK_UDP
+	return ret;
+}
 
-	if (ret == (int)_buf_fill) {
-		_tstatus.tx_message_count++;
-		count_txbytes(_buf_fill);
+void Mavlink::udp_tx_batch_flush()
+{
+	if (_udp_tx_batch_fill == 0) {
+		return;
+	}
+
+	if (send_udp(_udp_tx_batch, _udp_tx_batch_fill) == (int)_udp_tx_batch_fill) {
+		_tstatus.tx_message_count += _udp_tx_batch_count;
+		count_txbytes(_udp_tx_batch_fill);
 		_last_write_success_time = _last_write_try_time;
 
 	} else {
-		count_txerrbytes(_buf_fill);
+		count_txerrbytes(_udp_tx_batch_fill);
 	}
 
-	_buf_fill = 0;
-
-	pthread_mutex_unlock(&_send_mutex);
+	_udp_tx_batch_fill = 0;
+	_udp_tx_batch_count = 0;
 }
+#endif // MAVLINK_UDP
 
 void Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
 {
@@ -1157,10 +1230,12 @@ Mavlink::configure_stream(const char *stream_name, const float rate)
 			if (interval != 0) {
 				/* set new interval */
 				stream->set_interval(interval);
+				_stream_schedule_invalid = true;
 
 			} else {
 				/* delete stream */
 				_streams.deleteNode(stream);
+				_stream_schedule_invalid = true;
 				return OK; // must finish with loop after node is deleted
 			}
 
@@ -1175,6 +1250,7 @@ Mavlink::configure_stream(const char *stream_name, const float rate)
 	if (stream != nullptr) {
 		stream->set_interval(interval);
 		_streams.add(stream);
+		_stream_schedule_invalid = true;
 
 		return OK;
 	}
@@ -1856,6 +1932,128 @@ Mavlink::configure_streams_to_default(const char *configure_single_stream)
 	return ret;
 }
 
+void
+Mavlink::update_stream(MavlinkStream *stream, const hrt_abstime &t)
+{
+	stream->update(t);
+
+	if (!_first_heartbeat_sent) {
+		if (_mode == MAVLINK_MODE_IRIDIUM) {
+			if (stream->get_id() == MAVLINK_MSG_ID_HIGH_LATENCY2) {
+				_first_heartbeat_sent = stream->first_message_sent();
+			}
+
+		} else {
+			if (stream->get_id() == MAVLINK_MSG_ID_HEARTBEAT) {
+				_first_heartbeat_sent = stream->first_message_sent();
+			}
+		}
+	}
+}
+
+void
+Mavlink::update_streams(const hrt_abstime &t)
+{
+	// the schedule depends on the stream intervals, so a significant change of the rate multiplier invalidates it
+	if (_stream_schedule_invalid
+	    || fabsf(_rate_mult - _stream_schedule_rate_mult) > STREAM_SCHEDULE_RATE_MULT_TOLERANCE * _stream_schedule_rate_mult) {
+		stream_schedule_rebuild(t);
+	}
+
+	if (_stream_schedule == nullptr) {
+		// no schedule available, visit every stream
+		for (const auto &stream : _streams) {
+			update_stream(stream, t);
+		}
+
+		return;
+	}
+
+	// every stream reschedules itself after t when updated, so each stream is visited at most once
+	while ((_stream_schedule_size > 0) && (_stream_schedule[0]->get_next_update() <= t)) {
+		update_stream(_stream_schedule[0], t);
+		stream_schedule_sift_down(0);
+	}
+}
+
+void
+Mavlink::stream_schedule_rebuild(const hrt_abstime &t)
+{
+	const int size = _streams.size();
+
+	if (size > _stream_schedule_capacity) {
+		delete[] _stream_schedule;
+		_stream_schedule = new MavlinkStream *[size];
+		_stream_schedule_capacity = (_stream_schedule != nullptr) ? size : 0;
+
+		if (_stream_schedule == nullptr) {
+			PX4_ERR("stream schedule alloc failed");
+		}
+	}
+
+	_stream_schedule_size = 0;
+
+	if (_stream_schedule != nullptr) {
+		for (const auto &stream : _streams) {
+			stream->schedule(t);
+			_stream_schedule[_stream_schedule_size++] = stream;
+		}
+
+		for (int i = _stream_schedule_size / 2 - 1; i >= 0; i--) {
+			stream_schedule_sift_down(i);
+		}
+	}
+
+	_stream_schedule_rate_mult = _rate_mult;
+	_stream_schedule_invalid = false;
+}
+
+void
+Mavlink::stream_schedule_sift_down(int index)
+{
+	MavlinkStream *stream = _stream_schedule[index];
+	const hrt_abstime next_update = stream->get_next_update();
+
+	for (;;) {
+		int child = 2 * index + 1;
+
+		if (child >= _stream_schedule_size) {
+			break;
+		}
+
+		if ((child + 1 < _stream_schedule_size)
+		    && (_stream_schedule[child + 1]->get_next_update() < _stream_schedule[child]->get_next_update())) {
+			child++;
+		}
+
+		if (next_update <= _stream_schedule[child]->get_next_update()) {
+			break;
+		}
+
+		_stream_schedule[index] = _stream_schedule[child];
+		index = child;
+	}
+
+	_stream_schedule[index] = stream;
+}
+
+unsigned
+Mavlink::main_loop_sleep_time() const
+{
+	unsigned sleep_time = _main_loop_delay;
+
+	if ((_stream_schedule != nullptr) && (_stream_schedule_size > 0) && !_stream_schedule_invalid) {
+		const hrt_abstime now = hrt_absolute_time();
+		const hrt_abstime next_update = _stream_schedule[0]->get_next_update();
+
+		if (next_update < now + sleep_time) {
+			sleep_time = (next_update > now + MAVLINK_MIN_INTERVAL) ? (unsigned)(next_update - now) : MAVLINK_MIN_INTERVAL;
+		}
+	}
+
+	return sleep_time;
+}
+
 int
 Mavlink::task_main(int argc, char *argv[])
 {
@@ -1880,7 +2078,7 @@ Mavlink::task_main(int argc, char *argv[])
 	int temp_int_arg;
 #endif
 
-	while ((ch = px4_getopt(argc, argv, "b:r:d:n:u:o:m:t:c:fswxzZp", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "b:r:d:n:u:o:m:t:c:fswxzZpC", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'b':
 			if (px4_get_parameter_value(myoptarg, _baudrate) != 0) {
@@ -1966,6 +2164,10 @@ Mavlink::task_main(int argc, char *argv[])
 			_mav_broadcast = BROADCAST_MODE_ON;
 			break;
 
+		case 'C':
+			_udp_tx_batch_enabled = true;
+			break;
+
 #if defined(CONFIG_NET_IGMP) && defined(CONFIG_NET_ROUTE)
 
 		// multicast
@@ -1995,6 +2197,7 @@ Mavlink::task_main(int argc, char *argv[])
 		case 'u':
 		case 'o':
 		case 't':
+		case 'C':
 			PX4_ERR("UDP options not supported on this platform");
 			err_flag = true;
 			break;
@@ -2251,6 +2454,14 @@ Mavlink::task_main(int argc, char *argv[])
 	/* init socket if necessary */
 	if (get_protocol() == Protocol::UDP) {
 		init_udp();
+
+		if (_udp_tx_batch_enabled) {
+			_udp_tx_batch = new uint8_t[UDP_TX_BATCH_SIZE];
+
+			if (_udp_tx_batch == nullptr) {
+				PX4_ERR("failed to allocate UDP TX buffer, sending one datagram per message");
+			}
+		}
 	}
 
 #endif // MAVLINK_UDP
@@ -2271,8 +2482,8 @@ Mavlink::task_main(int argc, char *argv[])
 	_task_running.store(true);
 
 	while (!should_exit()) {
-		/* main loop */
-		px4_usleep(_main_loop_delay);
+		/* main loop: sleep until the next stream is due, at most _main_loop_delay */
+		px4_usleep(main_loop_sleep_time());
 
 		if (!should_transmit()) {
 			check_requested_subscriptions();
@@ -2467,22 +2678,7 @@ Mavlink::task_main(int argc, char *argv[])
 		check_requested_subscriptions();
 
 		/* update streams */
-		for (const auto &stream : _streams) {
-			stream->update(t);
-
-			if (!_first_heartbeat_sent) {
-				if (_mode == MAVLINK_MODE_IRIDIUM) {
-					if (stream->get_id() == MAVLINK_MSG_ID_HIGH_LATENCY2) {
-						_first_heartbeat_sent = stream->first_message_sent();
-					}
-
-				} else {
-					if (stream->get_id() == MAVLINK_MSG_ID_HEARTBEAT) {
-						_first_heartbeat_sent = stream->first_message_sent();
-					}
-				}
-			}
-		}
+		update_streams(t);
 
 		/* check for ulog streaming messages */
 		if (_mavlink_ulog) {
@@ -2584,6 +2780,9 @@ Mavlink::task_main(int argc, char *argv[])
 			}
 		}
 
+		/* send everything coalesced during this iteration */
+		send_flush();
+
 		/* update TX/RX rates*/
 		if (t > _bytes_timestamp + 1_s) {
 			if (_bytes_timestamp != 0) {
@@ -2593,9 +2792,14 @@ Mavlink::task_main(int argc, char *argv[])
 				_tstatus.tx_error_rate_avg = _bytes_txerr / dt;
 				_tstatus.rx_rate_avg = _bytes_rx / dt;
 
+				_tx_syscall_rate_avg = _tx_syscalls / dt;
+				_tx_bytes_per_syscall = (_tx_syscalls > 0) ? (float)_tx_syscall_bytes / _tx_syscalls : 0.f;
+
 				_bytes_tx = 0;
 				_bytes_txerr = 0;
 				_bytes_rx = 0;
+				_tx_syscalls = 0;
+				_tx_syscall_bytes = 0;
 			}
 
 			_bytes_timestamp = t;
@@ -2617,6 +2821,11 @@ Mavlink::task_main(int argc, char *argv[])
 	/* delete streams */
 	_streams.clear();
 
+	delete[] _stream_schedule;
+	_stream_schedule = nullptr;
+	_stream_schedule_size = 0;
+	_stream_schedule_capacity = 0;
+
 	if (_uart_fd >= 0) {
 		/* discard all pending data, as close() might block otherwise on NuttX with flow control enabled */
 		tcflush(_uart_fd, TCIOFLUSH);
@@ -2629,6 +2838,11 @@ Mavlink::task_main(int argc, char *argv[])
 		_socket_fd = -1;
 	}
 
+#if defined(MAVLINK_UDP)
+	delete[] _udp_tx_batch;
+	_udp_tx_batch = nullptr;
+#endif // MAVLINK_UDP
+
 	if (_forwarding_on) {
 		message_buffer_destroy();
 		pthread_mutex_destroy(&_message_buffer_mutex);
@@ -2933,6 +3147,7 @@ Mavlink::display_status()
 	printf("\t  txerr: %.1f B/s\n", (double)_tstatus.tx_error_rate_avg);
 	printf("\t  tx rate mult: %.3f\n", (double)_rate_mult);
 	printf("\t  tx rate max: %i B/s\n", _datarate);
+	printf("\t  tx syscalls: %.1f 1/s, %.1f B/syscall\n", (double)_tx_syscall_rate_avg, (double)_tx_bytes_per_syscall);
 	printf("\t  rx: %.1f B/s\n", (double)_tstatus.rx_rate_avg);
 	printf("\t  rx loss: %.1f%%\n", (double)_tstatus.rx_message_lost_rate);
 
@@ -2960,6 +3175,7 @@ Mavlink::display_status()
 		printf("UDP (%hu, remote port: %hu)\n", _network_port, _remote_port);
 		printf("\tBroadcast enabled: %s\n",
 		       broadcast_enabled() ? "YES" : "NO");
+		printf("\tTX coalescing: %s\n", (_udp_tx_batch != nullptr) ? "YES" : "NO");
 #if defined(CONFIG_NET_IGMP) && defined(CONFIG_NET_ROUTE)
 		printf("\tMulticast enabled: %s\n",
 		       multicast_enabled() ? "YES" : "NO");
@@ -2992,7 +3208,8 @@ Mavlink::display_status()
 void
 Mavlink::display_status_streams()
 {
-	printf("\t%-20s%-16s %s\n", "Name", "Rate Config (current) [Hz]", "Message Size (if active) [B]");
+	printf("\t%-20s%-16s %s %s\n", "Name", "Rate Config (current) [Hz]", "Message Size (if active) [B]",
+	       "Jitter mean/max [ms]");
 
 	const float rate_mult = _rate_mult;
 
@@ -3015,7 +3232,16 @@ Mavlink::display_status_streams()
 		printf("\t%-30s%-16s", stream->get_name(), rate_str);
 
 		if (size > 0) {
-			printf(" %3u\n", size);
+			printf(" %3u", size);
+
+		} else {
+			printf("    ");
+		}
+
+		if (interval > 0) {
+			// jitter is the lateness of periodic sends relative to the configured interval, mean and max since the last output
+			printf("%30.2f / %.2f\n", (double)(stream->get_jitter_mean() * 1e-3f), (double)(stream->get_jitter_max() * 1e-3f));
+			stream->reset_jitter();
 
 		} else {
 			printf("\n");
@@ -3318,6 +3544,7 @@ $ mavlink stream -u 14556 -s HIGHRES_IMU -r 50
 	PRINT_MODULE_USAGE_PARAM_INT('r', 0, 10, 10000000, "Maximum sending data rate in B/s (if 0, use baudrate / 20)", true);
 #if defined(CONFIG_NET) || defined(__PX4_POSIX)
 	PRINT_MODULE_USAGE_PARAM_FLAG('p', "Enable Broadcast", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('C', "Coalesce the messages of each main loop iteration into MTU sized UDP datagrams", true);
 	PRINT_MODULE_USAGE_PARAM_INT('u', 14556, 0, 65536, "Select UDP Network Port (local)", true);
 	PRINT_MODULE_USAGE_PARAM_INT('o', 14550, 0, 65536, "Select UDP Network Port (remote)", true);
 	PRINT_MODULE_USAGE_PARAM_STRING('t', "127.0.0.1", nullptr, "Partner IP (broadcasting can be enabled via -p flag)", true);
@@ -342,6 +342,11 @@ public:
 	 */
 	void             	send_finish();
 
+	/**
+	 * Send the packets coalesced into the pending UDP datagram (no-op without TX coalescing)
+	 */
+	void			send_flush();
+
 	/**
 	 * Resend message as is, don't change sequence number and CRC.
 	 */
@@ -434,6 +439,11 @@ public:
 	 */
 	void			count_txerrbytes(unsigned n) { _bytes_txerr += n; };
 
+	/**
+	 * Count write/send system calls and the bytes passed to them
+	 */
+	void			count_txsyscall(unsigned n) { _tx_syscalls++; _tx_syscall_bytes += n; };
+
 	/**
 	 * Count received bytes
 	 */
@@ -499,6 +509,7 @@ public:
 
 	const events::SendProtocol &get_events_protocol() const { return _events; };
 	bool ftp_enabled() const { return _ftp_on; }
+	int ftp_burst_window() const { return _param_mav_ftp_win.get(); }
 
 	bool hash_check_enabled() const { return _param_mav_hash_chk_en.get(); }
 	bool forward_heartbeats_enabled() const { return _param_mav_hb_forw_en.get(); }
@@ -554,6 +565,7 @@ private:
 	static constexpr int	MAVLINK_MIN_INTERVAL{1500};
 	static constexpr int	MAVLINK_MAX_INTERVAL{10000};
 	static constexpr float	MAVLINK_MIN_MULTIPLIER{0.0005f};
+	static constexpr float	STREAM_SCHEDULE_RATE_MULT_TOLERANCE{0.01f};	///< relative rate mult change to reschedule streams
 
 	mavlink_message_t	_mavlink_buffer {};
 	mavlink_status_t	_mavlink_status {};
@@ -570,6 +582,12 @@ private:
 
 	List<MavlinkStream *>		_streams;
 
+	MavlinkStream		**_stream_schedule{nullptr};	///< min-heap of _streams ordered by their next update time
+	int			_stream_schedule_size{0};
+	int			_stream_schedule_capacity{0};
+	float			_stream_schedule_rate_mult{1.f};	///< rate mult the schedule was computed with
+	bool			_stream_schedule_invalid{true};	///< stream list or intervals changed since the last rebuild
+
 	MavlinkShell		*_mavlink_shell{nullptr};
 	MavlinkULog		*_mavlink_ulog{nullptr};
 	static events::EventBuffer	*_event_buffer;
@@ -619,6 +637,11 @@ private:
 	unsigned		_bytes_rx{0};
 	hrt_abstime		_bytes_timestamp{0};
 
+	unsigned		_tx_syscalls{0};
+	unsigned		_tx_syscall_bytes{0};
+	float			_tx_syscall_rate_avg{0.f};
+	float			_tx_bytes_per_syscall{0.f};
+
 #if defined(MAVLINK_UDP)
 	BROADCAST_MODE		_mav_broadcast {BROADCAST_MODE_OFF};
 
@@ -633,6 +656,14 @@ private:
 
 	unsigned short		_network_port{14556};
 	unsigned short		_remote_port{DEFAULT_REMOTE_PORT_UDP};
+
+	static constexpr unsigned UDP_TX_BATCH_SIZE{1472}; ///< Ethernet MTU minus IPv4 and UDP headers
+
+	uint8_t			*_udp_tx_batch{nullptr};	///< pending datagram if TX coalescing is enabled
+	unsigned		_udp_tx_batch_fill{0};
+	unsigned		_udp_tx_batch_count{0};		///< number of MAVLink packets in the pending datagram
+	hrt_abstime		_udp_tx_batch_timestamp{0};	///< time the first packet was added to the pending datagram
+	bool			_udp_tx_batch_enabled{false};
 #endif // MAVLINK_UDP
 
 	uint8_t			_buf[MAVLINK_MAX_PACKET_LEN] {};
@@ -675,6 +706,7 @@ private:
 		(ParamBool<px4::params::MAV_HASH_CHK_EN>) _param_mav_hash_chk_en,
 		(ParamBool<px4::params::MAV_HB_FORW_EN>) _param_mav_hb_forw_en,
 		(ParamInt<px4::params::MAV_RADIO_TOUT>)      _param_mav_radio_timeout,
+		(ParamInt<px4::params::MAV_FTP_WIN>) _param_mav_ftp_win,
 		(ParamInt<px4::params::SYS_HITL>) _param_sys_hitl,
 		(ParamBool<px4::params::SYS_FAILURE_EN>) _param_sys_failure_injection_enabled
 	)
@@ -742,10 +774,40 @@ private:
 	 */
 	void update_rate_mult();
 
+	/**
+	 * Update all streams that are due at time t, in order of their next update time.
+	 */
+	void update_streams(const hrt_abstime &t);
+
+	void update_stream(MavlinkStream *stream, const hrt_abstime &t);
+
+	/**
+	 * Reschedule all streams and rebuild the schedule heap.
+	 */
+	void stream_schedule_rebuild(const hrt_abstime &t);
+
+	void stream_schedule_sift_down(int index);
+
+	/**
+	 * Time until the next stream is due, constrained to [MAVLINK_MIN_INTERVAL, _main_loop_delay].
+	 */
+	unsigned main_loop_sleep_time() const;
+
 #if defined(MAVLINK_UDP)
 	void find_broadcast_address();
 
 	void init_udp();
+
+	/**
+	 * Send a datagram to the partner and, if enabled, the broadcast address.
+	 * @return result of sending to the partner
+	 */
+	int send_udp(const uint8_t *buf, unsigned len);
+
+	/**
+	 * Send the pending coalesced datagram, _send_mutex must be held.
+	 */
+	void udp_tx_batch_flush();
 #endif // MAVLINK_UDP
 
 
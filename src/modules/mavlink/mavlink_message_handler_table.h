@@ -0,0 +1,111 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_message_handler_table.h
+ * Lookup of the receiver components handling a MAVLink message id.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Maps message ids to a bitmask of handlers, so that a received message is only passed to the
+ * components handling it.
+ *
+ * Open addressing hash table with linear probing. Each entry packs the 24 bit message id and the
+ * 8 bit handler mask into one word, an entry without handlers marks an empty slot.
+ */
+template<int N>
+class MavlinkMessageHandlerTable
+{
+public:
+	static_assert((N > 0) && ((N & (N - 1)) == 0), "N must be a power of 2");
+
+	/**
+	 * Register handlers for a message id, in addition to previously registered ones.
+	 *
+	 * @return false if the table is full
+	 */
+	bool add(uint32_t msgid, uint8_t handlers)
+	{
+		msgid &= MSGID_MASK;
+
+		for (int i = 0, index = hash(msgid); i < N; i++, index = (index + 1) & (N - 1)) {
+			const uint32_t entry = _entries[index];
+
+			if ((entry >> HANDLERS_SHIFT) == 0) {
+				_entries[index] = msgid | ((uint32_t)handlers << HANDLERS_SHIFT);
+				return true;
+
+			} else if ((entry & MSGID_MASK) == msgid) {
+				_entries[index] = entry | ((uint32_t)handlers << HANDLERS_SHIFT);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * @return the handlers registered for a message id, 0 if none
+	 */
+	uint8_t get(uint32_t msgid) const
+	{
+		for (int i = 0, index = hash(msgid); i < N; i++, index = (index + 1) & (N - 1)) {
+			const uint32_t entry = _entries[index];
+
+			if ((entry & MSGID_MASK) == msgid) {
+				return entry >> HANDLERS_SHIFT;
+
+			} else if ((entry >> HANDLERS_SHIFT) == 0) {
+				return 0;
+			}
+		}
+
+		return 0;
+	}
+
+private:
+	static constexpr uint32_t MSGID_MASK{0xFFFFFF};
+	static constexpr int HANDLERS_SHIFT{24};
+
+	static int hash(uint32_t msgid)
+	{
+		// Fibonacci hashing, message ids are mostly small and dense
+		return ((msgid * 2654435761u) >> 16) & (N - 1);
+	}
+
+	uint32_t _entries[N] {};
+};
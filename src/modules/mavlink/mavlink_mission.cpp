@@ -565,6 +565,8 @@ MavlinkMissionManager::send()
 	}
 }
 
+constexpr uint32_t MavlinkMissionManager::handled_messages[];
+
 void
 MavlinkMissionManager::handle_message(const mavlink_message_t *msg)
 {
@@ -89,6 +89,21 @@ public:
 
 	void handle_message(const mavlink_message_t *msg);
 
+	/**
+	 * Message ids handled by handle_message()
+	 */
+	static constexpr uint32_t handled_messages[] {
+		MAVLINK_MSG_ID_MISSION_ACK,
+		MAVLINK_MSG_ID_MISSION_SET_CURRENT,
+		MAVLINK_MSG_ID_MISSION_REQUEST_LIST,
+		MAVLINK_MSG_ID_MISSION_REQUEST,
+		MAVLINK_MSG_ID_MISSION_REQUEST_INT,
+		MAVLINK_MSG_ID_MISSION_COUNT,
+		MAVLINK_MSG_ID_MISSION_ITEM,
+		MAVLINK_MSG_ID_MISSION_ITEM_INT,
+		MAVLINK_MSG_ID_MISSION_CLEAR_ALL,
+	};
+
 	void check_active_mission(void);
 
 private:
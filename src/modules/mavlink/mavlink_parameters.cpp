@@ -57,6 +57,8 @@ MavlinkParametersManager::get_size()
 	return MAVLINK_MSG_ID_PARAM_VALUE_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
 }
 
+constexpr uint32_t MavlinkParametersManager::handled_messages[];
+
 void
 MavlinkParametersManager::handle_message(const mavlink_message_t *msg)
 {
@@ -74,6 +74,16 @@ public:
 
 	void handle_message(const mavlink_message_t *msg);
 
+	/**
+	 * Message ids handled by handle_message()
+	 */
+	static constexpr uint32_t handled_messages[] {
+		MAVLINK_MSG_ID_PARAM_REQUEST_LIST,
+		MAVLINK_MSG_ID_PARAM_SET,
+		MAVLINK_MSG_ID_PARAM_REQUEST_READ,
+		MAVLINK_MSG_ID_PARAM_MAP_RC,
+	};
+
 private:
 	int		_send_all_index{-1};
 
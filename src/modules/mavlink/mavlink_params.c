@@ -155,3 +155,21 @@ PARAM_DEFINE_INT32(MAV_HB_FORW_EN, 1);
  * @max 250
  */
 PARAM_DEFINE_INT32(MAV_RADIO_TOUT, 5);
+
+/**
+ * Maximum number of packets per FTP burst
+ *
+ * Limits the number of data packets the FTP server sends in response to a single
+ * burst read request before it flags the burst as complete and waits for the
+ * client to request the next burst. This bounds the number of packets in flight,
+ * so that lost packets are detected and re-requested early on lossy links.
+ *
+ * If set to 0, the burst size is chosen automatically: bursts are split into
+ * chunks of about 35 kB if the link is bandwidth limited, otherwise the whole
+ * file is sent in a single burst.
+ *
+ * @group MAVLink
+ * @min 0
+ * @max 10000
+ */
+PARAM_DEFINE_INT32(MAV_FTP_WIN, 0);
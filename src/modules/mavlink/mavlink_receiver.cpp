@@ -105,6 +105,11 @@ MavlinkReceiver::MavlinkReceiver(Mavlink *parent) :
 	_parameters_manager(parent),
 	_mavlink_timesync(parent)
 {
+	register_message_handler(MavlinkMissionManager::handled_messages, MESSAGE_HANDLER_MISSION);
+	register_message_handler(MavlinkParametersManager::handled_messages, MESSAGE_HANDLER_PARAMETERS);
+	register_message_handler(MavlinkFTP::handled_messages, MESSAGE_HANDLER_FTP);
+	register_message_handler(MavlinkLogHandler::handled_messages, MESSAGE_HANDLER_LOG);
+	register_message_handler(MavlinkTimesync::handled_messages, MESSAGE_HANDLER_TIMESYNC);
 }
 
 void
@@ -3182,7 +3187,9 @@ MavlinkReceiver::run()
 
 #if defined(MAVLINK_UDP)
 	struct sockaddr_in srcaddr = {};
+#if !defined(__PX4_LINUX)
 	socklen_t addrlen = sizeof(srcaddr);
+#endif
 
 	if (_mavlink->get_protocol() == Protocol::UDP) {
 		fds[0].fd = _mavlink->get_socket_fd();
@@ -3191,6 +3198,33 @@ MavlinkReceiver::run()
 
 #endif // MAVLINK_UDP
 
+#if defined(MAVLINK_UDP) && defined(__PX4_LINUX)
+	/* receive up to MAX_DATAGRAMS datagrams per syscall, each into its own slice of buf */
+	static constexpr int MAX_DATAGRAMS = 5;
+#else
+	static constexpr int MAX_DATAGRAMS = 1;
+#endif
+	static constexpr size_t SEGMENT_SIZE = sizeof(buf) / MAX_DATAGRAMS;
+
+#if defined(MAVLINK_UDP) && defined(__PX4_LINUX)
+	struct sockaddr_in srcaddrs[MAX_DATAGRAMS] {};
+	struct iovec iovecs[MAX_DATAGRAMS] {};
+	struct mmsghdr msgs[MAX_DATAGRAMS] {};
+
+	for (int i = 0; i < MAX_DATAGRAMS; i++) {
+		iovecs[i].iov_base = &buf[i * SEGMENT_SIZE];
+		iovecs[i].iov_len = SEGMENT_SIZE;
+		msgs[i].msg_hdr.msg_iov = &iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &srcaddrs[i];
+	}
+
+#endif // MAVLINK_UDP && __PX4_LINUX
+
+	/* received data: segment i is stored at buf[i * SEGMENT_SIZE] */
+	ssize_t segment_len[MAX_DATAGRAMS] {};
+	int segments = 0;
+
 	ssize_t nread = 0;
 	hrt_abstime last_send_update = 0;
 
@@ -3206,9 +3240,14 @@ MavlinkReceiver::run()
 			updateParams();
 		}
 
-		int ret = poll(&fds[0], 1, timeout);
+		// while an FTP burst is active, wake up more often to keep the link busy
+		const bool ftp_streaming = _mavlink->ftp_enabled() && _mavlink_ftp.stream_active();
+		int ret = poll(&fds[0], 1, ftp_streaming ? 1 : timeout);
 
 		if (ret > 0) {
+			nread = 0;
+			segments = 0;
+
 			if (_mavlink->get_protocol() == Protocol::SERIAL) {
 				/* non-blocking read. read may return negative values */
 				nread = ::read(fds[0].fd, buf, sizeof(buf));
@@ -3216,92 +3255,153 @@ MavlinkReceiver::run()
 				if (nread == -1 && errno == ENOTCONN) { // Not connected (can happen for USB)
 					usleep(100000);
 				}
+
+				segment_len[0] = nread;
+				segments = 1;
 			}
 
 #if defined(MAVLINK_UDP)
 
 			else if (_mavlink->get_protocol() == Protocol::UDP) {
 				if (fds[0].revents & POLLIN) {
+#if defined(__PX4_LINUX)
+
+					for (int i = 0; i < MAX_DATAGRAMS; i++) {
+						msgs[i].msg_hdr.msg_namelen = sizeof(srcaddrs[i]);
+					}
+
+					const int received = recvmmsg(_mavlink->get_socket_fd(), msgs, MAX_DATAGRAMS, MSG_DONTWAIT, nullptr);
+
+					if (received > 0) {
+						for (int i = 0; i < received; i++) {
+							segment_len[i] = msgs[i].msg_len;
+							nread += msgs[i].msg_len;
+						}
+
+						segments = received;
+
+					} else {
+						nread = -1;
+					}
+
+#else
 					nread = recvfrom(_mavlink->get_socket_fd(), buf, sizeof(buf), 0, (struct sockaddr *)&srcaddr, &addrlen);
+					segment_len[0] = nread;
+					segments = 1;
+#endif // __PX4_LINUX
 				}
 
-				struct sockaddr_in &srcaddr_last = _mavlink->get_client_source_address();
+			}
+
+#endif // MAVLINK_UDP
+
+			/* if read failed, this loop won't execute */
+			for (int segment = 0; segment < segments; segment++) {
+#if defined(MAVLINK_UDP)
+
+				if (_mavlink->get_protocol() == Protocol::UDP) {
+#if defined(__PX4_LINUX)
+					// every datagram can come from another sender
+					srcaddr = srcaddrs[segment];
+#endif // __PX4_LINUX
 
-				int localhost = (127 << 24) + 1;
+					struct sockaddr_in &srcaddr_last = _mavlink->get_client_source_address();
 
-				if (!_mavlink->get_client_source_initialized()) {
+					int localhost = (127 << 24) + 1;
 
-					// set the address either if localhost or if 3 seconds have passed
-					// this ensures that a GCS running on localhost can get a hold of
-					// the system within the first N seconds
-					hrt_abstime stime = _mavlink->get_start_time();
+					if (!_mavlink->get_client_source_initialized()) {
 
-					if ((stime != 0 && (hrt_elapsed_time(&stime) > 3_s))
-					    || (srcaddr_last.sin_addr.s_addr == htonl(localhost))) {
+						// set the address either if localhost or if 3 seconds have passed
+						// this ensures that a GCS running on localhost can get a hold of
+						// the system within the first N seconds
+						hrt_abstime stime = _mavlink->get_start_time();
 
-						srcaddr_last.sin_addr.s_addr = srcaddr.sin_addr.s_addr;
-						srcaddr_last.sin_port = srcaddr.sin_port;
+						if ((stime != 0 && (hrt_elapsed_time(&stime) > 3_s))
+						    || (srcaddr_last.sin_addr.s_addr == htonl(localhost))) {
 
-						_mavlink->set_client_source_initialized();
+							srcaddr_last.sin_addr.s_addr = srcaddr.sin_addr.s_addr;
+							srcaddr_last.sin_port = srcaddr.sin_port;
 
-						PX4_INFO("partner IP: %s", inet_ntoa(srcaddr.sin_addr));
+							_mavlink->set_client_source_initialized();
+
+							PX4_INFO("partner IP: %s", inet_ntoa(srcaddr.sin_addr));
+						}
+					}
+
+					// only start accepting messages on UDP once we're sure who we talk to
+					if (!_mavlink->get_client_source_initialized()) {
+						continue;
 					}
 				}
-			}
 
-			// only start accepting messages on UDP once we're sure who we talk to
-			if (_mavlink->get_protocol() != Protocol::UDP || _mavlink->get_client_source_initialized()) {
 #endif // MAVLINK_UDP
 
-				/* if read failed, this loop won't execute */
-				for (ssize_t i = 0; i < nread; i++) {
-					if (mavlink_parse_char(_mavlink->get_channel(), buf[i], &msg, &_status)) {
+				_frame_parser.set_buffer(_mavlink->get_channel(), &buf[segment * SEGMENT_SIZE], segment_len[segment]);
 
-						/* check if we received version 2 and request a switch. */
-						if (!(_mavlink->get_status()->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)) {
-							/* this will only switch to proto version 2 if allowed in settings */
-							_mavlink->set_proto_version(2);
-						}
+				while (_frame_parser.parse(&msg, &_status)) {
 
-						/* handle generic messages and commands */
-						handle_message(&msg);
+					/* check if we received version 2 and request a switch. */
+					if (!(_mavlink->get_status()->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)) {
+						/* this will only switch to proto version 2 if allowed in settings */
+						_mavlink->set_proto_version(2);
+					}
+
+					/* handle generic messages and commands */
+					handle_message(&msg);
 
-						/* handle packet with mission manager */
+					/* components registered for this message */
+					const uint8_t handlers = _message_handlers.get(msg.msgid);
+
+					/* handle packet with mission manager */
+					if (handlers & MESSAGE_HANDLER_MISSION) {
 						_mission_manager.handle_message(&msg);
+					}
 
-						/* handle packet with parameter component */
-						if (_mavlink->boot_complete()) {
-							// make sure mavlink app has booted before we start processing parameter sync
+					/* handle packet with parameter component */
+					if (_mavlink->boot_complete()) {
+						// make sure mavlink app has booted before we start processing parameter sync
+						if (handlers & MESSAGE_HANDLER_PARAMETERS) {
 							_parameters_manager.handle_message(&msg);
-
-						} else {
-							if (hrt_elapsed_time(&_mavlink->get_first_start_time()) > 20_s) {
-								PX4_ERR("system boot did not complete in 20 seconds");
-								_mavlink->set_boot_complete();
-							}
 						}
 
-						if (_mavlink->ftp_enabled()) {
-							/* handle packet with ftp component */
-							_mavlink_ftp.handle_message(&msg);
+					} else {
+						if (hrt_elapsed_time(&_mavlink->get_first_start_time()) > 20_s) {
+							PX4_ERR("system boot did not complete in 20 seconds");
+							_mavlink->set_boot_complete();
 						}
+					}
 
-						/* handle packet with log component */
+					if ((handlers & MESSAGE_HANDLER_FTP) && _mavlink->ftp_enabled()) {
+						/* handle packet with ftp component */
+						_mavlink_ftp.handle_message(&msg);
+					}
+
+					/* handle packet with log component */
+					if (handlers & MESSAGE_HANDLER_LOG) {
 						_mavlink_log_handler.handle_message(&msg);
+					}
 
-						/* handle packet with timesync component */
+					/* handle packet with timesync component */
+					if (handlers & MESSAGE_HANDLER_TIMESYNC) {
 						_mavlink_timesync.handle_message(&msg);
+					}
 
-						/* handle packet with parent object */
-						_mavlink->handle_message(&msg);
+					/* handle packet with parent object */
+					_mavlink->handle_message(&msg);
 
-						update_rx_stats(msg);
+					update_rx_stats(msg);
 
-						if (_message_statistics_enabled) {
-							update_message_statistics(msg);
-						}
+					if (_message_statistics_enabled) {
+						update_message_statistics(msg);
 					}
 				}
+			}
+
+#if defined(MAVLINK_UDP)
+
+			// only count the received data on UDP once we're sure who we talk to
+			if (_mavlink->get_protocol() != Protocol::UDP || _mavlink->get_client_source_initialized()) {
+#endif // MAVLINK_UDP
 
 				/* count received bytes (nread will be -1 on read error) */
 				if (nread > 0) {
@@ -3353,11 +3453,17 @@ MavlinkReceiver::run()
 
 			_mavlink_log_handler.send();
 			last_send_update = t;
+
+		} else if (_mavlink->ftp_enabled() && _mavlink_ftp.stream_active()) {
+			_mavlink_ftp.send();
 		}
 
 		if (_tune_publisher != nullptr) {
 			_tune_publisher->publish_next_tune(t);
 		}
+
+		// send replies without waiting for the next transmit loop iteration
+		_mavlink->send_flush();
 	}
 }
 
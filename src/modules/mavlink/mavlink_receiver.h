@@ -43,8 +43,10 @@
 
 #pragma once
 
+#include "mavlink_frame_parser.h"
 #include "mavlink_ftp.h"
 #include "mavlink_log_handler.h"
+#include "mavlink_message_handler_table.h"
 #include "mavlink_mission.h"
 #include "mavlink_parameters.h"
 #include "MavlinkStatustextHandler.hpp"
@@ -236,6 +238,19 @@ private:
 	void update_message_statistics(const mavlink_message_t &message);
 	void update_rx_stats(const mavlink_message_t &message);
 
+	/**
+	 * Register the messages handled by a component in _message_handlers.
+	 */
+	template<size_t N>
+	void register_message_handler(const uint32_t (&msgids)[N], uint8_t handler)
+	{
+		for (const uint32_t msgid : msgids) {
+			if (!_message_handlers.add(msgid, handler)) {
+				PX4_ERR("message handler table full");
+			}
+		}
+	}
+
 	px4::atomic_bool 	_should_exit{false};
 	pthread_t		_thread {};
 	/**
@@ -252,6 +267,18 @@ private:
 	MavlinkTimesync			_mavlink_timesync;
 	MavlinkStatustextHandler	_mavlink_statustext_handler;
 
+	// components a received message is passed to, in addition to the receiver and the parent object
+	enum MessageHandler : uint8_t {
+		MESSAGE_HANDLER_MISSION    = (1 << 0),
+		MESSAGE_HANDLER_PARAMETERS = (1 << 1),
+		MESSAGE_HANDLER_FTP        = (1 << 2),
+		MESSAGE_HANDLER_LOG        = (1 << 3),
+		MESSAGE_HANDLER_TIMESYNC   = (1 << 4),
+	};
+
+	MavlinkMessageHandlerTable<64>	_message_handlers;
+
+	MavlinkFrameParser		_frame_parser;
 	mavlink_status_t		_status{}; ///< receiver status, used for mavlink_parse_char()
 
 	orb_advert_t _mavlink_log_pub{nullptr};
@@ -50,6 +50,67 @@ MavlinkStream::MavlinkStream(Mavlink *mavlink) :
 	_last_sent = hrt_absolute_time();
 }
 
+int
+MavlinkStream::scaled_interval() const
+{
+	int interval = _interval;
+
+	if (!const_rate()) {
+		interval /= _mavlink->get_rate_mult();
+	}
+
+	return interval;
+}
+
+void
+MavlinkStream::schedule(const hrt_abstime &t)
+{
+	const int interval = scaled_interval();
+
+	if ((_last_sent == 0) || (interval < 0)) {
+		// never sent or unlimited rate: due immediately
+		_next_update = 0;
+
+	} else if (interval == 0) {
+		// only sent manually
+		_next_update = UINT64_MAX;
+
+	} else {
+		// first time update() would send, see the early send margin there
+		const int64_t margin = (_mavlink->get_main_loop_delay() / 10) * 3;
+		const int64_t next_update = (int64_t)_last_sent + interval - margin + 1;
+		_next_update = (next_update > 0) ? next_update : 0;
+	}
+
+	if (update_data_enabled() && (_next_update > t + _mavlink->get_main_loop_delay())) {
+		_next_update = t + _mavlink->get_main_loop_delay();
+	}
+}
+
+void
+MavlinkStream::schedule_after_update(const hrt_abstime &t)
+{
+	schedule(t);
+
+	// already due again (e.g. interval shorter than the early send margin): next regular iteration
+	if (_next_update <= t) {
+		_next_update = t + _mavlink->get_main_loop_delay();
+	}
+}
+
+void
+MavlinkStream::update_jitter(int64_t lateness)
+{
+	const uint32_t jitter = (lateness < 0) ? -lateness : lateness;
+
+	_jitter_sum_us += jitter;
+	_jitter_count++;
+
+	if (jitter > _jitter_max_us) {
+		_jitter_max_us = jitter;
+	}
+}
+
 /**
  * Update subscriptions and send message if necessary
  */
@@ -58,6 +119,9 @@ MavlinkStream::update(const hrt_abstime &t)
 {
 	update_data();
 
+	// check again at the next regular iteration if there was nothing to send
+	const hrt_abstime retry = t + _mavlink->get_main_loop_delay();
+
 	// If the message has never been sent before we want
 	// to send it immediately and can return right away
 	if (_last_sent == 0) {
@@ -70,6 +134,11 @@ MavlinkStream::update(const hrt_abstime &t)
 			if (!_first_message_sent) {
 				_first_message_sent = true;
 			}
+
+			schedule_after_update(t);
+
+		} else {
+			_next_update = retry;
 		}
 
 		return 0;
@@ -78,18 +147,16 @@ MavlinkStream::update(const hrt_abstime &t)
 	// One of the previous iterations sent the update
 	// already before the deadline
 	if (_last_sent > t) {
+		schedule_after_update(t);
 		return -1;
 	}
 
 	int64_t dt = t - _last_sent;
-	int interval = _interval;
-
-	if (!const_rate()) {
-		interval /= _mavlink->get_rate_mult();
-	}
+	const int interval = scaled_interval();
 
 	// We don't need to send anything if the inverval is 0. send() will be called manually.
 	if (interval == 0) {
+		schedule_after_update(t);
 		return 0;
 	}
 
@@ -113,18 +180,28 @@ MavlinkStream::update(const hrt_abstime &t)
 		// distort the average rate. The check of the maximum interval is done to ensure that after a
 		// long time not sending anything, sending multiple messages in a short time is avoided.
 		if (send()) {
-			_last_sent = ((interval > 0) && ((int64_t)(1.5f * interval) > dt)) ? _last_sent + interval : t;
+			if ((interval > 0) && ((int64_t)(1.5f * interval) > dt)) {
+				update_jitter(dt - interval);
+				_last_sent += interval;
+
+			} else {
+				_last_sent = t;
+			}
 
 			if (!_first_message_sent) {
 				_first_message_sent = true;
 			}
 
+			schedule_after_update(t);
+
 			return 0;
 
 		} else {
+			_next_update = retry;
 			return -1;
 		}
 	}
 
+	schedule_after_update(t);
 	return -1;
 }
@@ -66,7 +66,7 @@ public:
 	 *
 	 * @param interval the interval in microseconds (us) between messages
 	 */
-	void set_interval(const int interval) { _interval = interval; }
+	void set_interval(const int interval) { _interval = interval; _next_update = 0; }
 
 	/**
 	 * Get the interval
@@ -79,6 +79,31 @@ public:
 	 * @return 0 if updated / sent, -1 if unchanged
 	 */
 	int update(const hrt_abstime &t);
+
+	/**
+	 * Get the time update() needs to be called next. Calling it earlier has no effect
+	 * (except for update_data()).
+	 *
+	 * @return the time of the next update, 0 if due immediately
+	 */
+	hrt_abstime get_next_update() const { return _next_update; }
+
+	/**
+	 * Recompute the time of the next update, e.g. after the rate multiplier changed.
+	 */
+	void schedule(const hrt_abstime &t);
+
+	/**
+	 * Scheduling jitter: deviation of the actual from the nominal send time, since the last reset_jitter()
+	 */
+	float get_jitter_mean() const { return (_jitter_count > 0) ? (float)_jitter_sum_us / _jitter_count : 0.f; }
+	uint32_t get_jitter_max() const { return _jitter_max_us; }
+	void reset_jitter()
+	{
+		_jitter_sum_us = 0;
+		_jitter_count = 0;
+		_jitter_max_us = 0;
+	}
 	virtual const char *get_name() const = 0;
 	virtual uint16_t get_id() = 0;
 
@@ -120,7 +145,7 @@ public:
 	 * Reset the time of last sent to 0. Can be used if a message over this
 	 * stream needs to be sent immediately.
 	 */
-	void reset_last_sent() { _last_sent = 0; }
+	void reset_last_sent() { _last_sent = 0; _next_update = 0; }
 
 protected:
 	Mavlink      *const _mavlink;
@@ -136,8 +161,28 @@ protected:
 	 */
 	virtual void update_data() { }
 
+	/**
+	 * @return true if update_data() is implemented and needs to be called at every iteration
+	 */
+	virtual bool update_data_enabled() const { return false; }
+
 private:
+	/**
+	 * @return the interval scaled by the current rate multiplier
+	 */
+	int scaled_interval() const;
+
+	void schedule_after_update(const hrt_abstime &t);
+
+	void update_jitter(int64_t lateness);
+
 	hrt_abstime _last_sent{0};
+	hrt_abstime _next_update{0};
+
+	uint64_t _jitter_sum_us{0};
+	uint32_t _jitter_count{0};
+	uint32_t _jitter_max_us{0};
+
 	bool _first_message_sent{false};
 };
 
@@ -0,0 +1,293 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/// @file mavlink_dispatch_test.cpp
+
+#include <drivers/drv_hrt.h>
+#include <string.h>
+
+#include "mavlink_dispatch_test.h"
+
+// Stand-ins for the receiver components. Like their handle_message(), they switch on the message id, and they are not
+// inlined as the components are in other translation units. The message lists match their handled_messages[].
+
+static int handled_count{0};
+
+static constexpr uint8_t handler_mission = 1 << 0;
+static constexpr uint8_t handler_parameters = 1 << 1;
+static constexpr uint8_t handler_ftp = 1 << 2;
+static constexpr uint8_t handler_log = 1 << 3;
+static constexpr uint8_t handler_timesync = 1 << 4;
+
+static constexpr uint32_t mission_messages[] {
+	MAVLINK_MSG_ID_MISSION_ACK,
+	MAVLINK_MSG_ID_MISSION_SET_CURRENT,
+	MAVLINK_MSG_ID_MISSION_REQUEST_LIST,
+	MAVLINK_MSG_ID_MISSION_REQUEST,
+	MAVLINK_MSG_ID_MISSION_REQUEST_INT,
+	MAVLINK_MSG_ID_MISSION_COUNT,
+	MAVLINK_MSG_ID_MISSION_ITEM,
+	MAVLINK_MSG_ID_MISSION_ITEM_INT,
+	MAVLINK_MSG_ID_MISSION_CLEAR_ALL,
+};
+
+static constexpr uint32_t parameters_messages[] {
+	MAVLINK_MSG_ID_PARAM_REQUEST_LIST,
+	MAVLINK_MSG_ID_PARAM_SET,
+	MAVLINK_MSG_ID_PARAM_REQUEST_READ,
+	MAVLINK_MSG_ID_PARAM_MAP_RC,
+};
+
+static constexpr uint32_t ftp_messages[] {
+	MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL,
+};
+
+static constexpr uint32_t log_messages[] {
+	MAVLINK_MSG_ID_LOG_REQUEST_LIST,
+	MAVLINK_MSG_ID_LOG_REQUEST_DATA,
+	MAVLINK_MSG_ID_LOG_ERASE,
+	MAVLINK_MSG_ID_LOG_REQUEST_END,
+};
+
+static constexpr uint32_t timesync_messages[] {
+	MAVLINK_MSG_ID_TIMESYNC,
+	MAVLINK_MSG_ID_SYSTEM_TIME,
+};
+
+__attribute__((noinline)) static void mission_handle_message(const mavlink_message_t *msg)
+{
+	switch (msg->msgid) {
+	case MAVLINK_MSG_ID_MISSION_ACK:
+	case MAVLINK_MSG_ID_MISSION_SET_CURRENT:
+	case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+	case MAVLINK_MSG_ID_MISSION_REQUEST:
+	case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+	case MAVLINK_MSG_ID_MISSION_COUNT:
+	case MAVLINK_MSG_ID_MISSION_ITEM:
+	case MAVLINK_MSG_ID_MISSION_ITEM_INT:
+	case MAVLINK_MSG_ID_MISSION_CLEAR_ALL:
+		handled_count++;
+		break;
+
+	default:
+		break;
+	}
+}
+
+__attribute__((noinline)) static void parameters_handle_message(const mavlink_message_t *msg)
+{
+	switch (msg->msgid) {
+	case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+	case MAVLINK_MSG_ID_PARAM_SET:
+	case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+	case MAVLINK_MSG_ID_PARAM_MAP_RC:
+		handled_count++;
+		break;
+
+	default:
+		break;
+	}
+}
+
+__attribute__((noinline)) static void ftp_handle_message(const mavlink_message_t *msg)
+{
+	if (msg->msgid == MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL) {
+		handled_count++;
+	}
+}
+
+__attribute__((noinline)) static void log_handle_message(const mavlink_message_t *msg)
+{
+	switch (msg->msgid) {
+	case MAVLINK_MSG_ID_LOG_REQUEST_LIST:
+	case MAVLINK_MSG_ID_LOG_REQUEST_DATA:
+	case MAVLINK_MSG_ID_LOG_ERASE:
+	case MAVLINK_MSG_ID_LOG_REQUEST_END:
+		handled_count++;
+		break;
+
+	default:
+		break;
+	}
+}
+
+__attribute__((noinline)) static void timesync_handle_message(const mavlink_message_t *msg)
+{
+	switch (msg->msgid) {
+	case MAVLINK_MSG_ID_TIMESYNC:
+	case MAVLINK_MSG_ID_SYSTEM_TIME:
+		handled_count++;
+		break;
+
+	default:
+		break;
+	}
+}
+
+template<size_t N>
+static bool register_message_handler(MavlinkMessageHandlerTable<64> &table, const uint32_t (&msgids)[N],
+				     uint8_t handler)
+{
+	for (size_t i = 0; i < N; i++) {
+		if (!table.add(msgids[i], handler)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void MavlinkDispatchTest::_init(void)
+{
+	_messages = new mavlink_message_t[MESSAGES_MAX];
+	_message_count = 0;
+}
+
+void MavlinkDispatchTest::_cleanup(void)
+{
+	delete[] _messages;
+	_messages = nullptr;
+}
+
+void MavlinkDispatchTest::_append_message(uint32_t msgid)
+{
+	if (_message_count < MESSAGES_MAX) {
+		memset(&_messages[_message_count], 0, sizeof(_messages[_message_count]));
+		_messages[_message_count].msgid = msgid;
+		_message_count++;
+	}
+}
+
+void MavlinkDispatchTest::_append_offboard_messages(uint32_t cycle)
+{
+	_append_message(MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED);
+	_append_message(MAVLINK_MSG_ID_ODOMETRY);
+
+	if (cycle % 10 == 0) {
+		_append_message(MAVLINK_MSG_ID_HEARTBEAT);
+		_append_message(MAVLINK_MSG_ID_TIMESYNC);
+	}
+
+	if (cycle % 20 == 0) {
+		_append_message(MAVLINK_MSG_ID_SYSTEM_TIME);
+		_append_message(MAVLINK_MSG_ID_PARAM_REQUEST_READ);
+		_append_message(MAVLINK_MSG_ID_MISSION_REQUEST_INT);
+	}
+}
+
+bool MavlinkDispatchTest::_dispatch_benchmark(void)
+{
+	ut_assert("register mission", register_message_handler(_message_handlers, mission_messages, handler_mission));
+	ut_assert("register parameters", register_message_handler(_message_handlers, parameters_messages,
+			handler_parameters));
+	ut_assert("register ftp", register_message_handler(_message_handlers, ftp_messages, handler_ftp));
+	ut_assert("register log", register_message_handler(_message_handlers, log_messages, handler_log));
+	ut_assert("register timesync", register_message_handler(_message_handlers, timesync_messages, handler_timesync));
+
+	for (uint32_t cycle = 0; _message_count + 7 <= MESSAGES_MAX; cycle++) {
+		_append_offboard_messages(cycle);
+	}
+
+	static constexpr int ITERATIONS = 1000;
+
+	// every component checks every message, as before MavlinkMessageHandlerTable
+	handled_count = 0;
+	const hrt_abstime unconditional_start = hrt_absolute_time();
+
+	for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+		for (size_t i = 0; i < _message_count; i++) {
+			const mavlink_message_t *msg = &_messages[i];
+			mission_handle_message(msg);
+			parameters_handle_message(msg);
+			ftp_handle_message(msg);
+			log_handle_message(msg);
+			timesync_handle_message(msg);
+		}
+	}
+
+	const hrt_abstime unconditional_elapsed = hrt_elapsed_time(&unconditional_start);
+	const int unconditional_handled = handled_count;
+
+	// only the components registered for the message, as MavlinkReceiver::run()
+	handled_count = 0;
+	const hrt_abstime table_start = hrt_absolute_time();
+
+	for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+		for (size_t i = 0; i < _message_count; i++) {
+			const mavlink_message_t *msg = &_messages[i];
+			const uint8_t handlers = _message_handlers.get(msg->msgid);
+
+			if (handlers & handler_mission) {
+				mission_handle_message(msg);
+			}
+
+			if (handlers & handler_parameters) {
+				parameters_handle_message(msg);
+			}
+
+			if (handlers & handler_ftp) {
+				ftp_handle_message(msg);
+			}
+
+			if (handlers & handler_log) {
+				log_handle_message(msg);
+			}
+
+			if (handlers & handler_timesync) {
+				timesync_handle_message(msg);
+			}
+		}
+	}
+
+	const hrt_abstime table_elapsed = hrt_elapsed_time(&table_start);
+	const int table_handled = handled_count;
+
+	ut_compare("handled count", table_handled, unconditional_handled);
+	ut_assert("no messages handled", unconditional_handled > 0);
+
+	const float messages = (float)_message_count * ITERATIONS;
+	PX4_INFO("%.0f messages, %d handled by a component", (double)messages, unconditional_handled);
+	PX4_INFO("unconditional: %.1f ns/msg", (double)((float)unconditional_elapsed * 1000.f / messages));
+	PX4_INFO("handler table: %.1f ns/msg", (double)((float)table_elapsed * 1000.f / messages));
+
+	return true;
+}
+
+bool MavlinkDispatchTest::run_tests(void)
+{
+	ut_run_test(_dispatch_benchmark);
+
+	return (_tests_failed == 0);
+}
+
+ut_declare_test(mavlink_dispatch_test, MavlinkDispatchTest)
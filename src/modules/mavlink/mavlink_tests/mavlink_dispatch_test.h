@@ -0,0 +1,75 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/// @file mavlink_dispatch_test.h
+/// Benchmarks passing received messages to the receiver components, with and without MavlinkMessageHandlerTable.
+
+#pragma once
+
+#include <unit_test.h>
+#include "../mavlink_bridge_header.h"
+#include "../mavlink_message_handler_table.h"
+
+class MavlinkDispatchTest : public UnitTest
+{
+public:
+	MavlinkDispatchTest() = default;
+	virtual ~MavlinkDispatchTest() = default;
+
+	virtual bool run_tests(void);
+
+	// We don't want any of these
+	MavlinkDispatchTest(const MavlinkDispatchTest &);
+	MavlinkDispatchTest &operator=(const MavlinkDispatchTest &);
+
+private:
+	virtual void _init(void);
+	virtual void _cleanup(void);
+
+	bool _dispatch_benchmark(void);
+
+	/// Append a message with the given id to _messages
+	void _append_message(uint32_t msgid);
+
+	/// Append the offboard control/telemetry message set received from a companion computer
+	void _append_offboard_messages(uint32_t cycle);
+
+	static constexpr size_t MESSAGES_MAX = 100;
+
+	mavlink_message_t	*_messages{nullptr};
+	size_t			_message_count{0};
+
+	MavlinkMessageHandlerTable<64> _message_handlers;
+};
+
+bool mavlink_dispatch_test(void);
@@ -0,0 +1,265 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/// @file mavlink_frame_parser_test.cpp
+
+#include <drivers/drv_hrt.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mavlink_frame_parser_test.h"
+
+void MavlinkFrameParserTest::_init(void)
+{
+	_data = new uint8_t[DATA_SIZE_MAX];
+	_data_len = 0;
+}
+
+void MavlinkFrameParserTest::_cleanup(void)
+{
+	delete[] _data;
+	_data = nullptr;
+}
+
+void MavlinkFrameParserTest::_append_message(const mavlink_message_t *msg)
+{
+	if (_data_len + MAVLINK_MAX_PACKET_LEN <= DATA_SIZE_MAX) {
+		_data_len += mavlink_msg_to_send_buffer(&_data[_data_len], msg);
+	}
+}
+
+void MavlinkFrameParserTest::_append_offboard_messages(uint32_t time_boot_ms)
+{
+	mavlink_message_t msg;
+
+	mavlink_set_position_target_local_ned_t setpoint{};
+	setpoint.time_boot_ms = time_boot_ms;
+	setpoint.x = 1.f;
+	setpoint.y = 2.f;
+	setpoint.z = -3.f;
+	setpoint.yaw = 0.5f;
+	setpoint.type_mask = 0x0DF8;
+	setpoint.target_system = 1;
+	setpoint.target_component = 1;
+	setpoint.coordinate_frame = MAV_FRAME_LOCAL_NED;
+	mavlink_msg_set_position_target_local_ned_encode(senderSystemId, senderComponentId, &msg, &setpoint);
+	_append_message(&msg);
+
+	// mostly zero covariances: the payload is truncated on the wire
+	mavlink_odometry_t odometry{};
+	odometry.time_usec = time_boot_ms * 1000ULL;
+	odometry.x = 1.f;
+	odometry.y = 2.f;
+	odometry.z = -3.f;
+	odometry.q[0] = 1.f;
+	odometry.frame_id = MAV_FRAME_LOCAL_FRD;
+	odometry.child_frame_id = MAV_FRAME_BODY_FRD;
+	mavlink_msg_odometry_encode(senderSystemId, senderComponentId, &msg, &odometry);
+	_append_message(&msg);
+}
+
+bool MavlinkFrameParserTest::_messages_equal(const mavlink_message_t &a, const mavlink_message_t &b)
+{
+	if ((a.msgid != b.msgid) || (a.seq != b.seq) || (a.sysid != b.sysid) || (a.compid != b.compid)
+	    || (a.len != b.len) || (a.magic != b.magic) || (a.checksum != b.checksum)) {
+		return false;
+	}
+
+	// compare including the zero-filled part of truncated payloads
+	const mavlink_msg_entry_t *entry = mavlink_get_msg_entry(a.msgid);
+	const size_t len = ((entry != nullptr) && (entry->max_msg_len > a.len)) ? entry->max_msg_len : a.len;
+
+	return memcmp(_MAV_PAYLOAD(&a), _MAV_PAYLOAD(&b), len) == 0;
+}
+
+/// @brief Parses a stream with MAVLink 2 and 1 frames, corrupted frames and garbage in between, split
+/// into chunks of different sizes, and compares the messages with byte-wise parsing.
+bool MavlinkFrameParserTest::_parse_compare_test(void)
+{
+	mavlink_message_t msg;
+
+	for (uint32_t i = 0; i < 20; i++) {
+		_append_offboard_messages(i * 20);
+
+		switch (i % 4) {
+		case 0:
+			// garbage, including start bytes
+			_data[_data_len++] = 0x55;
+			_data[_data_len++] = MAVLINK_STX;
+			_data[_data_len++] = 0x00;
+			break;
+
+		case 1: {
+				// corrupted frame
+				const size_t start = _data_len;
+				mavlink_msg_heartbeat_pack(senderSystemId, senderComponentId, &msg, MAV_TYPE_ONBOARD_CONTROLLER,
+							   MAV_AUTOPILOT_INVALID, 0, 0, MAV_STATE_ACTIVE);
+				_append_message(&msg);
+				_data[start + MAVLINK_NUM_HEADER_BYTES] ^= 0x10;
+			}
+			break;
+
+		case 2: {
+				// MAVLink 1 frame
+				mavlink_status_t *status = mavlink_get_channel_status(MAVLINK_COMM_0);
+				status->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+				mavlink_msg_heartbeat_pack(senderSystemId, senderComponentId, &msg, MAV_TYPE_ONBOARD_CONTROLLER,
+							   MAV_AUTOPILOT_INVALID, 0, 0, MAV_STATE_ACTIVE);
+				status->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+				_append_message(&msg);
+			}
+			break;
+
+		default:
+			mavlink_msg_heartbeat_pack(senderSystemId, senderComponentId, &msg, MAV_TYPE_ONBOARD_CONTROLLER,
+						   MAV_AUTOPILOT_INVALID, 0, 0, MAV_STATE_ACTIVE);
+			_append_message(&msg);
+			break;
+		}
+	}
+
+	// end with a complete frame so that the parser state is idle for the next test
+	_append_offboard_messages(1000);
+
+	static constexpr int MESSAGES_MAX = 128;
+	mavlink_message_t *expected = new mavlink_message_t[MESSAGES_MAX];
+	int expected_count = 0;
+	mavlink_status_t status{};
+
+	for (size_t i = 0; i < _data_len; i++) {
+		if (mavlink_parse_char(bytewiseChannel, _data[i], &msg, &status) && (expected_count < MESSAGES_MAX)) {
+			expected[expected_count++] = msg;
+		}
+	}
+
+	static const size_t chunk_sizes[] = {1, 7, 64, 300, 1500};
+	bool equal = true;
+
+	for (const size_t chunk_size : chunk_sizes) {
+		MavlinkFrameParser parser;
+		int count = 0;
+
+		for (size_t pos = 0; pos < _data_len; pos += chunk_size) {
+			const size_t len = (_data_len - pos < chunk_size) ? _data_len - pos : chunk_size;
+			parser.set_buffer(frameParserChannel, &_data[pos], len);
+
+			while (parser.parse(&msg, &status)) {
+				if ((count >= expected_count) || !_messages_equal(msg, expected[count])) {
+					equal = false;
+				}
+
+				count++;
+			}
+		}
+
+		if (!equal || (count != expected_count)) {
+			PX4_ERR("chunk size %zu: %d messages, expected %d", chunk_size, count, expected_count);
+			equal = false;
+			break;
+		}
+	}
+
+	delete[] expected;
+
+	ut_assert("messages differ from byte-wise parsing", equal);
+	ut_less_than("messages received", 40, expected_count);
+
+	return true;
+}
+
+/// @brief Parses offboard control traffic in chunks of a network receive buffer and prints the
+/// time per message for byte-wise parsing and the frame parser.
+bool MavlinkFrameParserTest::_throughput_benchmark(void)
+{
+	for (uint32_t i = 0; _data_len + 2 * MAVLINK_MAX_PACKET_LEN <= DATA_SIZE_MAX; i++) {
+		_append_offboard_messages(i * 5);
+	}
+
+	static constexpr int ITERATIONS = 20;
+	static constexpr size_t CHUNK_SIZE = 1000;
+	mavlink_message_t msg;
+	mavlink_status_t status{};
+
+	int bytewise_count = 0;
+	const hrt_abstime bytewise_start = hrt_absolute_time();
+
+	for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+		for (size_t i = 0; i < _data_len; i++) {
+			if (mavlink_parse_char(bytewiseChannel, _data[i], &msg, &status)) {
+				bytewise_count++;
+			}
+		}
+	}
+
+	const hrt_abstime bytewise_elapsed = hrt_elapsed_time(&bytewise_start);
+
+	MavlinkFrameParser parser;
+	int frame_parser_count = 0;
+	const hrt_abstime frame_parser_start = hrt_absolute_time();
+
+	for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+		for (size_t pos = 0; pos < _data_len; pos += CHUNK_SIZE) {
+			const size_t len = (_data_len - pos < CHUNK_SIZE) ? _data_len - pos : CHUNK_SIZE;
+			parser.set_buffer(frameParserChannel, &_data[pos], len);
+
+			while (parser.parse(&msg, &status)) {
+				frame_parser_count++;
+			}
+		}
+	}
+
+	const hrt_abstime frame_parser_elapsed = hrt_elapsed_time(&frame_parser_start);
+
+	ut_compare("message count", frame_parser_count, bytewise_count);
+	ut_assert("no messages", bytewise_count > 0);
+
+	const float bytes = (float)_data_len * ITERATIONS;
+	PX4_INFO("%d messages, %.0f bytes", bytewise_count, (double)bytes);
+	PX4_INFO("byte-wise:    %.3f us/msg, %.2f MB/s", (double)((float)bytewise_elapsed / bytewise_count),
+		 (double)(bytes / (float)bytewise_elapsed));
+	PX4_INFO("frame parser: %.3f us/msg, %.2f MB/s (%u frames scanned)",
+		 (double)((float)frame_parser_elapsed / frame_parser_count),
+		 (double)(bytes / (float)frame_parser_elapsed), parser.frames_scanned());
+
+	return true;
+}
+
+bool MavlinkFrameParserTest::run_tests(void)
+{
+	ut_run_test(_parse_compare_test);
+	ut_run_test(_throughput_benchmark);
+
+	return (_tests_failed == 0);
+}
+
+ut_declare_test(mavlink_frame_parser_test, MavlinkFrameParserTest)
@@ -0,0 +1,81 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/// @file mavlink_frame_parser_test.h
+/// Compares MavlinkFrameParser against byte-wise mavlink_parse_char() and benchmarks the throughput.
+
+#pragma once
+
+#include <unit_test.h>
+#include "../mavlink_frame_parser.h"
+
+class MavlinkFrameParserTest : public UnitTest
+{
+public:
+	MavlinkFrameParserTest() = default;
+	virtual ~MavlinkFrameParserTest() = default;
+
+	virtual bool run_tests(void);
+
+	// We don't want any of these
+	MavlinkFrameParserTest(const MavlinkFrameParserTest &);
+	MavlinkFrameParserTest &operator=(const MavlinkFrameParserTest &);
+
+private:
+	virtual void _init(void);
+	virtual void _cleanup(void);
+
+	bool _parse_compare_test(void);
+	bool _throughput_benchmark(void);
+
+	/// Append a message to _data as a wire frame
+	void _append_message(const mavlink_message_t *msg);
+
+	/// Append the offboard control/odometry message set sent by a companion computer
+	void _append_offboard_messages(uint32_t time_boot_ms);
+
+	static bool _messages_equal(const mavlink_message_t &a, const mavlink_message_t &b);
+
+	static constexpr size_t DATA_SIZE_MAX = 32768;
+
+	uint8_t		*_data{nullptr};
+	size_t		_data_len{0};
+
+	static constexpr mavlink_channel_t bytewiseChannel = MAVLINK_COMM_1;	///< channel used by mavlink_parse_char()
+	static constexpr mavlink_channel_t frameParserChannel = MAVLINK_COMM_2;	///< channel used by MavlinkFrameParser
+
+	static const uint8_t senderSystemId = 1;
+	static const uint8_t senderComponentId = 191;
+};
+
+bool mavlink_frame_parser_test(void);
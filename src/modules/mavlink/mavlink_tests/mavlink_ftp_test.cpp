@@ -644,6 +644,117 @@ bool MavlinkFtpTest::_burst_test()
 	return true;
 }
 
+/// @brief Tests that a burst stops after the configured window and can be continued at the next offset.
+bool MavlinkFtpTest::_burst_window_test()
+{
+	MavlinkFTP::PayloadHeader		payload {};
+	const MavlinkFTP::PayloadHeader		*reply;
+	mavlink_message_t			msg;
+
+	// Use the file which needs two packets
+	const DownloadTestCase *test = &_rgDownloadTestCases[2];
+
+	struct stat st;
+	ut_compare("stat failed", stat(test->file, &st), 0);
+	uint8_t *bytes = new uint8_t[st.st_size];
+	ut_assert("new failed", bytes != nullptr);
+	int fd = ::open(test->file, O_RDONLY);
+	ut_assert("open failed", fd != -1);
+	int bytes_read = ::read(fd, bytes, st.st_size);
+	ut_compare("read failed", bytes_read, st.st_size);
+	::close(fd);
+
+	payload.opcode = MavlinkFTP::kCmdOpenFileRO;
+	payload.offset = 0;
+	payload.size = strlen(test->file) + 1;
+
+	bool success = _send_receive_msg(&payload,		// FTP payload header
+					 (uint8_t *)test->file,	// Data to start into FTP message payload
+					 payload.size,	// size in bytes of data
+					 &reply);		// Payload inside FTP message response
+
+	if (!success) {
+		delete[] bytes;
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+
+	// A single packet per burst
+	_ftp_server->_burst_window = 1;
+
+	payload.opcode = MavlinkFTP::kCmdBurstReadFile;
+	payload.session = reply->session;
+	payload.size = MAX_DATA_LEN;
+
+	for (uint32_t offset = 0; offset < (uint32_t)st.st_size; offset += MAX_DATA_LEN) {
+		payload.offset = offset;
+		_setup_ftp_msg(&payload, nullptr, 0, &msg);
+		_ftp_server->handle_message(&msg);
+		_ftp_server->send();
+
+		// A second packet would have been sent with the next sequence number
+		_decode_message(&_reply_msg, &reply);
+
+		const uint32_t expected_bytes = st.st_size - offset > MAX_DATA_LEN ? MAX_DATA_LEN : st.st_size - offset;
+		ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+		ut_compare("Offset incorrect", reply->offset, offset);
+		ut_compare("Payload size incorrect", reply->size, expected_bytes);
+		ut_compare("burst_complete incorrect", reply->burst_complete, 1);
+		ut_compare("File contents differ", memcmp(reply->data, bytes + offset, expected_bytes), 0);
+		ut_assert("Burst still active after window", !_ftp_server->stream_active());
+	}
+
+	// Next burst is past the end of the file
+	payload.offset = st.st_size;
+	_setup_ftp_msg(&payload, nullptr, 0, &msg);
+	_ftp_server->handle_message(&msg);
+	_ftp_server->send();
+	_decode_message(&_reply_msg, &reply);
+
+	ut_compare("Didn't get Nak back", reply->opcode, MavlinkFTP::kRspNak);
+	ut_compare("Incorrect payload size", reply->size, 1);
+	ut_compare("Incorrect error code", reply->data[0], MavlinkFTP::kErrEOF);
+
+	// Gaps are filled with single reads, served from the read-ahead buffer
+	payload.opcode = MavlinkFTP::kCmdReadFile;
+	payload.offset = 1;
+	payload.size = MAX_DATA_LEN;
+
+	success = _send_receive_msg(&payload,	// FTP payload header
+				    nullptr,	// Data to start into FTP message payload
+				    0,		// size in bytes of data
+				    &reply);	// Payload inside FTP message response
+
+	if (!success) {
+		delete[] bytes;
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+	ut_compare("Payload size incorrect", reply->size, MAX_DATA_LEN);
+	ut_compare("Payload content differs", memcmp(reply->data, bytes + 1, MAX_DATA_LEN), 0);
+
+	payload.opcode = MavlinkFTP::kCmdTerminateSession;
+	payload.offset = 0;
+	payload.size = 0;
+
+	success = _send_receive_msg(&payload,	// FTP payload header
+				    nullptr,	// Data to start into FTP message payload
+				    0,		// size in bytes of data
+				    &reply);	// Payload inside FTP message response
+
+	delete[] bytes;
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+
+	return true;
+}
+
 /// @brief Tests for correct reponse to a Read command on an invalid session.
 bool MavlinkFtpTest::_read_badsession_test()
 {
@@ -1017,6 +1128,7 @@ bool MavlinkFtpTest::run_tests()
 	ut_run_test(_read_test);
 	ut_run_test(_read_badsession_test);
 	ut_run_test(_burst_test);
+	ut_run_test(_burst_window_test);
 	ut_run_test(_removedirectory_test);
 	ut_run_test(_createdirectory_test);
 	ut_run_test(_removefile_test);
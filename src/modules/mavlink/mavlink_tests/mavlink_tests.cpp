@@ -37,11 +37,17 @@
 
 #include <systemlib/err.h>
 
+#include "mavlink_dispatch_test.h"
+#include "mavlink_frame_parser_test.h"
 #include "mavlink_ftp_test.h"
 
 extern "C" __EXPORT int mavlink_tests_main(int argc, char *argv[]);
 
 int mavlink_tests_main(int argc, char *argv[])
 {
-	return mavlink_ftp_test() ? 0 : -1;
+	bool success = mavlink_ftp_test();
+	success = mavlink_frame_parser_test() && success;
+	success = mavlink_dispatch_test() && success;
+
+	return success ? 0 : -1;
 }
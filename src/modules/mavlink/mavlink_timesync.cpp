@@ -48,6 +48,8 @@ MavlinkTimesync::MavlinkTimesync(Mavlink *mavlink) :
 {
 }
 
+constexpr uint32_t MavlinkTimesync::handled_messages[];
+
 void
 MavlinkTimesync::handle_message(const mavlink_message_t *msg)
 {
@@ -54,6 +54,14 @@ public:
 
 	void handle_message(const mavlink_message_t *msg);
 
+	/**
+	 * Message ids handled by handle_message()
+	 */
+	static constexpr uint32_t handled_messages[] {
+		MAVLINK_MSG_ID_TIMESYNC,
+		MAVLINK_MSG_ID_SYSTEM_TIME,
+	};
+
 	/**
 	 * Convert remote timestamp to local hrt time (usec)
 	 * Use synchronised time if available, monotonic boot time otherwise
@@ -484,6 +484,8 @@ private:
 		return false;
 	}
 
+	bool update_data_enabled() const override { return true; }
+
 	void update_data() override
 	{
 		const hrt_abstime t = hrt_absolute_time();
@@ -0,0 +1,179 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "PerfReporter.hpp"
+
+#include <string.h>
+
+PerfReporter::PerfReporter() :
+	ScheduledWorkItem(MODULE_NAME, px4::wq_configurations::lp_default)
+{
+}
+
+PerfReporter::~PerfReporter()
+{
+	ScheduleClear();
+}
+
+void PerfReporter::start()
+{
+	ScheduleOnInterval(SCHEDULE_INTERVAL);
+}
+
+void PerfReporter::perf_iterate_callback(perf_counter_t handle, void *user)
+{
+	PerfReporter *reporter = static_cast<PerfReporter *>(user);
+	const unsigned index = reporter->_num_counters++;
+
+	if ((index < reporter->_cursor) || (index >= MAX_COUNTERS)
+	    || (reporter->_num_reports >= COUNTERS_PER_CYCLE)) {
+		return;
+	}
+
+	// called with the perf counter list locked, copy everything (including the name) here
+	perf_counter_values values;
+	perf_get_values(handle, &values);
+
+	const hrt_abstime now = hrt_absolute_time();
+	CounterState &state = reporter->_counters[index];
+	perf_counter_delta_s &report = reporter->_reports[reporter->_num_reports++];
+
+	report = {};
+	strncpy(report.name, values.name, sizeof(report.name) - 1);
+	report.type = values.type;
+	report.elapsed_max = values.time_most;
+
+	if ((state.handle == handle) && (state.timestamp != 0)
+	    && (values.event_count >= state.event_count) && (values.time_total >= state.time_total)) {
+
+		report.interval = math::min(now - state.timestamp, (hrt_abstime)UINT32_MAX);
+		report.events = math::min(values.event_count - state.event_count, (uint64_t)UINT32_MAX);
+		report.elapsed = values.time_total - state.time_total;
+
+	} else {
+		// new counter at this position or reset: values since the counter was created or reset
+		report.interval = 0;
+		report.events = math::min(values.event_count, (uint64_t)UINT32_MAX);
+		report.elapsed = values.time_total;
+	}
+
+	state.handle = handle;
+	state.event_count = values.event_count;
+	state.time_total = values.time_total;
+	state.timestamp = now;
+}
+
+void PerfReporter::Run()
+{
+	if (should_exit()) {
+		ScheduleClear();
+		exit_and_cleanup();
+		return;
+	}
+
+	_num_counters = 0;
+	_num_reports = 0;
+
+	perf_iterate_all(perf_iterate_callback, this);
+
+	for (unsigned i = 0; i < _num_reports; i++) {
+		_reports[i].timestamp = hrt_absolute_time();
+		_perf_counter_delta_pub.publish(_reports[i]);
+	}
+
+	// continue with the next counters next cycle
+	_cursor += COUNTERS_PER_CYCLE;
+
+	if (_cursor >= math::min(_num_counters, MAX_COUNTERS)) {
+		_cursor = 0;
+	}
+}
+
+int PerfReporter::print_status()
+{
+	PX4_INFO("reporting %u of %u perf counters, %u per %" PRIu32 " ms", math::min(_num_counters, MAX_COUNTERS),
+		 _num_counters, COUNTERS_PER_CYCLE, SCHEDULE_INTERVAL / 1000);
+	return 0;
+}
+
+int PerfReporter::task_spawn(int argc, char *argv[])
+{
+	PerfReporter *instance = new PerfReporter();
+
+	if (!instance) {
+		PX4_ERR("alloc failed");
+		return PX4_ERROR;
+	}
+
+	_object.store(instance);
+	_task_id = task_id_is_work_queue;
+
+	instance->start();
+
+	return PX4_OK;
+}
+
+int PerfReporter::custom_command(int argc, char *argv[])
+{
+	return print_usage("unknown command");
+}
+
+int PerfReporter::print_usage(const char *reason)
+{
+	if (reason) {
+		PX4_WARN("%s\n", reason);
+	}
+
+	PRINT_MODULE_DESCRIPTION(
+		R"DESCR_STR(
+### Description
+Background process on the low priority work queue that continuously publishes the perf counters
+(`perf_counter_delta` topic) for the logger: the number of events and the elapsed time since the
+previous report of each counter, and its maximum elapsed time or interval.
+
+All counters are reported in turn, 8 counters every 50 ms.
+Started at boot if SYS_PERF_RPT is set.
+)DESCR_STR");
+
+	PRINT_MODULE_USAGE_NAME("perf_reporter", "system");
+	PRINT_MODULE_USAGE_COMMAND("start");
+	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
+
+	return 0;
+}
+
+extern "C" __EXPORT int perf_reporter_main(int argc, char *argv[])
+{
+	return PerfReporter::main(argc, argv);
+}
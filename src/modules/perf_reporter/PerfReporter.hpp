@@ -0,0 +1,94 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <lib/mathlib/mathlib.h>
+#include <lib/perf/perf_counter.h>
+#include <px4_platform_common/defines.h>
+#include <px4_platform_common/module.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+#include <uORB/Publication.hpp>
+#include <uORB/topics/perf_counter_delta.h>
+
+using namespace time_literals;
+
+class PerfReporter : public ModuleBase<PerfReporter>, public px4::ScheduledWorkItem
+{
+public:
+	PerfReporter();
+	~PerfReporter() override;
+
+	/** @see ModuleBase */
+	static int task_spawn(int argc, char *argv[]);
+
+	/** @see ModuleBase */
+	static int custom_command(int argc, char *argv[]);
+
+	/** @see ModuleBase */
+	static int print_usage(const char *reason = nullptr);
+
+	/** @see ModuleBase::print_status() */
+	int print_status() override;
+
+	void start();
+
+private:
+
+	static constexpr unsigned MAX_COUNTERS{256}; // counters beyond are not reported
+	static constexpr unsigned COUNTERS_PER_CYCLE{8};
+	static constexpr uint32_t SCHEDULE_INTERVAL{50_ms}; // 20 Hz, all of 160 counters are reported every second
+
+	void Run() override;
+
+	static void perf_iterate_callback(perf_counter_t handle, void *user);
+
+	// values at the previous report, by position in the perf counter list
+	struct CounterState {
+		perf_counter_t handle;
+		uint64_t event_count;
+		uint64_t time_total;
+		hrt_abstime timestamp;
+	};
+
+	CounterState _counters[MAX_COUNTERS] {};
+
+	perf_counter_delta_s _reports[COUNTERS_PER_CYCLE] {};
+	unsigned _num_reports{0};
+
+	unsigned _cursor{0}; // first counter to report this cycle
+	unsigned _num_counters{0};
+
+	uORB::Publication<perf_counter_delta_s> _perf_counter_delta_pub{ORB_ID(perf_counter_delta)};
+};
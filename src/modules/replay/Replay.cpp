@@ -183,16 +183,17 @@ Replay::setUserParams(const char *filename)
 }
 
 bool
-Replay::readFileHeader(std::ifstream &file)
+Replay::readFileHeader()
 {
-	file.seekg(0);
-	ulog_file_header_s msg_header;
-	file.read((char *)&msg_header, sizeof(msg_header));
+	const uint8_t *header_data = _file.data(0, sizeof(ulog_file_header_s));
 
-	if (!file) {
+	if (!header_data) {
 		return false;
 	}
 
+	ulog_file_header_s msg_header;
+	memcpy(&msg_header, header_data, sizeof(msg_header));
+
 	_file_start_time = msg_header.timestamp;
 	//verify it's an ULog file
 	char magic[8];
@@ -207,76 +208,73 @@ Replay::readFileHeader(std::ifstream &file)
 }
 
 bool
-Replay::readFileDefinitions(std::ifstream &file)
+Replay::readFileDefinitions()
 {
 	PX4_INFO("Applying params from ULog file...");
 
 	ulog_message_header_s message_header;
-	file.seekg(sizeof(ulog_file_header_s));
+	size_t offset = sizeof(ulog_file_header_s);
 
 	while (true) {
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+		const uint8_t *message = _file.message(offset, message_header);
 
-		if (!file) {
+		if (!message) {
 			return false;
 		}
 
 		switch (message_header.msg_type) {
 		case (int)ULogMessageType::FLAG_BITS:
-			if (!readFlagBits(file, message_header.msg_size)) {
+			if (!readFlagBits(message, message_header.msg_size)) {
 				return false;
 			}
 
 			break;
 
 		case (int)ULogMessageType::FORMAT:
-			if (!readFormat(file, message_header.msg_size)) {
+			if (!readFormat(message, message_header.msg_size)) {
 				return false;
 			}
 
 			break;
 
 		case (int)ULogMessageType::PARAMETER:
-			if (!readAndApplyParameter(file, message_header.msg_size)) {
+			if (!readAndApplyParameter(message, message_header.msg_size)) {
 				return false;
 			}
 
 			break;
 
 		case (int)ULogMessageType::ADD_LOGGED_MSG:
-			_data_section_start = file.tellg() - (streamoff)ULOG_MSG_HEADER_LEN;
+			_data_section_start = offset;
 			return true;
 
 		case (int)ULogMessageType::INFO: //skip
 		case (int)ULogMessageType::INFO_MULTIPLE: //skip
 		case (int)ULogMessageType::PARAMETER_DEFAULT:
-			file.seekg(message_header.msg_size, ios::cur);
 			break;
 
 		default:
 			PX4_ERR("unknown log definition type %i, size %i (offset %i)",
-				(int)message_header.msg_type, (int)message_header.msg_size, (int)file.tellg());
-			file.seekg(message_header.msg_size, ios::cur);
+				(int)message_header.msg_type, (int)message_header.msg_size, (int)offset);
 			break;
 		}
+
+		offset += ULOG_MSG_HEADER_LEN + message_header.msg_size;
 	}
 
 	return true;
 }
 
 bool
-Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
+Replay::readFlagBits(const uint8_t *message, uint16_t msg_size)
 {
 	if (msg_size != 40) {
 		PX4_ERR("unsupported message length for FLAG_BITS message (%i)", msg_size);
 		return false;
 	}
 
-	_read_buffer.reserve(msg_size);
-	uint8_t *message = (uint8_t *)_read_buffer.data();
-	file.read((char *)message, msg_size);
-	//uint8_t *compat_flags = message;
-	uint8_t *incompat_flags = message + 8;
+	//const uint8_t *compat_flags = message;
+	const uint8_t *incompat_flags = message + 8;
 
 	// handle & validate the flags
 	bool contains_appended_data = incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK;
@@ -312,18 +310,9 @@ Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
 }
 
 bool
-Replay::readFormat(std::ifstream &file, uint16_t msg_size)
+Replay::readFormat(const uint8_t *message, uint16_t msg_size)
 {
-	_read_buffer.reserve(msg_size + 1);
-	char *format = (char *)_read_buffer.data();
-	file.read(format, msg_size);
-	format[msg_size] = 0;
-
-	if (!file) {
-		return false;
-	}
-
-	string str_format(format);
+	string str_format((const char *)message, strnlen((const char *)message, msg_size));
 	size_t pos = str_format.find(':');
 
 	if (pos == string::npos) {
@@ -368,27 +357,21 @@ string Replay::parseOrbFields(const string &fields)
 }
 
 bool
-Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
+Replay::readAndAddSubscription(const uint8_t *message, uint16_t msg_size)
 {
-	_read_buffer.reserve(msg_size + 1);
-	char *message = (char *)_read_buffer.data();
-	streampos this_message_pos = file.tellg() - (streamoff)ULOG_MSG_HEADER_LEN;
-	file.read(message, msg_size);
-	message[msg_size] = 0;
-
-	if (!file) {
+	if (msg_size <= 3) {
 		return false;
 	}
 
-	if (file.tellg() <= _subscription_file_pos) { //already read this subscription
+	uint8_t multi_id = message[0];
+	uint16_t msg_id = ((uint16_t) message[1]) | (((uint16_t) message[2]) << 8);
+	string topic_name((const char *)message + 3, strnlen((const char *)message + 3, msg_size - 3));
+
+	if (msg_id < _subscriptions.size() && _subscriptions[msg_id]) {
+		PX4_WARN("msg_id %i of %s is already used. Will ignore it", msg_id, topic_name.c_str());
 		return true;
 	}
 
-	_subscription_file_pos = file.tellg();
-
-	uint8_t multi_id = *(uint8_t *)message;
-	uint16_t msg_id = ((uint16_t) message[1]) | (((uint16_t) message[2]) << 8);
-	string topic_name(message + 3);
 	const orb_metadata *orb_meta = findTopic(topic_name);
 
 	if (!orb_meta) {
@@ -494,17 +477,9 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 	}
 
 	//find first data message (and the timestamp)
-	streampos cur_pos = file.tellg();
-	subscription->next_read_pos = this_message_pos; //this will be skipped
-
-	if (!nextDataMessage(file, *subscription, msg_id)) {
-		delete subscription;
-		return false;
-	}
+	subscription->next_index = 0;
 
-	file.seekg(cur_pos);
-
-	if (!subscription->orb_meta) {
+	if (!findDataMessage(*subscription, msg_id)) {
 		//no message found. This is not a fatal error
 		delete subscription;
 		return true;
@@ -555,51 +530,64 @@ Replay::findFieldOffset(const string &format, const string &field_name, int &off
 	return false;
 }
 
-bool
-Replay::readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position)
+void
+Replay::addSubscriptions()
 {
 	ulog_message_header_s message_header;
 
-	while (file.tellg() < end_position) {
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	for (uint64_t offset : _file.otherMessages()) {
+		const uint8_t *message = _file.message(offset, message_header);
 
-		if (!file) {
-			return false;
+		if (message && message_header.msg_type == (int)ULogMessageType::ADD_LOGGED_MSG) {
+			readAndAddSubscription(message, message_header.msg_size);
+		}
+	}
+}
+
+void
+Replay::readAndHandleAdditionalMessages(size_t end_position)
+{
+	const std::vector<uint64_t> &other_messages = _file.otherMessages();
+	ulog_message_header_s message_header;
+
+	for (; _next_additional_message < other_messages.size()
+	     && other_messages[_next_additional_message] < end_position; ++_next_additional_message) {
+
+		const uint8_t *message = _file.message(other_messages[_next_additional_message], message_header);
+
+		if (!message) {
+			continue;
 		}
 
 		switch (message_header.msg_type) {
 		case (int)ULogMessageType::PARAMETER:
-			if (!readAndApplyParameter(file, message_header.msg_size)) {
-				return false;
-			}
-
+			readAndApplyParameter(message, message_header.msg_size);
 			break;
 
 		case (int)ULogMessageType::DROPOUT:
-			readDropout(file, message_header.msg_size);
+			readDropout(message, message_header.msg_size);
 			break;
 
-		default: //skip all others
-			file.seekg(message_header.msg_size, ios::cur);
+		default: //skip all others (subscriptions are added upfront)
 			break;
 		}
 	}
-
-	return true;
 }
 
 bool
-Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
+Replay::readAndApplyParameter(const uint8_t *message, uint16_t msg_size)
 {
-	_read_buffer.reserve(msg_size);
-	uint8_t *message = (uint8_t *)_read_buffer.data();
-	file.read((char *)message, msg_size);
-
-	if (!file) {
+	if (msg_size < 1) {
 		return false;
 	}
 
 	uint8_t key_len = message[0];
+
+	// the value (int32_t or float) follows the key
+	if (msg_size < 1 + key_len + sizeof(int32_t)) {
+		return false;
+	}
+
 	string key((char *)message + 1, key_len);
 
 	size_t pos = key.find(' ');
@@ -631,99 +619,57 @@ Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
 }
 
 bool
-Replay::readDropout(std::ifstream &file, uint16_t msg_size)
+Replay::readDropout(const uint8_t *message, uint16_t msg_size)
 {
+	if (msg_size < sizeof(uint16_t)) {
+		return false;
+	}
+
 	uint16_t duration;
-	file.read((char *)&duration, sizeof(duration));
+	memcpy(&duration, message, sizeof(duration));
 
 	PX4_ERR("Dropout in replayed log, %i ms", (int)duration);
-	return file.good();
+	return true;
 }
 
 bool
-Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id)
+Replay::nextDataMessage(Subscription &subscription, int msg_id)
 {
-	ulog_message_header_s message_header;
-	file.seekg(subscription.next_read_pos);
-	//ignore the first message (it's data we already read)
-	file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
-
-	if (file) {
-		file.seekg(message_header.msg_size, ios::cur);
-	}
-
-	uint16_t file_msg_id;
-	bool done = false;
+	//skip the current message (it's data we already read)
+	++subscription.next_index;
+	return findDataMessage(subscription, msg_id);
+}
 
-	while (file && !done) {
-		streampos cur_pos = file.tellg();
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+bool
+Replay::findDataMessage(Subscription &subscription, int msg_id)
+{
+	const std::vector<uint64_t> &data_messages = _file.dataMessages(msg_id);
+	const size_t expected_msg_size = subscription.orb_meta->o_size_no_padding + 2;
+	ulog_message_header_s message_header;
 
-		if (!file) {
-			break;
-		}
+	for (; subscription.next_index < data_messages.size(); ++subscription.next_index) {
+		const size_t offset = data_messages[subscription.next_index];
+		const uint8_t *message = _file.message(offset, message_header);
 
-		if (((streamoff)cur_pos) + ULOG_MSG_HEADER_LEN + message_header.msg_size > _read_until_file_position) {
-			file.setstate(std::ios::eofbit);
+		if (!message) {
 			break;
 		}
 
-		switch (message_header.msg_type) {
-		case (int)ULogMessageType::ADD_LOGGED_MSG:
-			readAndAddSubscription(file, message_header.msg_size);
-			break;
-
-		case (int)ULogMessageType::DATA:
-			file.read((char *)&file_msg_id, sizeof(file_msg_id));
-
-			if (file) {
-				if (msg_id == file_msg_id) {
-					if (message_header.msg_size == subscription.orb_meta->o_size_no_padding + 2) {
-						subscription.next_read_pos = cur_pos;
-						file.seekg(subscription.timestamp_offset, ios::cur);
-						file.read((char *)&subscription.next_timestamp, sizeof(subscription.next_timestamp));
-						done = true;
-
-					} else { //sanity check failed!
-						PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
-							subscription.orb_meta->o_name, message_header.msg_size,
-							subscription.orb_meta->o_size_no_padding + 2);
-						file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
-					}
-
-				} else { //not the one we are looking for
-					file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
-				}
-			}
-
-			break;
-
-		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
-		case (int)ULogMessageType::PARAMETER:
-		case (int)ULogMessageType::DROPOUT:
-		case (int)ULogMessageType::INFO:
-		case (int)ULogMessageType::INFO_MULTIPLE:
-		case (int)ULogMessageType::SYNC:
-		case (int)ULogMessageType::LOGGING:
-		case (int)ULogMessageType::PARAMETER_DEFAULT:
-			file.seekg(message_header.msg_size, ios::cur);
-			break;
-
-		default:
-			//this really should not happen
-			PX4_ERR("unknown log message type %i, size %i (offset %i)",
-				(int)message_header.msg_type, (int)message_header.msg_size, (int)file.tellg());
-			file.seekg(message_header.msg_size, ios::cur);
-			break;
+		if (message_header.msg_size == expected_msg_size) {
+			subscription.next_read_pos = offset;
+			memcpy(&subscription.next_timestamp, message + 2 + subscription.timestamp_offset,
+			       sizeof(subscription.next_timestamp));
+			return true;
 		}
-	}
 
-	if (file.eof()) { //no more data messages for this subscription
-		subscription.orb_meta = nullptr;
-		file.clear();
+		//sanity check failed!
+		PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
+			subscription.orb_meta->o_name, message_header.msg_size, (int)expected_msg_size);
 	}
 
-	return file.good();
+	//no more data messages for this subscription
+	subscription.orb_meta = nullptr;
+	return false;
 }
 
 const orb_metadata *
@@ -799,7 +745,7 @@ Replay::sizeOfFullType(const std::string &type_name_full)
 }
 
 bool
-Replay::readDefinitionsAndApplyParams(std::ifstream &file)
+Replay::readDefinitionsAndApplyParams()
 {
 	// log reader currently assumes little endian
 	int num = 1;
@@ -809,18 +755,18 @@ Replay::readDefinitionsAndApplyParams(std::ifstream &file)
 		return false;
 	}
 
-	if (!file.is_open()) {
+	if (!_file.open(_replay_file)) {
 		PX4_ERR("Failed to open replay file");
 		return false;
 	}
 
-	if (!readFileHeader(file)) {
+	if (!readFileHeader()) {
 		PX4_ERR("Failed to read file header. Not a valid ULog file");
 		return false;
 	}
 
 	//initialize the formats and apply the parameters from the log file
-	if (!readFileDefinitions(file)) {
+	if (!readFileDefinitions()) {
 		PX4_ERR("Failed to read ULog definitions section. Broken file?");
 		return false;
 	}
@@ -832,12 +778,19 @@ Replay::readDefinitionsAndApplyParams(std::ifstream &file)
 void
 Replay::run()
 {
-	ifstream replay_file(_replay_file, ios::in | ios::binary);
+	if (!readDefinitionsAndApplyParams()) {
+		return;
+	}
 
-	if (!readDefinitionsAndApplyParams(replay_file)) {
+	if (!_file.loadOrBuildIndex(_data_section_start, _read_until_file_position)) {
+		PX4_ERR("Failed to index replay file");
 		return;
 	}
 
+	if (_file.indexLoadedFromFile()) {
+		PX4_INFO("Using message index from %s", _file.indexFileName().c_str());
+	}
+
 	_speed_factor = 1.f;
 	const char *speedup = getenv("PX4_SIM_SPEED_FACTOR");
 
@@ -851,22 +804,12 @@ Replay::run()
 
 	PX4_INFO("Replay in progress...");
 
-	ulog_message_header_s message_header;
-	replay_file.seekg(_data_section_start);
-
-	//we know the next message must be an ADD_LOGGED_MSG
-	replay_file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
-
-	if (!readAndAddSubscription(replay_file, message_header.msg_size)) {
-		PX4_ERR("Failed to read subscription");
-		return;
-	}
+	addSubscriptions();
 
 	const uint64_t timestamp_offset = getTimestampOffset();
 	uint32_t nr_published_messages = 0;
-	streampos last_additional_message_pos = _data_section_start;
 
-	while (!should_exit() && replay_file) {
+	while (!should_exit()) {
 
 		//Find the next message to publish. Messages from different subscriptions don't need
 		//to be in chronological order, so we need to check all subscriptions
@@ -898,27 +841,24 @@ Replay::run()
 
 		if (next_file_time == 0) {
 			//someone didn't set the timestamp properly. Consider the message invalid
-			nextDataMessage(replay_file, sub, next_msg_id);
+			nextDataMessage(sub, next_msg_id);
 			continue;
 		}
 
 		//handle additional messages between last and next published data
-		replay_file.seekg(last_additional_message_pos);
-		streampos next_additional_message_pos = sub.next_read_pos;
-		readAndHandleAdditionalMessages(replay_file, next_additional_message_pos);
-		last_additional_message_pos = next_additional_message_pos;
+		readAndHandleAdditionalMessages(sub.next_read_pos);
 
 		const uint64_t publish_timestamp = handleTopicDelay(next_file_time, timestamp_offset);
 
 		// It's time to publish
-		readTopicDataToBuffer(sub, replay_file);
+		readTopicDataToBuffer(sub);
 		memcpy(_read_buffer.data() + sub.timestamp_offset, &publish_timestamp, sizeof(uint64_t)); //adjust the timestamp
 
-		if (handleTopicUpdate(sub, _read_buffer.data(), replay_file)) {
+		if (handleTopicUpdate(sub, _read_buffer.data())) {
 			++nr_published_messages;
 		}
 
-		nextDataMessage(replay_file, sub, next_msg_id);
+		nextDataMessage(sub, next_msg_id);
 
 		// TODO: output status (eg. every sec), including total duration...
 	}
@@ -947,7 +887,7 @@ Replay::run()
 	onExitMainLoop();
 
 	if (!should_exit()) {
-		replay_file.close();
+		_file.close();
 		px4_shutdown_request();
 		// we need to ensure the shutdown logic gets updated and eventually triggers shutdown
 		hrt_abstime t = hrt_absolute_time();
@@ -962,17 +902,17 @@ Replay::run()
 }
 
 void
-Replay::readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file)
+Replay::readTopicDataToBuffer(const Subscription &sub)
 {
 	const size_t msg_read_size = sub.orb_meta->o_size_no_padding;
 	const size_t msg_write_size = sub.orb_meta->o_size;
 	_read_buffer.reserve(msg_write_size);
-	replay_file.seekg(sub.next_read_pos + (streamoff)(ULOG_MSG_HEADER_LEN + 2)); //skip header & msg id
-	replay_file.read((char *)_read_buffer.data(), msg_read_size);
+	//skip header & msg id (the message size was checked in findDataMessage())
+	memcpy(_read_buffer.data(), _file.data(sub.next_read_pos + ULOG_MSG_HEADER_LEN + 2, msg_read_size), msg_read_size);
 }
 
 bool
-Replay::handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file)
+Replay::handleTopicUpdate(Subscription &sub, void *data)
 {
 	return publishTopic(sub, data);
 }
@@ -1118,9 +1058,7 @@ Replay::applyParams(bool quiet)
 		return -ENOMEM;
 	}
 
-	ifstream replay_file(_replay_file, ios::in | ios::binary);
-
-	if (!r->readDefinitionsAndApplyParams(replay_file)) {
+	if (!r->readDefinitionsAndApplyParams()) {
 		ret = -1;
 	}
 
@@ -1171,6 +1109,9 @@ The module is typically used together with uORB publisher rules, to specify whic
 The replay module will just publish all messages that are found in the log. It also applies the parameters from
 the log.
 
+The log file is memory-mapped and indexed before replay starts. The index is cached next to the log file
+(`<log file>.index`), so that the next replay of the same log starts without scanning it.
+
 The replay procedure is documented on the [System-wide Replay](https://docs.px4.io/main/en/debug/system_wide_replay.html)
 page.
 )DESCR_STR");
@@ -33,7 +33,6 @@
 
 #pragma once
 
-#include <fstream>
 #include <map>
 #include <vector>
 #include <set>
@@ -41,6 +40,7 @@
 
 #include "definitions.hpp"
 
+#include <lib/ulog/ULogFile.hpp>
 #include <px4_platform_common/module.h>
 #include <uORB/topics/uORBTopics.hpp>
 #include <uORB/topics/ekf2_timestamps.h>
@@ -51,9 +51,9 @@ namespace px4
 /**
  * @class Replay
  * Parses an ULog file and replays it in 'real-time'. The timestamp of each replayed message is offset
- * to match the starting time of replay. It keeps a stream for each subscription to find the next message
- * to replay. This is necessary because data messages from different subscriptions don't need to be in
- * monotonic increasing order.
+ * to match the starting time of replay. The file is memory-mapped and indexed once, and each subscription
+ * keeps its position in the index to find the next message to replay. This is necessary because data
+ * messages from different subscriptions don't need to be in monotonic increasing order.
  */
 class Replay : public ModuleBase<Replay>
 {
@@ -134,7 +134,8 @@ protected:
 
 		bool ignored = false; ///< if true, it will not be considered for publication in the main loop
 
-		std::streampos next_read_pos;
+		size_t next_read_pos; ///< file offset of the next data message
+		size_t next_index = 0; ///< index of the next data message in ULogFile::dataMessages()
 		uint64_t next_timestamp; ///< timestamp of the file
 
 		CompatBase *compat = nullptr;
@@ -189,22 +190,20 @@ protected:
 	 * handle the publication of a topic update
 	 * @return true if published, false otherwise
 	 */
-	virtual bool handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file);
+	virtual bool handleTopicUpdate(Subscription &sub, void *data);
 
 	/**
 	 * read a topic from the file (offset given by the subscription) into _read_buffer
 	 */
-	void readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file);
+	void readTopicDataToBuffer(const Subscription &sub);
 
 	/**
-	 * Find next data message for this subscription, starting with the stored file offset.
-	 * Skip the first message, and if found, read the timestamp and store the new file offset.
-	 * This also takes care of new subscriptions and parameter updates. When reaching EOF,
-	 * the subscription is set to invalid.
-	 * File seek position is arbitrary after this call.
-	 * @return false on file error
+	 * Find next data message for this subscription: skip the current message, and if found, read the
+	 * timestamp and store the new file offset. When reaching the end of the data, the subscription
+	 * is set to invalid.
+	 * @return false if there are no more messages
 	 */
-	bool nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id);
+	bool nextDataMessage(Subscription &subscription, int msg_id);
 
 	virtual uint64_t getTimestampOffset()
 	{
@@ -224,45 +223,56 @@ private:
 
 	uint64_t _file_start_time;
 	uint64_t _replay_start_time;
-	std::streampos _data_section_start; ///< first ADD_LOGGED_MSG message
+	size_t _data_section_start; ///< first ADD_LOGGED_MSG message
 
-	/** keep track of file position to avoid adding a subscription multiple times. */
-	std::streampos _subscription_file_pos = 0;
+	uint64_t _read_until_file_position = UINT64_MAX; ///< read limit if log contains appended data
 
-	int64_t _read_until_file_position = 1ULL << 60; ///< read limit if log contains appended data
+	ULogFile _file;
+	size_t _next_additional_message{0}; ///< index of the next message in ULogFile::otherMessages() to handle
 
 	float _accumulated_delay{0.f};
 
-	bool readFileHeader(std::ifstream &file);
+	bool readFileHeader();
 
 	/**
 	 * Read definitions section: check formats, apply parameters and store
 	 * the start of the data section.
 	 * @return true on success
 	 */
-	bool readFileDefinitions(std::ifstream &file);
+	bool readFileDefinitions();
 
 	///file parsing methods. They return false, when further parsing should be aborted.
-	bool readFormat(std::ifstream &file, uint16_t msg_size);
-	bool readAndAddSubscription(std::ifstream &file, uint16_t msg_size);
-	bool readFlagBits(std::ifstream &file, uint16_t msg_size);
+	bool readFormat(const uint8_t *message, uint16_t msg_size);
+	bool readAndAddSubscription(const uint8_t *message, uint16_t msg_size);
+	bool readFlagBits(const uint8_t *message, uint16_t msg_size);
 
 	/**
 	 * Read the file header and definitions sections. Apply the parameters from this section
 	 * and apply user-defined overridden parameters.
 	 * @return true on success
 	 */
-	bool readDefinitionsAndApplyParams(std::ifstream &file);
+	bool readDefinitionsAndApplyParams();
 
 	/**
-	 * Read and handle additional messages starting at current file position, while position < end_position.
+	 * Add the subscriptions for all ADD_LOGGED_MSG messages of the data section
+	 */
+	void addSubscriptions();
+
+	/**
+	 * Starting at the subscription's next_index, find the first data message with the expected size,
+	 * and read its timestamp. The subscription is set to invalid if there is none.
+	 * @return false if there are no more messages
+	 */
+	bool findDataMessage(Subscription &subscription, int msg_id);
+
+	/**
+	 * Handle the additional messages from the last handled one up to (excluding) end_position.
 	 * This handles dropout and parameter update messages.
 	 * We need to handle these separately, because they have no timestamp. We look at the file position instead.
-	 * @return false on file error
 	 */
-	bool readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position);
-	bool readDropout(std::ifstream &file, uint16_t msg_size);
-	bool readAndApplyParameter(std::ifstream &file, uint16_t msg_size);
+	void readAndHandleAdditionalMessages(size_t end_position);
+	bool readDropout(const uint8_t *message, uint16_t msg_size);
+	bool readAndApplyParameter(const uint8_t *message, uint16_t msg_size);
 
 	static const orb_metadata *findTopic(const std::string &name);
 
@@ -75,6 +75,33 @@ public:
 		}
 	}
 
+	/**
+	 * Put a batch of equally spaced raw FIFO samples into the integral.
+	 * The batch counts as a single sample for the reset criteria.
+	 *
+	 * @param x		Raw X-axis samples.
+	 * @param y		Raw Y-axis samples.
+	 * @param z		Raw Z-axis samples.
+	 * @param samples	Number of samples in the batch.
+	 * @param scale		Scale factor from raw sample to physical units.
+	 * @param dt		Interval between two samples in seconds.
+	 */
+	inline void put(const int16_t x[], const int16_t y[], const int16_t z[], const int samples, const float scale,
+			const float dt)
+	{
+		if (samples <= 0) {
+			return;
+		}
+
+		if ((dt > DT_MIN) && (_integral_dt + dt * samples < DT_MAX)) {
+			_alpha += integrate(x, y, z, samples, scale, dt);
+
+		} else {
+			reset();
+			_last_val = matrix::Vector3f{(float)x[samples - 1], (float)y[samples - 1], (float)z[samples - 1]} * scale;
+		}
+	}
+
 	/**
 	 * Set reset interval during runtime. This won't reset the integrator.
 	 *
@@ -138,6 +165,34 @@ protected:
 		return delta_alpha;
 	}
 
+	inline matrix::Vector3f integrate(const int16_t x[], const int16_t y[], const int16_t z[], const int samples,
+					  const float scale, const float dt)
+	{
+		// Trapezoidal integration of equally spaced samples: the inner samples carry full weight
+		// and are summed in integer precision, only the first and last edge are halved.
+		_integrated_samples++;
+		_integral_dt += dt * samples;
+
+		const int last = samples - 1;
+		const matrix::Vector3f sum{(float)sum_raw(x, last), (float)sum_raw(y, last), (float)sum_raw(z, last)};
+		const matrix::Vector3f val{matrix::Vector3f{(float)x[last], (float)y[last], (float)z[last]} * scale};
+		const matrix::Vector3f delta_alpha{((val + _last_val) * 0.5f + sum * scale) * dt};
+		_last_val = val;
+
+		return delta_alpha;
+	}
+
+	static inline int32_t sum_raw(const int16_t raw[], const int length)
+	{
+		int32_t sum = 0;
+
+		for (int n = 0; n < length; n++) {
+			sum += raw[n];
+		}
+
+		return sum;
+	}
+
 	matrix::Vector3f _alpha{0.f, 0.f, 0.f};    /**< integrated value before coning corrections are applied */
 	matrix::Vector3f _last_val{0.f, 0.f, 0.f}; /**< previous input */
 	float _integral_dt{0};
@@ -186,6 +241,87 @@ public:
 		}
 	}
 
+	/**
+	 * Put a batch of equally spaced raw FIFO samples into the integral, including the
+	 * coning corrections between the individual samples.
+	 * The batch counts as a single sample for the reset criteria.
+	 *
+	 * @param x		Raw X-axis samples.
+	 * @param y		Raw Y-axis samples.
+	 * @param z		Raw Z-axis samples.
+	 * @param samples	Number of samples in the batch.
+	 * @param scale		Scale factor from raw sample to physical units.
+	 * @param dt		Interval between two samples in seconds.
+	 */
+	inline void put(const int16_t x[], const int16_t y[], const int16_t z[], const int samples, const float scale,
+			const float dt)
+	{
+		if (samples <= 0) {
+			return;
+		}
+
+		if ((dt > DT_MIN) && (_integral_dt + dt * samples < DT_MAX)) {
+			_integrated_samples++;
+			_integral_dt += dt * samples;
+
+			// same recursion as the single sample put(), but with the state held in locals
+			// so the loop doesn't load and store the members for every sample
+			float val_x = _last_val(0), val_y = _last_val(1), val_z = _last_val(2);
+			float alpha_x = _alpha(0), alpha_y = _alpha(1), alpha_z = _alpha(2);
+			float beta_x = 0.f, beta_y = 0.f, beta_z = 0.f;
+			float last_alpha_x = _last_alpha(0), last_alpha_y = _last_alpha(1), last_alpha_z = _last_alpha(2);
+			float last_delta_x = _last_delta_alpha(0);
+			float last_delta_y = _last_delta_alpha(1);
+			float last_delta_z = _last_delta_alpha(2);
+
+			const float half_dt = 0.5f * dt;
+
+			for (int n = 0; n < samples; n++) {
+				const float x_n = x[n] * scale;
+				const float y_n = y[n] * scale;
+				const float z_n = z[n] * scale;
+
+				const float delta_x = (x_n + val_x) * half_dt;
+				const float delta_y = (y_n + val_y) * half_dt;
+				const float delta_z = (z_n + val_z) * half_dt;
+
+				const float a_x = last_alpha_x + last_delta_x * (1.f / 6.f);
+				const float a_y = last_alpha_y + last_delta_y * (1.f / 6.f);
+				const float a_z = last_alpha_z + last_delta_z * (1.f / 6.f);
+
+				beta_x += a_y * delta_z - a_z * delta_y;
+				beta_y += a_z * delta_x - a_x * delta_z;
+				beta_z += a_x * delta_y - a_y * delta_x;
+
+				last_delta_x = delta_x;
+				last_delta_y = delta_y;
+				last_delta_z = delta_z;
+
+				last_alpha_x = alpha_x;
+				last_alpha_y = alpha_y;
+				last_alpha_z = alpha_z;
+
+				alpha_x += delta_x;
+				alpha_y += delta_y;
+				alpha_z += delta_z;
+
+				val_x = x_n;
+				val_y = y_n;
+				val_z = z_n;
+			}
+
+			_last_val = matrix::Vector3f{val_x, val_y, val_z};
+			_alpha = matrix::Vector3f{alpha_x, alpha_y, alpha_z};
+			_beta += matrix::Vector3f{beta_x, beta_y, beta_z} * 0.5f;
+			_last_alpha = matrix::Vector3f{last_alpha_x, last_alpha_y, last_alpha_z};
+			_last_delta_alpha = matrix::Vector3f{last_delta_x, last_delta_y, last_delta_z};
+
+		} else {
+			reset();
+			_last_val = matrix::Vector3f{(float)x[samples - 1], (float)y[samples - 1], (float)z[samples - 1]} * scale;
+		}
+	}
+
 	void reset()
 	{
 		Integrator::reset();
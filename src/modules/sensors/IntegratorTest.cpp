@@ -0,0 +1,166 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <Integrator.hpp>
+
+using namespace sensors;
+using matrix::Vector3f;
+
+namespace
+{
+
+static constexpr int FIFO_SAMPLES = 32;
+static constexpr float SCALE = 0.001f;
+static constexpr float DT = 1.f / 8000.f;
+
+// rotation about all three axes with a slowly varying rate, so the coning corrections are non-zero
+void generateFifo(int batch, int16_t x[], int16_t y[], int16_t z[], int samples)
+{
+	for (int n = 0; n < samples; n++) {
+		const float t = (batch * samples + n) * DT;
+		x[n] = static_cast<int16_t>(3000.f * sinf(2.f * M_PI_F * 17.f * t));
+		y[n] = static_cast<int16_t>(3000.f * cosf(2.f * M_PI_F * 17.f * t));
+		z[n] = static_cast<int16_t>(500.f + 200.f * sinf(2.f * M_PI_F * 3.f * t));
+	}
+}
+
+} // namespace
+
+TEST(IntegratorTest, FifoBatchMatchesSingleSamples)
+{
+	Integrator single;
+	Integrator batch;
+
+	for (int i = 0; i < 10; i++) {
+		int16_t x[FIFO_SAMPLES], y[FIFO_SAMPLES], z[FIFO_SAMPLES];
+		generateFifo(i, x, y, z, FIFO_SAMPLES);
+
+		for (int n = 0; n < FIFO_SAMPLES; n++) {
+			single.put(Vector3f{(float)x[n], (float)y[n], (float)z[n]} * SCALE, DT);
+		}
+
+		batch.put(x, y, z, FIFO_SAMPLES, SCALE, DT);
+	}
+
+	EXPECT_NEAR(single.integral_dt(), batch.integral_dt(), 1e-6f);
+
+	Vector3f integral_single;
+	Vector3f integral_batch;
+	uint16_t dt_single = 0;
+	uint16_t dt_batch = 0;
+	EXPECT_TRUE(single.reset(integral_single, dt_single));
+	EXPECT_TRUE(batch.reset(integral_batch, dt_batch));
+
+	EXPECT_EQ(dt_single, dt_batch);
+	EXPECT_TRUE(integral_batch.longerThan(0.f));
+
+	for (int axis = 0; axis < 3; axis++) {
+		EXPECT_NEAR(integral_single(axis), integral_batch(axis), 1e-6f);
+	}
+}
+
+TEST(IntegratorTest, ConingFifoBatchMatchesSingleSamples)
+{
+	IntegratorConing single;
+	IntegratorConing batch;
+
+	for (int i = 0; i < 10; i++) {
+		int16_t x[FIFO_SAMPLES], y[FIFO_SAMPLES], z[FIFO_SAMPLES];
+		generateFifo(i, x, y, z, FIFO_SAMPLES);
+
+		for (int n = 0; n < FIFO_SAMPLES; n++) {
+			single.put(Vector3f{(float)x[n], (float)y[n], (float)z[n]} * SCALE, DT);
+		}
+
+		batch.put(x, y, z, FIFO_SAMPLES, SCALE, DT);
+	}
+
+	const Vector3f coning_single = single.accumulated_coning_corrections();
+	const Vector3f coning_batch = batch.accumulated_coning_corrections();
+	EXPECT_TRUE(coning_batch.longerThan(0.f));
+
+	for (int axis = 0; axis < 3; axis++) {
+		EXPECT_NEAR(coning_single(axis), coning_batch(axis), 1e-9f);
+	}
+
+	Vector3f integral_single;
+	Vector3f integral_batch;
+	uint16_t dt_single = 0;
+	uint16_t dt_batch = 0;
+	EXPECT_TRUE(single.reset(integral_single, dt_single));
+	EXPECT_TRUE(batch.reset(integral_batch, dt_batch));
+
+	EXPECT_EQ(dt_single, dt_batch);
+
+	for (int axis = 0; axis < 3; axis++) {
+		EXPECT_NEAR(integral_single(axis), integral_batch(axis), 1e-6f);
+	}
+}
+
+TEST(IntegratorTest, FifoBatchCountsAsSingleSample)
+{
+	IntegratorConing integrator;
+	integrator.set_reset_interval(1000000);
+	integrator.set_reset_samples(2);
+
+	int16_t x[FIFO_SAMPLES], y[FIFO_SAMPLES], z[FIFO_SAMPLES];
+	generateFifo(0, x, y, z, FIFO_SAMPLES);
+
+	integrator.put(x, y, z, FIFO_SAMPLES, SCALE, DT);
+	EXPECT_FALSE(integrator.integral_ready());
+
+	integrator.put(x, y, z, FIFO_SAMPLES, SCALE, DT);
+	EXPECT_TRUE(integrator.integral_ready());
+	EXPECT_NEAR(integrator.integral_dt(), 2 * FIFO_SAMPLES * DT, 1e-6f);
+}
+
+TEST(IntegratorTest, FifoBatchInvalidIntervalResets)
+{
+	IntegratorConing integrator;
+
+	int16_t x[FIFO_SAMPLES], y[FIFO_SAMPLES], z[FIFO_SAMPLES];
+	generateFifo(0, x, y, z, FIFO_SAMPLES);
+
+	integrator.put(x, y, z, FIFO_SAMPLES, SCALE, DT);
+	EXPECT_TRUE(integrator.integral_ready());
+
+	// an invalid interval drops everything integrated so far
+	integrator.put(x, y, z, FIFO_SAMPLES, SCALE, 0.f);
+	EXPECT_FALSE(integrator.integral_ready());
+	EXPECT_FLOAT_EQ(integrator.integral_dt(), 0.f);
+
+	// an empty batch is ignored
+	integrator.put(x, y, z, 0, SCALE, DT);
+	EXPECT_FLOAT_EQ(integrator.integral_dt(), 0.f);
+}
@@ -56,6 +56,7 @@ VehicleAngularVelocity::~VehicleAngularVelocity()
 	perf_free(_cycle_perf);
 	perf_free(_filter_reset_perf);
 	perf_free(_selection_changed_perf);
+	perf_free(_fifo_borrow_overrun_perf);
 
 #if !defined(CONSTRAINED_FLASH)
 	delete[] _dynamic_notch_filter_esc_rpm;
@@ -196,6 +197,10 @@ void VehicleAngularVelocity::ResetFilters(const hrt_abstime &time_now_us)
 		UpdateDynamicNotchEscRpm(time_now_us, true);
 		UpdateDynamicNotchFFT(time_now_us, true);
 
+#if !defined(CONSTRAINED_FLASH)
+		_notch_filter_bank_update = true;
+#endif // !CONSTRAINED_FLASH
+
 		_angular_velocity_raw_prev = angular_velocity_uncalibrated;
 
 		_reset_filters = false;
@@ -495,6 +500,37 @@ void VehicleAngularVelocity::ParametersUpdate(bool force)
 			DisableDynamicNotchFFT();
 		}
 
+		// notch filter bank: ESC RPM sections (by ESC, then harmonic), FFT peaks, notch 0 and 1
+		const int notch_filter_bank_sections = _param_imu_gyro_nf_bank.get() ?
+						       (_dynamic_notch_filter_esc_rpm ? MAX_NUM_ESCS * _esc_rpm_harmonics : 0) + MAX_NUM_FFT_PEAKS + 2 : 0;
+
+		if (notch_filter_bank_sections != _notch_filter_bank.numSections()) {
+			if (!_notch_filter_bank.allocate(notch_filter_bank_sections) && (notch_filter_bank_sections > 0)) {
+				PX4_ERR("notch filter bank allocation failed");
+			}
+
+			// the filter state moves between the bank and the individual filters, restart all of them
+			if (_dynamic_notch_filter_esc_rpm) {
+				for (int harmonic = 0; harmonic < _esc_rpm_harmonics; harmonic++) {
+					for (int axis = 0; axis < 3; axis++) {
+						for (int esc = 0; esc < MAX_NUM_ESCS; esc++) {
+							_dynamic_notch_filter_esc_rpm[harmonic][axis][esc].reset();
+						}
+					}
+				}
+			}
+
+			for (int axis = 0; axis < 3; axis++) {
+				for (int peak = 0; peak < MAX_NUM_FFT_PEAKS; peak++) {
+					_dynamic_notch_filter_fft[axis][peak].reset();
+				}
+			}
+
+			_reset_filters = true;
+		}
+
+		_notch_filter_bank_update = true;
+
 #endif // !CONSTRAINED_FLASH
 	}
 }
@@ -573,6 +609,8 @@ void VehicleAngularVelocity::UpdateDynamicNotchEscRpm(const hrt_abstime &time_no
 
 	if (enabled && (_esc_status_sub.updated() || force)) {
 
+		_notch_filter_bank_update = true;
+
 		bool axis_init[3] {false, false, false};
 
 		esc_status_s esc_status;
@@ -670,6 +708,8 @@ void VehicleAngularVelocity::UpdateDynamicNotchFFT(const hrt_abstime &time_now_u
 
 	if (enabled && (_sensor_gyro_fft_sub.updated() || force)) {
 
+		_notch_filter_bank_update = true;
+
 		if (!_dynamic_notch_fft_available) {
 			// force update filters if previously disabled
 			force = true;
@@ -722,10 +762,76 @@ void VehicleAngularVelocity::UpdateDynamicNotchFFT(const hrt_abstime &time_now_u
 #endif // !CONSTRAINED_FLASH
 }
 
+void VehicleAngularVelocity::UpdateNotchFilterBank()
+{
+#if !defined(CONSTRAINED_FLASH)
+
+	if (!_notch_filter_bank_update || (_notch_filter_bank.numSections() == 0)) {
+		return;
+	}
+
+	// copy the coefficients of the active notch filters (in the order FilterAngularVelocity() applies them)
+	auto update_section = [this](int section, int axis, math::NotchFilter<float> &nf, bool available) {
+		if (available && (nf.getNotchFreq() > 0.f)) {
+			float a[3];
+			float b[3];
+			nf.getCoefficients(a, b);
+			_notch_filter_bank.setCoefficients(section, axis, a, b);
+
+			if (!nf.initialized()) {
+				// the bank holds the filter state: reset it with the next sample
+				// and mark the filter as initialized, like NotchFilter::apply() does
+				_notch_filter_bank.reset(section, axis);
+				nf.reset(0.f);
+			}
+
+		} else {
+			_notch_filter_bank.disable(section, axis);
+		}
+	};
+
+	int section = 0;
+
+	if (_dynamic_notch_filter_esc_rpm) {
+		for (int esc = 0; esc < MAX_NUM_ESCS; esc++) {
+			for (int harmonic = 0; harmonic < _esc_rpm_harmonics; harmonic++) {
+				for (int axis = 0; axis < 3; axis++) {
+					update_section(section, axis, _dynamic_notch_filter_esc_rpm[harmonic][axis][esc], _esc_available[esc]);
+				}
+
+				section++;
+			}
+		}
+	}
+
+	for (int peak = MAX_NUM_FFT_PEAKS - 1; peak >= 0; peak--) {
+		for (int axis = 0; axis < 3; axis++) {
+			update_section(section, axis, _dynamic_notch_filter_fft[axis][peak], _dynamic_notch_fft_available);
+		}
+
+		section++;
+	}
+
+	for (int axis = 0; axis < 3; axis++) {
+		update_section(section, axis, _notch_filter0_velocity[axis], true);
+		update_section(section + 1, axis, _notch_filter1_velocity[axis], true);
+	}
+
+	_notch_filter_bank_update = false;
+
+#endif // !CONSTRAINED_FLASH
+}
+
 float VehicleAngularVelocity::FilterAngularVelocity(int axis, float data[], int N)
 {
 #if !defined(CONSTRAINED_FLASH)
 
+	if (_notch_filter_bank.numSections() > 0) {
+		// notch filters already applied to all axes by the bank, only apply the low-pass filter (IMU_GYRO_CUTOFF)
+		_lp_filter_velocity[axis].applyArray(data, N);
+		return data[N - 1];
+	}
+
 	// Apply dynamic notch filter from ESC RPM
 	if (_dynamic_notch_filter_esc_rpm) {
 		for (int esc = 0; esc < MAX_NUM_ESCS; esc++) {
@@ -818,38 +924,60 @@ void VehicleAngularVelocity::Run()
 
 	UpdateDynamicNotchEscRpm(time_now_us);
 	UpdateDynamicNotchFFT(time_now_us);
+	UpdateNotchFilterBank();
 
 	if (_fifo_available) {
-		// process all outstanding fifo messages
-		sensor_gyro_fifo_s sensor_fifo_data;
+		// process all outstanding fifo messages, borrowed in place if possible (no copy of the whole message)
+		sensor_gyro_fifo_s sensor_fifo_copy;
+		const sensor_gyro_fifo_s *sensor_fifo_data;
 
-		while (_sensor_gyro_fifo_sub.update(&sensor_fifo_data)) {
-			const float inverse_dt_s = 1e6f / sensor_fifo_data.dt;
-			const int N = sensor_fifo_data.samples;
-			static constexpr int FIFO_SIZE_MAX = sizeof(sensor_fifo_data.x) / sizeof(sensor_fifo_data.x[0]);
+		while ((sensor_fifo_data = static_cast<const sensor_gyro_fifo_s *>(_sensor_gyro_fifo_sub.borrow()))
+		       || (_sensor_gyro_fifo_sub.update(&sensor_fifo_copy) && (sensor_fifo_data = &sensor_fifo_copy))) {
 
-			if ((sensor_fifo_data.dt > 0) && (N > 0) && (N <= FIFO_SIZE_MAX)) {
-				Vector3f angular_velocity_uncalibrated;
-				Vector3f angular_acceleration_uncalibrated;
+			const hrt_abstime timestamp_sample = sensor_fifo_data->timestamp_sample;
+			const float dt = sensor_fifo_data->dt;
+			const int N = sensor_fifo_data->samples;
+			static constexpr int FIFO_SIZE_MAX = sizeof(sensor_fifo_data->x) / sizeof(sensor_fifo_data->x[0]);
 
-				int16_t *raw_data_array[] {sensor_fifo_data.x, sensor_fifo_data.y, sensor_fifo_data.z};
+			if ((dt > 0) && (N > 0) && (N <= FIFO_SIZE_MAX)) {
+				const float inverse_dt_s = 1e6f / dt;
 
-				for (int axis = 0; axis < 3; axis++) {
-					// copy raw int16 sensor samples to float array for filtering
-					float data[FIFO_SIZE_MAX];
+				// copy raw int16 sensor samples to float array for filtering
+				float data[3][FIFO_SIZE_MAX];
+				const int16_t *raw_data_array[] {sensor_fifo_data->x, sensor_fifo_data->y, sensor_fifo_data->z};
 
+				for (int axis = 0; axis < 3; axis++) {
 					for (int n = 0; n < N; n++) {
-						data[n] = sensor_fifo_data.scale * raw_data_array[axis][n];
+						data[axis][n] = sensor_fifo_data->scale * raw_data_array[axis][n];
 					}
+				}
+
+				if ((sensor_fifo_data != &sensor_fifo_copy) && !_sensor_gyro_fifo_sub.borrow_valid()) {
+					// overwritten by the publisher while reading, skip
+					perf_count(_fifo_borrow_overrun_perf);
+					continue;
+				}
+
+#if !defined(CONSTRAINED_FLASH)
 
+				if (_notch_filter_bank.numSections() > 0) {
+					_notch_filter_bank.applyArray(data[0], data[1], data[2], N);
+				}
+
+#endif // !CONSTRAINED_FLASH
+
+				Vector3f angular_velocity_uncalibrated;
+				Vector3f angular_acceleration_uncalibrated;
+
+				for (int axis = 0; axis < 3; axis++) {
 					// save last filtered sample
-					angular_velocity_uncalibrated(axis) = FilterAngularVelocity(axis, data, N);
-					angular_acceleration_uncalibrated(axis) = FilterAngularAcceleration(axis, inverse_dt_s, data, N);
+					angular_velocity_uncalibrated(axis) = FilterAngularVelocity(axis, data[axis], N);
+					angular_acceleration_uncalibrated(axis) = FilterAngularAcceleration(axis, inverse_dt_s, data[axis], N);
 				}
 
 				// Publish
 				if (!_sensor_gyro_fifo_sub.updated()) {
-					if (CalibrateAndPublish(sensor_fifo_data.timestamp_sample,
+					if (CalibrateAndPublish(timestamp_sample,
 								angular_velocity_uncalibrated,
 								angular_acceleration_uncalibrated)) {
 
@@ -878,15 +1006,21 @@ void VehicleAngularVelocity::Run()
 				Vector3f angular_velocity_uncalibrated;
 				Vector3f angular_acceleration_uncalibrated;
 
-				float raw_data_array[] {sensor_data.x, sensor_data.y, sensor_data.z};
+				// copy sensor sample to float array for filtering
+				float data[3][1] {{sensor_data.x}, {sensor_data.y}, {sensor_data.z}};
 
-				for (int axis = 0; axis < 3; axis++) {
-					// copy sensor sample to float array for filtering
-					float data[1] {raw_data_array[axis]};
+#if !defined(CONSTRAINED_FLASH)
 
+				if (_notch_filter_bank.numSections() > 0) {
+					_notch_filter_bank.applyArray(data[0], data[1], data[2], 1);
+				}
+
+#endif // !CONSTRAINED_FLASH
+
+				for (int axis = 0; axis < 3; axis++) {
 					// save last filtered sample
-					angular_velocity_uncalibrated(axis) = FilterAngularVelocity(axis, data);
-					angular_acceleration_uncalibrated(axis) = FilterAngularAcceleration(axis, inverse_dt_s, data);
+					angular_velocity_uncalibrated(axis) = FilterAngularVelocity(axis, data[axis]);
+					angular_acceleration_uncalibrated(axis) = FilterAngularAcceleration(axis, inverse_dt_s, data[axis]);
 				}
 
 				// Publish
@@ -949,11 +1083,20 @@ void VehicleAngularVelocity::PrintStatus()
 		     _calibration.device_id(), (double)_filter_sample_rate_hz, _fifo_available ? "FIFO" : "",
 		     (double)_bias(0), (double)_bias(1), (double)_bias(2));
 
+#if !defined(CONSTRAINED_FLASH)
+
+	if (_notch_filter_bank.numSections() > 0) {
+		PX4_INFO_RAW("[vehicle_angular_velocity] notch filter bank: %d sections\n", _notch_filter_bank.numSections());
+	}
+
+#endif // !CONSTRAINED_FLASH
+
 	_calibration.PrintStatus();
 
 	perf_print_counter(_cycle_perf);
 	perf_print_counter(_filter_reset_perf);
 	perf_print_counter(_selection_changed_perf);
+	perf_print_counter(_fifo_borrow_overrun_perf);
 #if !defined(CONSTRAINED_FLASH)
 	perf_print_counter(_dynamic_notch_filter_esc_rpm_disable_perf);
 	perf_print_counter(_dynamic_notch_filter_esc_rpm_init_perf);
@@ -38,6 +38,7 @@
 #include <lib/mathlib/math/Limits.hpp>
 #include <lib/matrix/matrix/math.hpp>
 #include <lib/mathlib/math/filter/AlphaFilter.hpp>
+#include <lib/mathlib/math/filter/BiquadFilterBank.hpp>
 #include <lib/mathlib/math/filter/LowPassFilter2p.hpp>
 #include <lib/mathlib/math/filter/NotchFilter.hpp>
 #include <px4_platform_common/log.h>
@@ -90,6 +91,7 @@ private:
 	bool SensorSelectionUpdate(const hrt_abstime &time_now_us, bool force = false);
 	void UpdateDynamicNotchEscRpm(const hrt_abstime &time_now_us, bool force = false);
 	void UpdateDynamicNotchFFT(const hrt_abstime &time_now_us, bool force = false);
+	void UpdateNotchFilterBank();
 	bool UpdateSampleRate();
 
 	// scaled appropriately for current sensor
@@ -166,6 +168,11 @@ private:
 	perf_counter_t _dynamic_notch_filter_fft_update_perf{nullptr};
 
 	bool _dynamic_notch_fft_available{false};
+
+	// all notch filters applied to the 3 axes at once (IMU_GYRO_NF_BANK), the individual
+	// filters above are then only used to compute the coefficients
+	math::BiquadFilterBank _notch_filter_bank{};
+	bool _notch_filter_bank_update{false};
 #endif // !CONSTRAINED_FLASH
 
 	// angular acceleration filter
@@ -180,6 +187,7 @@ private:
 	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": gyro filter")};
 	perf_counter_t _filter_reset_perf{perf_alloc(PC_COUNT, MODULE_NAME": gyro filter reset")};
 	perf_counter_t _selection_changed_perf{perf_alloc(PC_COUNT, MODULE_NAME": gyro selection changed")};
+	perf_counter_t _fifo_borrow_overrun_perf{perf_alloc(PC_COUNT, MODULE_NAME": gyro fifo borrow overrun")};
 
 	DEFINE_PARAMETERS(
 #if !defined(CONSTRAINED_FLASH)
@@ -187,6 +195,7 @@ private:
 		(ParamInt<px4::params::IMU_GYRO_DNF_HMC>) _param_imu_gyro_dnf_hmc,
 		(ParamFloat<px4::params::IMU_GYRO_DNF_BW>) _param_imu_gyro_dnf_bw,
 		(ParamFloat<px4::params::IMU_GYRO_DNF_MIN>) _param_imu_gyro_dnf_min,
+		(ParamBool<px4::params::IMU_GYRO_NF_BANK>) _param_imu_gyro_nf_bank,
 #endif // !CONSTRAINED_FLASH
 		(ParamFloat<px4::params::IMU_GYRO_CUTOFF>) _param_imu_gyro_cutoff,
 		(ParamFloat<px4::params::IMU_GYRO_NF0_FRQ>) _param_imu_gyro_nf0_frq,
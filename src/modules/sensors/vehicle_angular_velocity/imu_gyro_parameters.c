@@ -204,3 +204,16 @@ PARAM_DEFINE_INT32(IMU_GYRO_DNF_HMC, 3);
 * @unit Hz
 */
 PARAM_DEFINE_FLOAT(IMU_GYRO_DNF_MIN, 25.f);
+
+/**
+* IMU gyro notch filter bank
+*
+* Apply all gyro notch filters (IMU_GYRO_NF0_FRQ, IMU_GYRO_NF1_FRQ and the dynamic notch filters)
+* as one filter bank that processes the three axes together, using SIMD instructions (SSE, NEON) if available.
+* This reduces the filtering cost with many dynamic notch filters, e.g. ESC RPM notch filters on
+* vehicles with many motors. Boards without SIMD support (e.g. Cortex-M) do not benefit.
+*
+* @boolean
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_NF_BANK, 0);
@@ -471,7 +471,19 @@ bool VehicleIMU::UpdateGyro()
 
 		const Vector3f gyro_raw{gyro.x, gyro.y, gyro.z};
 		_raw_gyro_mean.update(gyro_raw);
-		_gyro_integrator.put(gyro_raw, dt);
+
+		// the driver might advertise sensor_gyro_fifo after the first sensor_gyro, retry once per second
+		if ((gyro.device_id != _gyro_fifo_device_id)
+		    || (!_gyro_fifo_available && (gyro.timestamp_sample > _gyro_fifo_select_timestamp + 1_s))) {
+
+			SelectGyroFifo(gyro.device_id);
+			_gyro_fifo_select_timestamp = gyro.timestamp_sample;
+		}
+
+		// prefer the full rate FIFO data (coning corrections between the individual samples)
+		if (!_gyro_fifo_available || !IntegrateGyroFifo(gyro, dt)) {
+			_gyro_integrator.put(gyro_raw, dt);
+		}
 
 		updated = true;
 
@@ -525,6 +537,46 @@ bool VehicleIMU::UpdateGyro()
 	return updated;
 }
 
+bool VehicleIMU::IntegrateGyroFifo(const sensor_gyro_s &gyro, float dt)
+{
+	// the driver publishes the FIFO batch right before the sensor_gyro sample computed from it
+	while ((_sensor_gyro_fifo.timestamp_sample < gyro.timestamp_sample)
+	       && _sensor_gyro_fifo_sub.update(&_sensor_gyro_fifo)) {}
+
+	if ((_sensor_gyro_fifo.timestamp_sample == gyro.timestamp_sample)
+	    && (_sensor_gyro_fifo.device_id == gyro.device_id)
+	    && (_sensor_gyro_fifo.samples == gyro.samples)
+	    && (_sensor_gyro_fifo.samples > 0)
+	   ) {
+		const int N = _sensor_gyro_fifo.samples;
+		_gyro_integrator.put(_sensor_gyro_fifo.x, _sensor_gyro_fifo.y, _sensor_gyro_fifo.z, N,
+				     _sensor_gyro_fifo.scale, dt / N);
+		return true;
+	}
+
+	return false;
+}
+
+void VehicleIMU::SelectGyroFifo(uint32_t device_id)
+{
+	_gyro_fifo_device_id = device_id;
+	_gyro_fifo_available = false;
+	_sensor_gyro_fifo = {};
+
+	for (uint8_t i = 0; i < MAX_SENSOR_COUNT; i++) {
+		uORB::SubscriptionData<sensor_gyro_fifo_s> sensor_gyro_fifo_sub{ORB_ID(sensor_gyro_fifo), i};
+
+		if (sensor_gyro_fifo_sub.advertised() && (sensor_gyro_fifo_sub.get().device_id == device_id)) {
+			if (_sensor_gyro_fifo_sub.ChangeInstance(i)) {
+				_gyro_fifo_available = true;
+				PX4_DEBUG("%d - gyro %" PRIu32 " using sensor_gyro_fifo:%" PRIu8, _instance, device_id, i);
+			}
+
+			break;
+		}
+	}
+}
+
 bool VehicleIMU::Publish()
 {
 	bool updated = false;
@@ -54,6 +54,7 @@
 #include <uORB/topics/parameter_update.h>
 #include <uORB/topics/sensor_accel.h>
 #include <uORB/topics/sensor_gyro.h>
+#include <uORB/topics/sensor_gyro_fifo.h>
 #include <uORB/topics/vehicle_control_mode.h>
 #include <uORB/topics/vehicle_imu.h>
 #include <uORB/topics/vehicle_imu_status.h>
@@ -84,6 +85,13 @@ private:
 	bool UpdateAccel();
 	bool UpdateGyro();
 
+	/**
+	 * Integrate the raw FIFO batch that the sensor_gyro sample was averaged from, if available.
+	 * @return true if the FIFO batch was integrated
+	 */
+	bool IntegrateGyroFifo(const sensor_gyro_s &gyro, float dt);
+	void SelectGyroFifo(uint32_t device_id);
+
 	void UpdateIntegratorConfiguration();
 
 	inline void UpdateAccelVibrationMetrics(const matrix::Vector3f &acceleration);
@@ -101,6 +109,8 @@ private:
 
 	static constexpr hrt_abstime kIMUStatusPublishingInterval{100_ms};
 
+	static constexpr int MAX_SENSOR_COUNT = 4;
+
 	uORB::SubscriptionInterval _parameter_update_sub{ORB_ID(parameter_update), 1_s};
 
 	// Used to check, save and use learned magnetometer biases
@@ -108,6 +118,7 @@ private:
 
 	uORB::Subscription _sensor_accel_sub;
 	uORB::SubscriptionCallbackWorkItem _sensor_gyro_sub;
+	uORB::Subscription _sensor_gyro_fifo_sub{ORB_ID(sensor_gyro_fifo)};
 
 	uORB::Subscription _vehicle_control_mode_sub{ORB_ID(vehicle_control_mode)};
 
@@ -117,6 +128,11 @@ private:
 	sensors::Integrator       _accel_integrator{};
 	sensors::IntegratorConing _gyro_integrator{};
 
+	sensor_gyro_fifo_s _sensor_gyro_fifo{}; // last FIFO batch read, may be ahead of the current sensor_gyro sample
+	uint32_t _gyro_fifo_device_id{0};       // gyro device id the sensor_gyro_fifo instance was selected for
+	bool _gyro_fifo_available{false};
+	hrt_abstime _gyro_fifo_select_timestamp{0}; // timestamp_sample of the last sensor_gyro_fifo instance selection
+
 	uint32_t _imu_integration_interval_us{5000};
 
 	hrt_abstime _accel_timestamp_sample_last{0};
@@ -43,6 +43,7 @@ __BEGIN_DECLS
 
 extern int test_microbench_atomic(int argc, char *argv[]);
 extern int test_microbench_hrt(int argc, char *argv[]);
+extern int test_microbench_integrator(int argc, char *argv[]);
 extern int test_microbench_math(int argc, char *argv[]);
 extern int test_microbench_matrix(int argc, char *argv[]);
 extern int test_microbench_uorb(int argc, char *argv[]);
@@ -65,6 +66,7 @@ const struct {
 
 	{"microbench_atomic",	test_microbench_atomic,	0},
 	{"microbench_hrt",	test_microbench_hrt,	0},
+	{"microbench_integrator",	test_microbench_integrator,	0},
 	{"microbench_math",	test_microbench_math,	0},
 	{"microbench_matrix",	test_microbench_matrix,	0},
 	{"microbench_uorb",	test_microbench_uorb,	0},
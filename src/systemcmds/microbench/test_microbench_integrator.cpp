@@ -0,0 +1,169 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2023 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file test_microbench_integrator.cpp
+ * Microbenchmarks for the sensors IMU integrators.
+ */
+
+#include <unit_test.h>
+
+#include <time.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <drivers/drv_hrt.h>
+#include <perf/perf_counter.h>
+#include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/micro_hal.h>
+
+#include <modules/sensors/Integrator.hpp>
+
+namespace MicroBenchIntegrator
+{
+
+#ifdef __PX4_NUTTX
+#include <nuttx/irq.h>
+static irqstate_t flags;
+#endif
+
+void lock()
+{
+#ifdef __PX4_NUTTX
+	flags = px4_enter_critical_section();
+#endif
+}
+
+void unlock()
+{
+#ifdef __PX4_NUTTX
+	px4_leave_critical_section(flags);
+#endif
+}
+
+#define PERF(name, op, count) do { \
+		px4_usleep(1000); \
+		reset(); \
+		perf_counter_t p = perf_alloc(PC_ELAPSED, name); \
+		for (int i = 0; i < count; i++) { \
+			px4_usleep(1); \
+			lock(); \
+			perf_begin(p); \
+			op; \
+			perf_end(p); \
+			unlock(); \
+			reset(); \
+		} \
+		perf_print_counter(p); \
+		perf_free(p); \
+	} while (0)
+
+static constexpr int FIFO_SAMPLES = 32;
+static constexpr float SCALE = 0.001f;
+static constexpr float DT = 1.f / 8000.f;
+
+class MicroBenchIntegrator : public UnitTest
+{
+public:
+	virtual bool run_tests();
+
+private:
+
+	bool time_integrator_fifo();
+	bool time_integrator_coning_fifo();
+
+	void reset();
+
+	// a full 8 kHz FIFO batch, integrated either sample by sample or as a block
+	template<typename T>
+	void put_single(T &integrator)
+	{
+		for (int n = 0; n < FIFO_SAMPLES; n++) {
+			integrator.put(matrix::Vector3f{(float)x[n], (float)y[n], (float)z[n]} * SCALE, DT);
+		}
+	}
+
+	template<typename T>
+	void put_batch(T &integrator)
+	{
+		integrator.put(x, y, z, FIFO_SAMPLES, SCALE, DT);
+	}
+
+	sensors::Integrator integrator;
+	sensors::IntegratorConing integrator_coning;
+
+	int16_t x[FIFO_SAMPLES];
+	int16_t y[FIFO_SAMPLES];
+	int16_t z[FIFO_SAMPLES];
+};
+
+bool MicroBenchIntegrator::run_tests()
+{
+	ut_run_test(time_integrator_fifo);
+	ut_run_test(time_integrator_coning_fifo);
+
+	return (_tests_failed == 0);
+}
+
+void MicroBenchIntegrator::reset()
+{
+	srand(time(nullptr));
+
+	// initialize with random data
+	for (int n = 0; n < FIFO_SAMPLES; n++) {
+		x[n] = rand() % 8000 - 4000;
+		y[n] = rand() % 8000 - 4000;
+		z[n] = rand() % 8000 - 4000;
+	}
+
+	integrator.reset();
+	integrator_coning.reset();
+}
+
+bool MicroBenchIntegrator::time_integrator_fifo()
+{
+	PERF("Integrator 32 FIFO samples (single put)", put_single(integrator), 100);
+	PERF("Integrator 32 FIFO samples (batch put)", put_batch(integrator), 100);
+	return true;
+}
+
+bool MicroBenchIntegrator::time_integrator_coning_fifo()
+{
+	PERF("IntegratorConing 32 FIFO samples (single put)", put_single(integrator_coning), 100);
+	PERF("IntegratorConing 32 FIFO samples (batch put)", put_batch(integrator_coning), 100);
+	return true;
+}
+
+ut_declare_test_c(test_microbench_integrator, MicroBenchIntegrator)
+
+} // namespace MicroBenchIntegrator
@@ -99,6 +99,7 @@ private:
 	bool time_matrix_quaternion();
 	bool time_matrix_dcm();
 	bool time_matrix_pseduo_inverse();
+	bool time_matrix_covariance_update();
 
 	void reset();
 
@@ -108,6 +109,10 @@ private:
 	matrix::Matrix<float, 16, 6> A16;
 	matrix::Matrix<float, 6, 16> B16;
 	matrix::Matrix<float, 6, 16> B16_4;
+	matrix::SquareMatrix<float, 24> P24;
+	matrix::Vector<float, 24> K24;
+	matrix::Vector<float, 24> K24_16;
+	matrix::Vector<float, 24> HP24;
 };
 
 bool MicroBenchMatrix::run_tests()
@@ -116,6 +121,7 @@ bool MicroBenchMatrix::run_tests()
 	ut_run_test(time_matrix_quaternion);
 	ut_run_test(time_matrix_dcm);
 	ut_run_test(time_matrix_pseduo_inverse);
+	ut_run_test(time_matrix_covariance_update);
 
 	return (_tests_failed == 0);
 }
@@ -145,6 +151,33 @@ void MicroBenchMatrix::reset()
 			B16_4(j, i) = random(-10.0, 10.0);
 		}
 	}
+
+	for (size_t j = 0; j < 24; j++) {
+		for (size_t i = 0; i < 24; i++) {
+			P24(j, i) = random(-10.0, 10.0);
+		}
+
+		K24(j) = random(-10.0, 10.0);
+		HP24(j) = random(-10.0, 10.0);
+
+		// e.g. the magnetic field and wind states of the EKF when not estimated
+		K24_16(j) = (j < 16) ? K24(j) : 0.f;
+	}
+}
+
+// scalar measurement covariance update P -= K * HP, building the full 24x24 correction matrix
+static void covariance_update_dense(matrix::SquareMatrix<float, 24> &P, const matrix::Vector<float, 24> &K,
+				    const matrix::Vector<float, 24> &HP)
+{
+	matrix::SquareMatrix<float, 24> KHP;
+
+	for (size_t row = 0; row < 24; row++) {
+		for (size_t col = 0; col < 24; col++) {
+			KHP(row, col) = K(row) * HP(col);
+		}
+	}
+
+	P -= KHP;
 }
 
 bool MicroBenchMatrix::time_matrix_euler()
@@ -175,6 +208,14 @@ bool MicroBenchMatrix::time_matrix_pseduo_inverse()
 	return true;
 }
 
+bool MicroBenchMatrix::time_matrix_covariance_update()
+{
+	PERF("matrix 24x24 covariance update (dense KHP)", covariance_update_dense(P24, K24, HP24), 100);
+	PERF("matrix 24x24 covariance update (in place)", P24.subtractOuterProduct(K24, HP24), 100);
+	PERF("matrix 24x24 covariance update (in place, 16 non-zero gains)", P24.subtractOuterProduct(K24_16, HP24), 100);
+	return true;
+}
+
 ut_declare_test_c(test_microbench_matrix, MicroBenchMatrix)
 
 } // namespace MicroBenchMatrix
@@ -45,7 +45,7 @@ extern "C" {
 int
 work_queue_main(int argc, char *argv[])
 {
-	if (argc != 2) {
+	if (argc < 2) {
 		usage();
 		return 1;
 	}
@@ -59,7 +59,8 @@ work_queue_main(int argc, char *argv[])
 		return 0;
 
 	} else if (!strcmp(argv[1], "status")) {
-		px4::WorkQueueManagerStatus();
+		const bool run_stats = (argc > 2) && !strcmp(argv[2], "-h");
+		px4::WorkQueueManagerStatus(run_stats);
 		return 0;
 	}
 
@@ -78,9 +79,14 @@ usage()
 
 Command-line tool to show work queue status.
 
+With CONFIG_WORK_QUEUE_RUN_STATS enabled, `status -h` additionally shows the schedule latency and run time
+percentiles (upper bound of the log2 histogram bucket) and the deadline misses of every work item.
+
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("work_queue", "system");
 	PRINT_MODULE_USAGE_COMMAND("start");
-	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
+	PRINT_MODULE_USAGE_COMMAND_DESCR("status", "print status info");
+	PRINT_MODULE_USAGE_PARAM_FLAG('h', "Show run time histogram percentiles", true);
+	PRINT_MODULE_USAGE_COMMAND("stop");
 }